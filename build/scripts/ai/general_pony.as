@@ -36,10 +36,8 @@ bool LootingTest(DynamicObject@ self_obj, Character@ user, Item@ item)
 
   if (self.GetHitPoints() > 0) // The character user is stealing from self
   {
-    Data user_stats      = user.GetStatistics();
-    Data self_stats      = self.GetStatistics();
-    int  steal_skill     = user_stats["Skills"]["Steal"].AsInt();
-    int  self_perception = self_stats["Special"]["PER"].AsInt();
+    int  steal_skill     = user.GetSkill("Steal");
+    int  self_perception = self.GetSpecial("PER");
     int  max_throw       = steal_skill - (10 + 3 * self_perception);
     int  throw           = Random() % 100;
 
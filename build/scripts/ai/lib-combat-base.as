@@ -22,19 +22,8 @@ bool       Fleeing(Character@ self)
 Character@ SelectTarget(Character@ self)
 {
   ia_debug("Civilian Select Target");
-  CharacterList         enemies  = self.GetNearbyEnemies();
-  int                   nEnemies = enemies.Size();
-  int                   it       = 0;
-  Character@            bestMatch;
+  Character@ bestMatch = @level.SelectTarget(self);
 
-  while (it < nEnemies)
-  {
-    Character@ current = enemies[it];
-
-    if (@bestMatch == null || current.GetHitPoints() < bestMatch.GetHitPoints())
-      @bestMatch = @current;
-    it++;
-  }
   if (@bestMatch != null)
   {
     ia_debug("-> Selected enemy: " + bestMatch.GetName());
@@ -49,7 +38,7 @@ Character@ SelectTarget(Character@ self)
 
 int get_available_ammo_for(Character@ self, Item@ item)
 {
-  Data ammo           = item.AsData()["ammo"];
+  Data ammo           = item.AsReadOnlyData()["ammo"];
   Data current_ammo   = ammo["current"];
   int  it             = 0;
   int  available_ammo = 0;
@@ -70,7 +59,7 @@ int get_available_ammo_for(Character@ self, Item@ item)
 
 bool is_weapon_loaded(Item@ item)
 {
-  Data ammo = item.AsData()["ammo"];
+  Data ammo = item.AsReadOnlyData()["ammo"];
   
   if (ammo["types"].NotNil())
   {
@@ -106,8 +95,8 @@ int    max_damage_action(Character@ self, Item@ item, string action_name)
   int  action_cost = item.GetActionPointCost(self, action_name);
   int  max_uses    = max_perform_action(self, item, action_cost);
 
-  Cout("Max uses: " + max_uses + ", ap cost: " + action_cost + " (available: " + self.GetActionPoints() + "), max damage: " + item.AsData()["actions"][action_name]["damage-max"].AsInt());
-  return (item.AsData()["actions"][action_name]["damage-max"].AsInt() * max_uses);
+  Cout("Max uses: " + max_uses + ", ap cost: " + action_cost + " (available: " + self.GetActionPoints() + "), max damage: " + item.AsReadOnlyData()["actions"][action_name]["damage-max"].AsInt());
+  return (item.AsReadOnlyData()["actions"][action_name]["damage-max"].AsInt() * max_uses);
 }
 
 bool   is_in_range(Character@ self, Character@ target, Data action)
@@ -120,7 +109,7 @@ bool   is_in_range(Character@ self, Character@ target, Data action)
 
 string get_best_offensive_action(Character@ self, Character@ target, Item@ item)
 {
-  Data   item_data              = item.AsData();
+  Data   item_data              = item.AsReadOnlyData();
   Data   actions                = item_data["actions"];
   int    action_iterator        = 0;
   int    action_points          = self.GetActionPoints();
@@ -166,7 +155,7 @@ bool is_action_better_than_action(Character@ self, Character@ target, Item@ item
 
 int item_get_ammo_amount(Item@ item)
 {
-  Data data = item.AsData();
+  Data data = item.AsReadOnlyData();
 
   if (data["ammo"]["amount"].Nil())
     return (0);
@@ -175,7 +164,7 @@ int item_get_ammo_amount(Item@ item)
 
 bool item_has_ammo(Inventory@ inventory, Item@ item)
 {
-  Data         item_data  = item.AsData();
+  Data         item_data  = item.AsReadOnlyData();
   Data         ammo_types = item_data["ammo"]["types"];
 
   if (ammo_types.Count() == 0)
@@ -243,8 +232,8 @@ Item@ select_most_suitable_weapon(Character@ self, Character@ target)
 {
   Item@ equiped_left    = self.GetInventory().GetEquipedItem("equiped", 0);
   Item@ equiped_right   = self.GetInventory().GetEquipedItem("equiped", 1);
-  Data  data_item_left  = equiped_left.AsData();
-  Data  data_item_right = equiped_right.AsData();
+  Data  data_item_left  = equiped_left.AsReadOnlyData();
+  Data  data_item_right = equiped_right.AsReadOnlyData();
   Item@ best_choice;
 
   string best_action_left  = "";
@@ -151,14 +151,16 @@ void AddToStatModifier(Data sheet, string statistic, int value)
 // This must contains all the modifications to derived statistics and skills from SPECIAL and Traits changes
 void UpdateAllValues(Data sheet)
 {
-  int level        = sheet["Variables"]["Level"].Nil() ? 1 : sheet["Variables"]["Level"].AsInt();
-  int strength     = sheet["Special"]["STR"].AsInt();
-  int perception   = sheet["Special"]["PER"].AsInt();
-  int endurance    = sheet["Special"]["END"].AsInt();
-  int charisma     = sheet["Special"]["CHA"].AsInt();
-  int intelligence = sheet["Special"]["INT"].AsInt();
-  int agility      = sheet["Special"]["AGI"].AsInt();
-  int luck         = sheet["Special"]["LUC"].AsInt();
+  Data special       = sheet["Special"];
+  Data level_value   = sheet["Variables"]["Level"];
+  int  level         = level_value.Nil() ? 1 : level_value.AsInt();
+  int  strength      = special["STR"].AsInt();
+  int  perception    = special["PER"].AsInt();
+  int  endurance     = special["END"].AsInt();
+  int  charisma      = special["CHA"].AsInt();
+  int  intelligence  = special["INT"].AsInt();
+  int  agility       = special["AGI"].AsInt();
+  int  luck          = special["LUC"].AsInt();
 
   Data derivedStatistics = sheet["Statistics"];
   Data skills            = sheet["Skills"];
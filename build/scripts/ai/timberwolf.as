@@ -91,8 +91,8 @@ void combat(Character@ self)
       int   actionPointsCost;
       Item@ equiped1 = self.GetEquipedItem(0);
       Item@ equiped2 = self.GetEquipedItem(1);
-      Data  data1    = equiped1.AsData();
-      Data  data2    = equiped2.AsData();
+      Data  data1    = equiped1.AsReadOnlyData();
+      Data  data2    = equiped2.AsReadOnlyData();
       bool  suitable1,  suitable2;
       int   distance = currentTarget.GetDistance(self.AsObject());
 
@@ -119,7 +119,7 @@ void combat(Character@ self)
             // If there's an action to compare this one to
             if (bestAction >= 0)
             {
-              Data dataBestAction   = bestEquipedItem.AsData()["actions"][bestAction];
+              Data dataBestAction   = bestEquipedItem.AsReadOnlyData()["actions"][bestAction];
               int  bestActionNShots = dataBestAction["ap-cost"].AsInt() / actionPoints;
               int  curActionNShots  = action["ap-cost"].AsInt()         / actionPoints;
 
@@ -139,7 +139,7 @@ void combat(Character@ self)
       if (@bestEquipedItem != null)
       {
         Cout("Taking action");
-        actionPointsCost = bestEquipedItem.AsData()["actions"][bestAction]["ap-cost"].AsInt();
+        actionPointsCost = bestEquipedItem.AsReadOnlyData()["actions"][bestAction]["ap-cost"].AsInt();
         if (actionPoints >= actionPointsCost)
           level.ActionUseWeaponOn(self, currentTarget, bestEquipedItem, bestAction);
         else
@@ -7,7 +7,7 @@ bool DrinkPotion(Item@ item, Character@ user)
 
 bool GivePotion(Item@ item, Character@ user, Character@ target)
 {
-  Data   item_data      = item.AsData();
+  Data   item_data      = item.AsReadOnlyData();
   Data   action         = item_data["actions"]["Use on"];
   Data   statistics     = user.GetStatistics();
   string skill          = action["Skill"].AsString();
@@ -20,20 +20,13 @@ bool UseKeyOnDoor(Item@ item, Character@ user, Door@ door)
 
 int get_statistic(Character@ user, string key)
 {
-  Data user_stats         = user.GetStatistics();
-  Data statistic_variable = user_stats["Variables"][key];
-  
-  if (statistic_variable.Nil())
-    statistic_variable = user_stats["Statistics"][key];
-  return (statistic_variable.Nil() ? 0 : statistic_variable.AsInt());
+  return (user.GetStatistic(key));
 }
 
 int UnarmedSuccessChance(Item@ item, Character@ user, Character@ target)
 {
-  Data  user_stats   = user.GetStatistics();
-  Data  target_stats = target.GetStatistics();
-  int   perception   = user_stats["Special"]["PER"].AsInt();
-  int   skill        = user_stats["Skills"]["Unarmed"].AsInt();
+  int   perception   = user.GetSpecial("PER");
+  int   skill        = user.GetSkill("Unarmed");
   int   armor_class  = get_statistic(user, "Armor Class");
   float distance     = user.GetDistance(target.AsObject());
   int   hit_chances;
@@ -48,7 +41,7 @@ int UnarmedSuccessChance(Item@ item, Character@ user, Character@ target)
 
 int ShootSuccessChance(Item@ item, Character@ user, Character@ target)
 {
-  Data   item_data   = item.AsData();
+  Data   item_data   = item.AsReadOnlyData();
   Data   action      = item_data["actions"]["Shoot"];
   float  range       = action["range"].AsFloat();
   float  distance    = user.GetDistance(target.AsObject());
@@ -126,7 +119,7 @@ float ComputeDamageResistance(Item@ item, string action_name, Character@ target,
 
   if (@item != null)
   {
-    Data damage_type_data = item.AsData()["actions"][action_name]["damage-type"];
+    Data damage_type_data = item.AsReadOnlyData()["actions"][action_name]["damage-type"];
 
     if (damage_type_data.NotNil())
       damage_type = damage_type_data.AsString();
@@ -193,7 +186,7 @@ float ComputeDamage(Item@ item, string action, Character@ user, Character@ targe
 int DamageCalculation(Item@ item, string action_name, Character@ user, Character@ target, int critical_roll)
 {
   Data   statistics          = user.GetStatistics();
-  Data   item_data           = item.AsData();
+  Data   item_data           = item.AsReadOnlyData();
   Data   action              = item_data["actions"][action_name];
   int    min_damage          = action["damage"].AsInt();
   int    max_damage          = action["damage-max"].AsInt();
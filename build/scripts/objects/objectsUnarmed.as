@@ -2,7 +2,7 @@
 
 bool ProcessAttack(Item@ item, string action, string hit_sound, Character@ user, Character@ target)
 {
-  Data   item_data     = item.AsData();
+  Data   item_data     = item.AsReadOnlyData();
   Data   action_data   = item_data["actions"][action];
   string message;
   bool   success       = false;
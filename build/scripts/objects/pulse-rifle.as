@@ -24,7 +24,7 @@ int PulseRifleSuccessChance(Item@ item, Character@ user, Character@ target)
 void SetEquiped(Item@ item, Character@ user, string slot, int mode, string joint, bool set_equiped)
 {
   Cout("SetEquiped " + slot + " shotgun" + mode);
-  Data data = item.AsData();
+  Data data = item.AsReadOnlyData();
 
   if (slot == "equiped")
   {
@@ -72,7 +72,7 @@ bool PulseRifleShoot(Item@ item, Character@ user, Character@ target)
 
 bool CanUse(Item@ item, Character@ user, DynamicObject@ target)
 {
-  Data item_data = item.AsData();
+  Data item_data = item.AsReadOnlyData();
 
   if (GetAmmoAmount(item_data) < 1)
   {
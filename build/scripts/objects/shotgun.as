@@ -22,7 +22,7 @@ bool CanWeild(Item@ item, Character@ user, string slot, int mode)
 void SetEquiped(Item@ item, Character@ user, string slot, int mode, string joint, bool set_equiped)
 {
   Cout("SetEquiped " + slot + " shotgun" + mode);
-  Data data = item.AsData();
+  Data data = item.AsReadOnlyData();
 
   if (slot == "equiped")
   {
@@ -51,7 +51,7 @@ bool ShotgunShoot(Item@ item, Character@ user, Character@ target)
 
 bool CanUse(Item@ item, Character@ user, DynamicObject@ target)
 {
-  Data item_data = item.AsData();
+  Data item_data = item.AsReadOnlyData();
 
   if (GetAmmoAmount(item_data) < 1)
   {
@@ -172,6 +172,7 @@ void DialogObject::Apply()
         LVecBase3 hpr   = object->nodePath.get_hpr();
         LVecBase3 scale = object->nodePath.get_scale();
 
+        world->UnregisterDynamicObject(*object);
         object->nodePath.remove_node();
         object->nodePath = world->window->load_model(world->window->get_panda_framework()->get_models(), MODEL_ROOT + model_path);
         object->nodePath.set_name(name);
@@ -180,6 +181,7 @@ void DialogObject::Apply()
         object->nodePath.set_scale(scale);
         object->nodePath.set_collide_mask(CollideMask(ColMask::DynObject));
         object->nodePath.reparent_to(world->rootDynamicObjects);
+        world->RegisterDynamicObject(*object);
         world->DynamicObjectSetWaypoint(*object, *object->waypoint);
     }
     if (object->strTexture != ui->texture->text().toStdString())
@@ -716,13 +716,12 @@ void WorldObjectWidget::UpdateName(QString name)
       MapObject* object = selection.object;
 
       RenameObject(QString::fromStdString(object->name), name);
-      object->name = name.toStdString();
-      object->nodePath.set_name(object->name);
+      world->RenameObject(object, name.toStdString());
     }
     else if (selection_type == 3)
     {
       RenameObject(QString::fromStdString(selection.light->name), name);
-      selection.light->name = name.toStdString();
+      world->RenameLight(selection.light, name.toStdString());
     }
     else if (selection_type == 4)
     {
@@ -1149,6 +1148,7 @@ void WorldObjectWidget::PasteObject(Utils::Packet& packet)
   object.name = name.toStdString();
   object.nodePath.set_name(object.name);
   world->objects.push_back(object);
+  world->RegisterMapObject(*world->objects.rbegin());
 }
 
 void WorldObjectWidget::PasteDynamicObject(Utils::Packet& packet)
@@ -1162,6 +1162,7 @@ void WorldObjectWidget::PasteDynamicObject(Utils::Packet& packet)
   object.name = name.toStdString();
   object.nodePath.set_name(object.name);
   world->dynamicObjects.push_back(object);
+  world->RegisterDynamicObject(*world->dynamicObjects.rbegin());
 }
 
 void WorldObjectWidget::PasteWorldLight(Utils::Packet& packet)
@@ -1174,6 +1175,7 @@ void WorldObjectWidget::PasteWorldLight(Utils::Packet& packet)
   clipboard_name_map.insert(object.name.c_str(), name);
   object.name = name.toStdString();
   world->lights.push_back(object);
+  world->RegisterLight(*world->lights.rbegin());
 }
 
 void WorldObjectWidget::PasteParticleEffect(Utils::Packet& packet)
@@ -0,0 +1,75 @@
+#ifndef  BACKGROUND_SAVE_HPP
+# define BACKGROUND_SAVE_HPP
+
+# include "globals.hpp"
+# include "thread.hpp"
+# include "serializer.hpp"
+# include "datatree.hpp"
+# include <panda3d/texture.h>
+# include <atomic>
+# include <string>
+# include <list>
+
+/*
+ * Two-phase save: the game state is copied into buffers owned by the BackgroundSave on the main thread,
+ * then JSON encoding, compression and file writing happen on a separate thread.
+ * The screenshot is encoded on the main thread, as Panda's textures belong to it: the thread only writes the PNG bytes.
+ * Every file is written next to its destination then renamed over it, so that an interrupted save
+ * leaves the previous files intact. The slot archive is the exception when saving over the slot the game
+ * was loaded from: the files which changed are appended to it (see Utils::DirectoryCompressor::Update).
+ */
+class BackgroundSave : public Sync::MyThread
+{
+  struct Blob
+  {
+    std::string path;
+    std::string data;
+  };
+
+  struct Json
+  {
+    std::string path;
+    DataTree*   tree;
+  };
+
+public:
+  BackgroundSave(void);
+  ~BackgroundSave(void);
+
+  void               AddBlob(const std::string& path, Utils::Packet& packet);
+  void               AddBlob(const std::string& path, const std::string& data);
+  void               AddJson(const std::string& path, Data data);
+  void               AddScreenshot(const std::string& path, PT(Texture) screenshot);
+  void               SetSlot(const std::string& slot_path, const std::string& directory, const std::string& previous_archive, Data metadata);
+
+  void               Start(void);
+  void               Wait(void);
+  bool               IsDone(void)      const { return (done.load());                                }
+  float              GetProgress(void) const { return (steps ? (float)steps_done.load() / steps : 1.f); }
+  bool               Succeeded(void)   const { return (error == "");                                }
+  const std::string& GetError(void)    const { return (error);                                      }
+  const std::string& GetSlotPath(void) const { return (slot_path);                                  }
+
+protected:
+  void               Run(void);
+
+private:
+  void               WriteBlob(const Blob&);
+  void               WriteJson(const Json&);
+  void               WriteSlot(void);
+  static void        ReplaceFile(const std::string& temporary, const std::string& path);
+
+  std::list<Blob>   blobs;
+  std::list<Json>   jsons;
+  std::string       screenshot_path;
+  std::string       slot_path, slot_directory, previous_archive;
+  DataTree*         slot_metadata;
+
+  unsigned int      steps;
+  std::atomic<int>  steps_done;
+  std::atomic<bool> done;
+  bool              started, joined;
+  std::string       error;
+};
+
+#endif
@@ -3,6 +3,7 @@
 
 # include "globals.hpp"
 # include "datatree.hpp"
+# include "data_path.hpp"
 # include "scriptengine.hpp"
 # include "as_object.hpp"
 # include <string>
@@ -75,10 +76,10 @@ public:
   void           SetCurrentHp(short hp);
   void           SetArmorClass(unsigned short ac)   { _statsheet["Variables"]["Armor Class"]   = ac;    }
   void           SetActionPoints(unsigned short ap) { _statsheet["Variables"]["Action Points"] = ap;    }
-  short          GetCurrentHp(void)      const      { return (_statsheet["Variables"]["Hit Points"].Or(GetMaxHp()));            }
-  short          GetMaxHp(void)          const      { return (_statsheet["Statistics"]["Hit Points"].Or(1));                    }
-  unsigned short GetArmorClass(void)     const      { return (_statsheet["Variables"]["Armor Class"].Or(GetBaseArmorClass()));  }
-  unsigned short GetBaseArmorClass(void) const      { return (_statsheet["Statistics"]["Armor Class"].Or(1));                   }
+  short          GetCurrentHp(void)      const      { return (_paths.current_hp.From(_statsheet).Or(GetMaxHp()));                }
+  short          GetMaxHp(void)          const      { return (_paths.max_hp.From(_statsheet).Or(1));                             }
+  unsigned short GetArmorClass(void)     const      { return (_paths.armor_class.From(_statsheet).Or(GetBaseArmorClass()));      }
+  unsigned short GetBaseArmorClass(void) const      { return (_paths.base_armor_class.From(_statsheet).Or(1));                   }
 
   int            GetReputation(const std::string& faction) const;
   void           AddReputation(const std::string& faction, int amount);
@@ -95,8 +96,18 @@ public:
 private:
   std::vector<std::string> GetStatKeys(Data stats) const;
 
+  // Values read every time a character is checked or its statistics are updated
+  struct Paths
+  {
+    Paths(void) : current_hp("Variables/Hit Points"), max_hp("Statistics/Hit Points"), armor_class("Variables/Armor Class"),
+                  base_armor_class("Statistics/Armor Class"), level("Variables/Level"), special("Special"), skills("Skills") {}
+
+    DataPath current_hp, max_hp, armor_class, base_armor_class, level, special, skills;
+  };
+
   Data               _statsheet;
   Data               _statsheet_backup;
+  mutable Paths      _paths;
 };
 
 #endif
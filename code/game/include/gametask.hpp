@@ -13,11 +13,13 @@
 # include "encounter.hpp"
 
 class QuestManager;
+class BackgroundSave;
 
 class GameTask
 {
   struct LoadLevelParams
   { LoadLevelParams() {} std::string name; std::string path; bool isSaveFile; std::string entry_zone; };
+  friend class LevelBenchmark;
 public:
   static GameTask* CurrentGameTask;
   GameTask(WindowFramework* window, GeneralUi&);
@@ -25,7 +27,8 @@ public:
   
   AsyncTask::DoneStatus do_task(void);
   bool                  LoadGame(void);  
-  bool                  SaveGame(void);
+  bool                  SaveGame(const std::string& slot_path = "");
+  bool                  IsSaving(void) const { return (background_save != 0); }
   void                  OpenLevel(const std::string& level, const std::string& entry_zone = "");
   void                  ExitLevel(void);
 
@@ -48,6 +51,8 @@ public:
 
   ISampleInstance*      PlaySound(const std::string&);
 
+  Sync::Signal<void (float)> SaveProgress;
+
 private:
   void                  RemoveCurrentProgression(void);
   void                  LoadClicked(Rocket::Core::Event&);
@@ -67,7 +72,9 @@ private:
   void                  SetPlayerInventory(void);
 
   void                  EraseSlot(unsigned char slot);
-  bool                  CompressSave(const std::string& output_path);
+  void                  FinishSave(void);
+  void                  WaitForSave(void);
+  void                  ExtractLevelFromSlot(const std::string& level_name);
   
   void                  SetupLoadingScreen(void);
   void                  RemoveLoadingScreen(void);
@@ -76,6 +83,7 @@ private:
   bool                  _continue;
   WindowFramework*      window;
   std::string           save_path;
+  std::string           slot_archive;
   SoundManager          sound_manager;
   GameUi                game_ui;
   DataEngine            data_engine;
@@ -86,6 +94,7 @@ private:
   StatController*       player_stats;
   QuestManager*         quest_manager;
   LoadingScreen*        loading_screen;
+  BackgroundSave*       background_save;
 
   WorldMap*             world_map;
   Level*                level;
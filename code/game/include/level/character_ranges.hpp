@@ -0,0 +1,41 @@
+#ifndef  LEVEL_CHARACTER_RANGES_HPP
+# define LEVEL_CHARACTER_RANGES_HPP
+
+# include <vector>
+
+class ObjectCharacter;
+
+/*
+ * Characters within the field of view radius of each character, gathered once per frame.
+ * The main thread reads the positions and radiuses from the scene graph and the statistics (Add),
+ * then the distances are compared by any thread (Compute): the result is only made from the entries.
+ * Fields of view read it during the rest of the frame. It is invalidated when a character is inserted
+ * or removed, in which case they fall back to checking the level's characters themselves.
+ */
+class CharacterRanges
+{
+public:
+  typedef std::vector<ObjectCharacter*> CharacterList;
+
+  CharacterRanges(void) : computed(false) {}
+
+  void         Clear(void)      { entries.clear(); computed = false; }
+  void         Invalidate(void) { computed = false; }
+  void         Add(ObjectCharacter* character, float x, float y, float radius);
+  void         Compute(void);
+  bool         Get(const ObjectCharacter* character, CharacterList& list) const;
+
+private:
+  struct Entry
+  {
+    ObjectCharacter* character; // Never dereferenced
+    float            x, y;
+    float            radius;
+    CharacterList    in_range;
+  };
+
+  std::vector<Entry> entries;
+  bool               computed;
+};
+
+#endif
@@ -3,6 +3,7 @@
 
 # include "globals.hpp"
 # include "scheduled_task.hpp"
+# include "observatory.hpp"
 # define FLAG_CHARACTER_SNEAK 1
 # define FOV_TTL              5
 
@@ -27,6 +28,15 @@ class FieldOfView : public ScheduledTask
   };
 
 public:
+  /*
+   * Emitted when a character starts or stops being detected, whichever list it is in.
+   * Within a check, only the difference between the detections before and after the check is emitted.
+   */
+  Sync::Signal<void (ObjectCharacter*)> CharacterDetected;
+  Sync::Signal<void (ObjectCharacter*)> CharacterLost;
+  // Emitted when the list of detected enemies becomes empty, or stops being empty
+  Sync::Signal<void (bool)>             EnemiesInSightChanged;
+
   FieldOfView(Level& level, ObjectCharacter& character);
   ~FieldOfView(void);
   
@@ -34,6 +44,7 @@ public:
 
   bool                 IsDetected(const ObjectCharacter*) const;
   bool                 HasLivingEnemiesInSight(void) const;
+  bool                 HasEnemiesInSight(void) const { return (!(detected_enemies.empty())); }
   
   void                 SetEnemyDetected(ObjectCharacter& enemy);
   void                 SetCharacterDetected(ObjectCharacter& character);
@@ -52,6 +63,8 @@ protected:
 
   void                 LoseTrackOfCharacters(std::list<Entry>&);
   void                 DetectCharacters(void);
+  void                 EmitDetectionChanges(CharacterList previously_detected);
+  void                 SetDetectedInList(ObjectCharacter&, std::list<Entry>&);
   bool                 CheckIfEnemyIsDetected(const ObjectCharacter& enemy)                  const;
   bool                 CheckIfSneakingEnemyIsDetected(const ObjectCharacter& enemy)          const;
   void                 InsertOrUpdateCharacterInList(ObjectCharacter&, std::list<Entry>&);
@@ -2,10 +2,10 @@
 # define OBJECT_OUTLINE_HPP
 
 # include "globals.hpp"
+# include "observatory.hpp"
 # include <panda3d/lvector4.h>
 # include <panda3d/nodePath.h>
-# include <list>
-# include <vector>
+# include <map>
 
 class InstanceDynamicObject;
 class ObjectCharacter;
@@ -30,6 +30,10 @@ class TargetOutliner
   };
 
 public:
+  TargetOutliner() : subject(0), enabled(false)
+  {
+  }
+
   ~TargetOutliner()
   {
     DisableOutline();
@@ -40,10 +44,14 @@ public:
   void DisableOutline(void);
 
 private:
-  void MakeOutlinesForListWithColor(const std::vector<ObjectCharacter*>& targets, LVector4f color);
-
-  ObjectCharacter*   subject;
-  std::list<Outline> outlines;
+  void AddOutline(ObjectCharacter* target);
+  void RemoveOutline(ObjectCharacter* target);
+  void RemoveDeadOutlines(void);
+
+  ObjectCharacter*                    subject;
+  bool                                enabled;
+  std::map<ObjectCharacter*, Outline> outlines;
+  Sync::ObserverHandler               obs;
 };
 
 #endif
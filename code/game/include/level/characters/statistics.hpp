@@ -21,6 +21,11 @@ public:
   short              GetMaxHitPoints(void) const;
   short              GetHitPoints(void)    const;
   void               SetHitPoints(short hp);
+
+  // Typed reads of the statistic sheet, for scripts which would otherwise walk it with GetStatistics
+  int                GetSpecial(const std::string& stat)   const { return (controller->Model().GetSpecial(stat)); }
+  int                GetSkill(const std::string& stat)     const { return (controller->Model().GetSkill(stat));   }
+  int                GetStatistic(const std::string& stat) const;
   
   Metabolism*        GetMetabolism(void)   const { return (metabolism); }
   void               SetMetabolism(Metabolism*);
@@ -3,22 +3,52 @@
 
 # include "globals.hpp"
 # include "serializer.hpp"
+# include "observatory.hpp"
 # include <list>
+# include <vector>
 
 class Level;
 class ObjectCharacter;
 
+/*
+ * Turn-based combat.
+ * The characters of the level play in initiative order, starting with the character who started the combat.
+ * Each side keeps a count of its living combatants with enemies in sight, updated from the field of view and
+ * death events of the combatants: whether the combat can stop doesn't require looking at every character.
+ * The default combat behaviour of the scripts picks its targets with SelectTarget.
+ */
 class Combat
 {
+  enum Side
+  {
+    PlayerSide,
+    OtherSide
+  };
+
+  struct Combatant
+  {
+    ObjectCharacter* character; // null once the character has left the level
+    short            initiative;
+    Side             side;
+    bool             fighting;
+  };
+
 public:
-  Combat(Level& level, std::list<ObjectCharacter*>& characters) : level(level), characters(characters), iterator(characters.end())
-  {}
+  Combat(Level& level, std::list<ObjectCharacter*>& characters) : level(level), characters(characters), current(0)
+  {
+    fighting_count[PlayerSide] = fighting_count[OtherSide] = 0;
+  }
 
   void             Start(ObjectCharacter*);
   bool             CanStop(void) const;
   void             Stop(void);
   void             NextTurn(void);
   ObjectCharacter* GetCurrentCharacter(void) const;
+  ObjectCharacter* SelectTarget(ObjectCharacter* character) const;
+
+  void             AddCharacter(ObjectCharacter*);
+  void             RemoveCharacter(ObjectCharacter*);
+  void             Clear(void);
   
   void             Serialize(Utils::Packet&) const;
   void             Unserialize(Utils::Packet&);
@@ -32,9 +62,20 @@ private:
   void             InitializeLevelForFight(void);
   void             FinalizeFightForLevel(void);
 
-  Level&                                level;
-  std::list<ObjectCharacter*>&          characters;
-  std::list<ObjectCharacter*>::iterator iterator;
+  void             BuildQueue(void);
+  void             AddCombatant(ObjectCharacter* character);
+  void             WatchCombatant(unsigned int index);
+  void             SetFighting(unsigned int index, bool fighting);
+  unsigned int     FindCombatant(const ObjectCharacter* character) const;
+  unsigned int     NextCombatant(unsigned int index) const;
+  static short     GetInitiative(ObjectCharacter* character);
+
+  Level&                       level;
+  std::list<ObjectCharacter*>& characters;
+  std::vector<Combatant>       queue;
+  unsigned int                 current;
+  unsigned int                 fighting_count[2];
+  Sync::ObserverHandler        obs;
 };
 
 #endif
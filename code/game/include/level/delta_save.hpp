@@ -0,0 +1,75 @@
+#ifndef  DELTA_SAVE_HPP
+# define DELTA_SAVE_HPP
+
+# include "serializer.hpp"
+# include <string>
+# include <vector>
+# include <map>
+
+/*
+ * Persistent levels are saved as a full snapshot (the .blob, which still loads on its own) and a delta (.delta).
+ * The delta indexes where each record lies in the snapshot, and carries the records which changed since then.
+ * Loading splices both back into a complete packet: Level::Unserialize doesn't know about deltas.
+ * Records are found by object name.
+ */
+class DeltaSave
+{
+public:
+  enum RecordType
+  {
+    WorldRecord    = 0, // DynamicObject, in World::dynamicObjects order
+    InstanceRecord = 1  // InstanceDynamicObject, in Level order (objects, then characters)
+  };
+
+  static const unsigned int max_deltas = 8;
+
+  DeltaSave(void);
+
+  void        Clear(void);
+  bool        Load(const std::string& snapshot, const std::string& delta);
+  std::string Rebuild(const std::string& snapshot) const;
+
+  // Saving
+  bool        SetOrder(const std::vector<std::string>& world_order, const std::vector<std::string>& instance_order);
+  bool        NeedsSnapshot(void) const;
+  bool        MatchesSnapshot(const Utils::Packet& head, const Utils::Packet& tail) const;
+  void        BeginSnapshot(void);
+  bool        HasRecord(RecordType, const std::string& name) const;
+  void        SetRecord(RecordType, const std::string& name, const Utils::Packet& packet);
+  void        SetLevelState(const Utils::Packet& state, const Utils::Packet& combat);
+  std::string WriteSnapshot(const Utils::Packet& head, const Utils::Packet& tail);
+  std::string WriteDelta(void);
+
+private:
+  struct Range
+  {
+    Range(void) : offset(0), length(0), crc(0) {}
+
+    unsigned int offset, length, crc;
+  };
+
+  typedef std::pair<const char*, size_t>     Bytes;
+  typedef std::map<std::string, Range>       Index;
+  typedef std::map<std::string, std::string> Changes;
+
+  struct Layout
+  {
+    Range head, tail;
+    Index index[2];
+  };
+
+  static std::string Body(const Utils::Packet&);
+  Bytes              Find(const std::string& snapshot, RecordType, const std::string& name) const;
+  std::string        Assemble(Bytes head, Bytes tail, const std::string& snapshot, Layout* layout) const;
+  size_t             ChangesSize(void) const;
+
+  bool                     has_snapshot;
+  unsigned int             snapshot_size, snapshot_crc;
+  Layout                   layout;
+  Changes                  changes[2];
+  std::vector<std::string> order[2];
+  std::string              state, combat;
+  unsigned int             deltas_written;
+};
+
+#endif
@@ -2,44 +2,51 @@
 # define DIPLOMACY_HPP
 
 # include <string>
+# include <deque>
+# include <map>
 # include "dataengine.hpp"
-
+# include "dynamic_bitset.hpp"
+
+/*
+ * Factions are identified by their index in DataEngine["Factions"].
+ * The hostility relations form a square bit matrix: the row of a faction has the bit of each of its
+ * enemies set, so that a relation is a single bit test. The relations are also written in
+ * DataEngine["Factions"], which is saved with the game.
+ */
 class WorldDiplomacy
 {
 public:
+  typedef DynamicBitset FactionSet;
+
   struct Faction
   {
     std::string  name;
-    unsigned int flag;
-    unsigned int enemyMask;
-
-    bool operator==(const std::string& name)
-    { return (this->name == name); }
+    unsigned int id;
+    FactionSet   enemies;
 
-    bool operator==(unsigned int flag)
-    { return (this->flag == flag); }
+    bool IsEnemy(unsigned int faction) const { return (enemies.Test(faction)); }
   };
 
-  typedef std::list<Faction> Factions;
+  typedef std::deque<Faction> Factions; // Characters keep pointers to their faction: it must not move
 
   WorldDiplomacy(DataEngine&);
   ~WorldDiplomacy(void);
 
-  void     AddFaction(const std::string& name);
-  Faction* GetFaction(const std::string& name);
-  Faction* GetFaction(unsigned int flag);
+  void         AddFaction(const std::string& name);
+  Faction*     GetFaction(const std::string& name);
+  Faction*     GetFaction(unsigned int id);
 
-  void     SetAsEnemy(bool set, const std::string& name1, const std::string& name2);
-  void     SetAsEnemy(bool set, unsigned int flag1, unsigned int flag2);
+  void         SetAsEnemy(bool set, const std::string& name1, const std::string& name2);
+  void         SetAsEnemy(bool set, unsigned int id1, unsigned int id2);
 
-  void     Initialize(void);
+  void         Initialize(void);
 
 private:
-  void     SetAsEnemy(bool set, Faction& first, Faction& second);
+  void         SetAsEnemy(bool set, Faction& first, Faction& second);
 
-  DataEngine&  _data_engine;
-  Factions     _factions;
-  unsigned int _next_flag;
+  DataEngine&                         _data_engine;
+  Factions                            _factions;
+  std::map<std::string, unsigned int> _faction_ids;
 };
 
 #endif
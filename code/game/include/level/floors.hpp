@@ -24,12 +24,14 @@ class Floors
     void        SetNodePath(NodePath np);
     void        SetFadingIn(bool set);
     void        Run(float elapsedTime);
+    void        Apply(void);
   };
 
 public:
   Floors(Level& level) : level(level), current_floor(0), last_waypoint(0) {}
 
-  void          RunFadingEffect(float elapsed_time);
+  void          ComputeFadingEffect(float elapsed_time);
+  void          ApplyFadingEffect(void);
   void          SetCurrentFloorFromObject(InstanceDynamicObject*);
   void          SetCurrentFloor(unsigned char floor);
   void          ShowOnlyFloor(unsigned char floor);
@@ -0,0 +1,61 @@
+#ifndef  FRAME_PHASES_HPP
+# define FRAME_PHASES_HPP
+
+# include "job_system.hpp"
+# include <string>
+# include <vector>
+# include <functional>
+
+/*
+ * Per-frame phase graph.
+ * A phase may only depend on phases added before it: phases are grouped in steps, each step starting
+ * once every phase of the previous step is done. Within a step, MainThread phases run on the calling
+ * thread in the order they were added, while AnyThread phases are handed to the job system.
+ * AnyThread phases of a same step must not touch the same data.
+ */
+class FramePhases
+{
+public:
+  enum Affinity
+  {
+    MainThread,
+    AnyThread
+  };
+
+  typedef std::function<void (float)> Callback;
+
+  FramePhases(Sync::JobSystem& jobs = Sync::JobSystem::Get()) : jobs(jobs), parallel(true) {}
+
+  void         Add(const std::string& name, Affinity affinity, Callback callback, const std::vector<std::string>& dependencies = std::vector<std::string>());
+  void         Run(float elapsed_time);
+  void         SetParallel(bool set)  { parallel = set;    }
+  bool         IsParallel(void) const { return (parallel); }
+
+  // Seconds spent in each phase during the last Run, in the order the phases were added
+  unsigned int       Count(void)                     const { return (phases.size());           }
+  const std::string& GetName(unsigned int phase)     const { return (phases[phase].name);      }
+  double             GetDuration(unsigned int phase) const { return (phases[phase].duration);  }
+
+private:
+  struct Phase
+  {
+    std::string  name;
+    Affinity     affinity;
+    Callback     callback;
+    unsigned int step;
+    double       duration;
+    const char*  zone;
+  };
+
+  static void       RunPhase(Phase& phase, float elapsed_time);
+
+  typedef std::vector<Phase>        Phases;
+  typedef std::vector<unsigned int> Step;
+
+  Sync::JobSystem&  jobs;
+  Phases            phases;
+  std::vector<Step> steps;
+  bool              parallel;
+};
+
+#endif
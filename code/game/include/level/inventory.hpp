@@ -6,6 +6,8 @@
 # include "world/world.h"
 # include "animatedobject.hpp"
 # include "as_object.hpp"
+# include "level/item_template.hpp"
+# include <unordered_map>
 
 class ObjectCharacter;
 class InstanceDynamicObject;
@@ -33,8 +35,11 @@ public:
   };
 
   InventoryObject(Data);
+  InventoryObject(ItemTemplate*);
   ~InventoryObject();
 
+  static InventoryObject* FromJSON(const std::string& name, const std::string& json);
+
   int               HitSuccessRate(ObjectCharacter* user, ObjectCharacter* target, unsigned char use_type);
   unsigned short    GetActionPointCost(ObjectCharacter* user, unsigned char use_type);
   bool              UseAsWeapon(ObjectCharacter* user, ObjectCharacter* target, unsigned char use_type);
@@ -55,24 +60,21 @@ public:
   bool              IsWeapon(void)  const;
 
   void              ResetFromFixture(void);
+  void              MakeUnique(void);
+  bool              IsUnique(void) const { return (_data == &_dataTree); }
 
 private:
   template<class C>
   bool              ExecuteHook(const std::string& hook, ObjectCharacter* user, C* target, unsigned char actionIt);
   
-  DataTree           _dataTree;
-  
-  bool               _equiped;
-
-  asIScriptContext*  _script_context;
-  asIScriptModule*   _script_module;
-  
-  typedef std::vector<AngelScript::Object> ActionsHooks;
+  void              Bind(DataBranch*);
 
-  AngelScript::Object _object;  
-  ActionsHooks        _actionHooks;
+  // Instances share the definition of their template until MakeUnique copies it in _dataTree
+  DataTree           _dataTree;
+  ItemTemplate*      _template;
+  ItemTemplate*      _own_template;
 
-  asIScriptFunction* _hookCanWeild, *_hookSetEquiped;
+  bool               _equiped;
 };
 
 class Inventory
@@ -80,6 +82,23 @@ class Inventory
 public:
   typedef Script::StdList<InventoryObject*> Content;
 
+  /*
+   * Items of the same type, in the order they appear in the content.
+   * Kept up to date by AddObject and DelObject.
+   */
+  struct Stack
+  {
+    Stack(void) : weight(0) {}
+
+    unsigned short   Count(void) const { return (items.size());   }
+    InventoryObject* Front(void) const { return (*items.front()); }
+
+    std::vector<Content::iterator> items;
+    unsigned int                   weight;
+  };
+
+  typedef std::unordered_map<std::string, Stack> Stacks;
+
   struct Slot
   {
     Slot(void) : empty(true), mode(0), object(0) {}
@@ -135,6 +154,8 @@ public:
   Content&           GetContent(void)       { return (_content); }
   InventoryObject*   GetObject(const std::string& name);
   unsigned short     ContainsHowMany(const std::string& name) const;
+  const Stack*       GetStack(const std::string& name) const;
+  const Stacks&      GetStacks(void) const { return (_stacks); }
 
   int                GetObjectIterator(InventoryObject* object) const;
 
@@ -169,7 +190,11 @@ public:
   Sync::Signal<void (InventoryObject*)> EquipedItem;
 
 private:
+  void               ClearContent(void);
+  void               UpdateWeights(void);
+
   Content                    _content;
+  Stacks                     _stacks;
   unsigned short             _currentWeight;
   unsigned short             _capacity;
   mutable std::vector<Slots> _slots;
@@ -0,0 +1,47 @@
+#ifndef  ITEM_TEMPLATE_HPP
+# define ITEM_TEMPLATE_HPP
+
+# include "datatree.hpp"
+# include "as_object.hpp"
+# include <vector>
+# include <map>
+
+/*
+ * What every InventoryObject of the same type shares: the item definition (data/objects.json with the
+ * default values filled in), the script module and context, and the resolved action hooks.
+ * Templates of the items from the item index are loaded once and kept until the GameTask ends.
+ * InventoryObjects read the definition of their template until something needs to write in them
+ * (see InventoryObject::MakeUnique).
+ */
+class ItemTemplate
+{
+public:
+  typedef std::vector<AngelScript::Object> ActionsHooks;
+
+  ItemTemplate(Data source_definition);
+
+  static ItemTemplate* Require(const std::string& name);
+  static void          Clear(void);
+  static void          MakeDefinition(Data source, Data definition);
+
+  Data                 GetDefinition(void)       { return (Data(&definition)); }
+  DataTree*            GetDefinitionTree(void)   { return (&definition);       }
+  const std::string&   GetJSON(void)       const { return (json);              }
+  AngelScript::Object& GetScript(void)           { return (script);            }
+  ActionsHooks&        GetActionHooks(void)      { return (action_hooks);      }
+
+  bool                 Matches(Data source);
+  bool                 HasSameScript(Data definition);
+
+private:
+  ItemTemplate(const ItemTemplate&);
+
+  DataTree             definition;
+  std::string          json;
+  AngelScript::Object  script;
+  ActionsHooks         action_hooks;
+
+  static std::map<std::string, ItemTemplate*> templates;
+};
+
+#endif
@@ -49,8 +49,12 @@
 # include "level/interactions.hpp"
 # include "level/combat.hpp"
 # include "level/player.hpp"
+# include "level/frame_phases.hpp"
+# include "level/character_ranges.hpp"
+# include "level/delta_save.hpp"
 
 # include <functional>
+# include <unordered_map>
 
 class Level
 {
@@ -76,6 +80,8 @@ public:
   void                    SetPlayerInventory(Inventory*);
   void                    Serialize(Utils::Packet&);
   void                    Unserialize(Utils::Packet&);
+  bool                    Save(std::string& snapshot, std::string& delta);
+  DeltaSave&              GetDeltaSave(void)              { return (delta_save); }
   
   void                    SetAsPlayerParty(Party& party);
   void                    InsertParty(Party& party, const std::string& entry_zone);
@@ -97,6 +103,7 @@ public:
   };
 
   AsyncTask::DoneStatus   do_task(void);
+  AsyncTask::DoneStatus   do_task(float elapsed_time);
   void                    SetPersistent(bool set)  { is_persistent = set;    }
   bool                    IsPersistent(void) const { return (is_persistent); }
   void                    SetState(State);
@@ -111,6 +118,8 @@ public:
   MouseEvents&           GetMouse(void)          { return (mouse); }
   Floors&                GetFloors(void)         { return (floors); }
   TargetOutliner&        GetTargetOutliner(void) { return (target_outliner); }
+  FramePhases&           GetFramePhases(void)    { return (frame_phases); }
+  const CharacterRanges& GetCharacterRanges(void) const { return (character_ranges); }
   VisibilityHalo&        GetPlayerHalo(void)     { return (player_halo);     }
   Zones::Manager&        GetZoneManager(void)    { return (zones); }
   LevelCamera&           GetCamera(void)         { return (camera); }
@@ -160,6 +169,11 @@ public:
   
   Sync::ObserverHandler obs;
 private:
+  void               InitializeFramePhases(void);
+  void               RegisterObject(InstanceDynamicObject*);
+  void               UnregisterObject(InstanceDynamicObject*);
+  void               RegisterCharacter(ObjectCharacter*);
+  void               UnregisterCharacter(ObjectCharacter*);
   void               BackupInventoriesToDynamicObjects(void);
   void               SerializeParties(Utils::Packet&);
   void               UnserializeParties(Utils::Packet&);
@@ -167,6 +181,9 @@ private:
   typedef std::list<InstanceDynamicObject*> InstanceObjects;
   typedef std::list<ObjectCharacter*>       Characters;
   typedef std::list<Party*>                 Parties;
+  typedef std::unordered_map<const DynamicObject*, InstanceDynamicObject*> InstancesByObject;
+  typedef std::unordered_map<std::string, InstanceDynamicObject*>          ObjectsByName;
+  typedef std::unordered_map<std::string, ObjectCharacter*>                CharactersByName;
   
   std::string           level_name;
   WindowFramework*      window;
@@ -188,6 +205,9 @@ private:
   Projectile::Set       projectiles;
   InstanceObjects       objects;
   Characters            characters;
+  InstancesByObject     instances_by_object;
+  ObjectsByName         objects_by_name;
+  CharactersByName      characters_by_name;
   Parties               parties;
   Combat                combat;
   VisibilityHalo        player_halo;
@@ -198,6 +218,9 @@ private:
   Zones::Manager        zones;
   EquipModes            equip_modes;
   Exit                  exit;
+  FramePhases           frame_phases;
+  CharacterRanges       character_ranges;
+  DeltaSave             delta_save;
 };
 
 #endif
@@ -59,6 +59,7 @@ public:
   void                      SetMouseState(char);
   
   void                      ClosestWaypoint(World*, short currentFloor);
+  void                      SetPickingRoot(NodePath root) { _pickingRoot = root; }
 
   Sync::Signal<void>        ButtonLeft;
   Sync::Signal<void>        ButtonMiddle;
@@ -92,15 +93,26 @@ public:
   }
 
 private:
+  bool                      Pick(void);
+  void                      ResolveWaypoint(World*);
+
   WindowFramework*          _window;
   NodePath                  _camera;
-  LPoint2f                  _lastMousePos;
   PT(MouseWatcher)          _mouseWatcher;
   PT(CollisionRay)          _pickerRay;
   PT(CollisionNode)         _pickerNode;
   NodePath                  _pickerPath;
   CollisionTraverser        _collisionTraverser;
   PT(CollisionHandlerQueue) _collisionHandlerQueue;
+  CollisionTraverser        _modelTraverser;
+  PT(CollisionHandlerQueue) _modelHandlerQueue;
+
+  // The last picking results stay valid until the cursor, the camera or the picking root change
+  NodePath                  _pickingRoot;
+  NodePath                  _lastPickingRoot;
+  LPoint2f                  _lastMousePos;
+  LMatrix4f                 _lastCameraMat;
+  bool                      _waypointResolved;
   
   MouseHovering             _hovering;
 };
@@ -44,7 +44,7 @@ public:
   Inventory&               GetInventory(void)         { return (*_inventory);           }
   const Inventory&         GetInventory(void) const   { return (*_inventory); }
   const std::string        GetFactionName(void) const { return (_faction ? _faction->name : ""); }
-  unsigned int             GetFaction(void) const     { return (_faction ? _faction->flag : 0);  }
+  const WorldDiplomacy::Faction* GetFaction(void) const { return (_faction); }
   NodePath                 GetJoint(const std::string& name);
 
   void                     SetFurtive(bool do_set);
@@ -58,13 +58,32 @@ public:
   FieldOfView&             GetFieldOfView(void)       { return (field_of_view); }
   const FieldOfView&       GetFieldOfView(void) const { return (field_of_view); }
   void                     SetFaction(const std::string&);
-  void                     SetFaction(unsigned int flag);
+  void                     SetFaction(unsigned int id);
   void                     SetAsEnemy(ObjectCharacter*, bool);
   bool                     IsEnemy(const ObjectCharacter*) const;
   bool                     IsAlly(const ObjectCharacter*)  const;
 
   Script::StdList<ObjectCharacter*> GetNearbyEnemies(void) const;
   Script::StdList<ObjectCharacter*> GetNearbyAllies(void)  const;
+
+  struct NearbyCharacter
+  {
+    NearbyCharacter(void) : character(0), distance(0), hit_points(0), action_points(0), faction(-1), is_enemy(false), is_ally(false), in_sight(false) {}
+
+    ObjectCharacter* character;
+    float            distance;
+    int              hit_points;
+    int              action_points;
+    int              faction;  // Faction id, or -1
+    bool             is_enemy;
+    bool             is_ally;
+    bool             in_sight;
+  };
+
+  typedef Script::StdVector<NearbyCharacter> NearbyCharacters;
+
+  NearbyCharacters         GetCharactersInRadius(float radius) const;
+  NearbyCharacters         GetCharactersInSight(void)         const;
   
   // Script Communication Tools
   void                     RequestAttack(ObjectCharacter* attack, ObjectCharacter* from);
@@ -80,13 +99,14 @@ private:
   void                     RunDeath(void);
   
   void                     RequestCharacter(ObjectCharacter*, ObjectCharacter*, const std::string& func);
+  NearbyCharacters         DescribeCharacters(const std::vector<ObjectCharacter*>& characters, float radius) const;
   
   Sync::ObserverHandler          _obs_handler;
   PT(Character)                  _character;
   DataTree*                      _statistics;
   StatController*                _stats;
   const WorldDiplomacy::Faction* _faction;
-  unsigned int                   _self_enemyMask;
+  WorldDiplomacy::FactionSet     _self_enemies; // Enemy factions of a character without faction
   LineOfSight                    line_of_sight;
   FieldOfView                    field_of_view;
   AngelScript::Object*           script;
@@ -7,18 +7,19 @@
 class Lockable
 {
 public:
-  Lockable(DynamicObject* o) : __object(o) {}
+  Lockable(InstanceDynamicObject* o) : __instance(o), __object(o->GetDynamicObject()) {}
   Lockable(void) {}
 
   string         GetKeyName(void) const { return (__object->key);               }
   bool           IsLocked(void)   const { return (__object->locked);            }
   bool           IsOpen(void)     const { return (!_closed);                    }
-  void           Unlock(void)           { __object->locked = !__object->locked; }
+  void           Unlock(void)           { __object->locked = !__object->locked; __instance->MarkDirty(); }
 
 protected:
   bool           _closed;
 private:
-  DynamicObject* __object;
+  InstanceDynamicObject* __instance;
+  DynamicObject*         __object;
 };
 
 class ObjectDoor : public InstanceDynamicObject, public Lockable
@@ -53,10 +53,15 @@ public:
   TaskSet&                  GetTaskSet(void)                          { return (tasks);                                }
   Data                      GetDataStore(void)                  const { return (data_store);                           }
 
-  void                     AddFlag(unsigned char flag)       { _flags |= flag; }
-  void                     DelFlag(unsigned char flag)       { if (HasFlag(flag)) { _flags -= flag; } }
+  void                     AddFlag(unsigned char flag)       { _flags |= flag; MarkDirty(); }
+  void                     DelFlag(unsigned char flag)       { if (HasFlag(flag)) { _flags -= flag; MarkDirty(); } }
   bool                     HasFlag(unsigned char flag) const { return ((_flags & flag) != 0); }
 
+  // Objects which aren't dirty are skipped by delta saves (see Level::Save)
+  void                     MarkDirty(void)             const { dirty = true;    }
+  void                     ClearDirty(void)                  { dirty = false;   }
+  bool                     IsDirty(void)               const;
+
   float                             GetDistance(const InstanceDynamicObject*) const;
   std::list<InstanceDynamicObject*> GetObjectsInRadius(float radius) const;
 
@@ -77,7 +82,9 @@ protected:
   TaskSet                  tasks;
   LPoint3                  idle_size;
   DataTree*                data_store;
+  std::string              data_store_json; // As last serialized, to find out whether scripts wrote in the data store
   unsigned char            _flags;
+  mutable bool             dirty;
 };
 
 
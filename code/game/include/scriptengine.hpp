@@ -7,6 +7,7 @@
 # include <scriptstdstring/scriptstdstring.h>
 # include "observatory.hpp"
 # include <stdarg.h>
+# include <vector>
 
 namespace Script
 {
@@ -217,7 +218,57 @@ namespace Script
     }
 
   private:
-  };  
+  };
+
+  /*
+   * Contiguous array for the results of bulk queries: the whole array is filled by a single native call,
+   * and reading an entry from a script doesn't go through an iterator.
+   */
+  template<typename T>
+  class StdVector : public std::vector<T>
+  {
+  public:
+    StdVector(void) {}
+
+    static void Register(asIScriptEngine* engine, const std::string& arrayName, const std::string& typeName)
+    {
+      const std::string type = arrayName;
+
+      engine->RegisterObjectType(type.c_str(), sizeof(StdVector), asOBJ_VALUE | asOBJ_APP_CLASS_CDA);
+      engine->RegisterObjectBehaviour(type.c_str(), asBEHAVE_CONSTRUCT, "void f()", asFUNCTION(StdVector<T>::Constructor), asCALL_CDECL_OBJLAST);
+      engine->RegisterObjectBehaviour(type.c_str(), asBEHAVE_DESTRUCT,  "void f()", asFUNCTION(StdVector<T>::Destructor),  asCALL_CDECL_OBJLAST);
+      engine->RegisterObjectMethod(type.c_str(), ("const " + type + " &opAssign(const " + type + " &in)").c_str(), asMETHODPR(StdVector<T>,operator=, (const StdVector<T>&), const StdVector<T>&), asCALL_THISCALL);
+      engine->RegisterObjectMethod(type.c_str(), "int Size() const", asMETHOD(StdVector<T>,Size), asCALL_THISCALL);
+      engine->RegisterObjectMethod(type.c_str(), ("const " + typeName + " &opIndex(int) const").c_str(), asMETHOD(StdVector<T>,At), asCALL_THISCALL);
+    }
+
+    static void Constructor(void* memory) { new(memory) StdVector();                            }
+    static void Destructor (void* memory) { if (memory) { ((StdVector*)memory)->~StdVector(); } }
+
+    const StdVector& operator=(const StdVector& cpy)
+    {
+      if (this != &cpy)
+        std::vector<T>::operator=(cpy);
+      return (*this);
+    }
+
+    unsigned int Size(void) const { return (std::vector<T>::size()); }
+
+    // Out of range indexes are reported to the script as exceptions
+    const T&     At(unsigned int i) const
+    {
+      if (i >= std::vector<T>::size())
+      {
+        static const T    out_of_bounds = T();
+        asIScriptContext* context       = asGetActiveContext();
+
+        if (context)
+          context->SetException("Index out of bounds");
+        return (out_of_bounds);
+      }
+      return (std::vector<T>::operator[](i));
+    }
+  };
 }
 
 #endif
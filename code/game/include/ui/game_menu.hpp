@@ -13,6 +13,7 @@ public:
   GameMenu(WindowFramework* window, Rocket::Core::Context* context);
   ~GameMenu();
   void MenuEventContinue(Rocket::Core::Event& event) { Hide(); }
+  void SetSaveProgress(float progress);
   
   Sync::Signal<void (Rocket::Core::Event&)> SaveClicked;
   Sync::Signal<void (Rocket::Core::Event&)> LoadClicked;
@@ -29,8 +29,13 @@ public:
   Inventory&             GetInventory(void) { return (_inventory); }
 
 private:
+  typedef std::pair<InventoryObject*, unsigned short> Group;
+  typedef std::unordered_map<std::string, Group>      Groups;
+  typedef std::vector<InventoryObject*>               Displayed;
+
   Rocket::Core::Element& _element;
   Inventory&             _inventory;
+  Displayed              _displayed;
 };
 
 class InventoryViewController
@@ -10,6 +10,29 @@
 namespace Rocket
 {
   void ForeachElement(Rocket::Core::Element* root, const std::string& tag, std::function<void (Rocket::Core::Element*)> lambda);
+
+  /*
+   * Element::SetInnerRML parses the RML and lays the subtree out again, even when it didn't change.
+   * SetInnerRML remembers the RML it last set on an element (data-rml attribute) and skips the update
+   * when it is the same. ParseInnerRML always parses, and makes the next SetInnerRML parse too.
+   * Every RML set by the game goes through one of them, so that RmlStats counts them all.
+   */
+  bool        SetInnerRML(Rocket::Core::Element* element, const std::string& rml);
+  void        ParseInnerRML(Rocket::Core::Element* element, const Rocket::Core::String& rml);
+  inline void ParseInnerRML(Rocket::Core::Element* element, const std::string& rml) { ParseInnerRML(element, Rocket::Core::String(rml.c_str())); }
+  inline void ParseInnerRML(Rocket::Core::Element* element, const char* rml)        { ParseInnerRML(element, Rocket::Core::String(rml));         }
+  bool        SetAttribute(Rocket::Core::Element* element, const std::string& name, const std::string& value);
+
+  // RML parsed during each frame, also reported to PStats as "UI:RML parses" in profiler builds
+  struct RmlStats
+  {
+    static void         Parsed(void) { parsed_this_frame++; }
+    static void         EndFrame(void);
+    static unsigned int LastFrame(void) { return (parsed_last_frame); }
+
+  private:
+    static unsigned int parsed_this_frame, parsed_last_frame;
+  };
 }
 
 struct RocketListener : public Rocket::Core::EventListener
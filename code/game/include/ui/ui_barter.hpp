@@ -21,9 +21,9 @@ private:
   void MakeDeal(Rocket::Core::Event&);
   void BarterEnd(Rocket::Core::Event&);
   void UpdateInterface(void);
-  void UpdateInterfaceSide(Rocket::Core::Element* e, Inventory::Content&, StatController*, StatController*);
+  void UpdateInterfaceSide(Rocket::Core::Element* e, Inventory&, StatController*, StatController*);
 
-  int  GetStackValue(Inventory::Content&, StatController*, StatController*);
+  int  GetStackValue(Inventory&, StatController*, StatController*);
   void DropInventory(Inventory& from, Inventory& to);
   bool SwapFunctor(InventoryObject* object, Inventory& from, Inventory& to);
 
@@ -7,6 +7,7 @@
 # include "time_manager.hpp"
 # include "timer.hpp"
 # include "scheduled_task.hpp"
+# include <panda3d/texture.h>
 # include <fstream>
 
 class WorldMap : public UiBase
@@ -22,8 +23,9 @@ class WorldMap : public UiBase
     std::string name;
   };
 
-  typedef std::vector<City>                   Cities;
-  typedef std::vector<Rocket::Core::Element*> Cases;
+  typedef std::vector<City>          Cities;
+  typedef std::vector<Data>          Tiles;
+  typedef std::vector<unsigned char> Fog;
 
 public:
   class Task : public ScheduledTask
@@ -60,6 +62,7 @@ public:
   void Run(void);
   void SetInterrupted(bool set);
   void Save(const std::string&);
+  Data GetMapData(void) const;
   
   void MoveTowardsCoordinates(float x, float y);
 
@@ -79,9 +82,10 @@ private:
   void                   UpdatePartyCursor(float elapsedTime);
   void                   UpdateClock(void);
   bool                   IsPartyInCity(std::string& ret, bool not_hidden = true) const;
-  Rocket::Core::Element* GetCaseAt(int x, int y) const;
   void                   GetCurrentCase(int&, int&) const;
-  void                   SetCaseVisibility(int x, int y, char visibility) const;
+  void                   SetCaseVisibility(int x, int y, char visibility);
+  void                   LoadFog(Data map);
+  void                   UpdateFogTexel(int x, int y);
 
   void                   AddCityToList(Data);
 
@@ -107,7 +111,9 @@ private:
   Rocket::Core::Element* _cursor;
 
   Cities                 _cities;
-  Cases                  _cases;
+  Tiles                  _tiles;
+  Fog                    _fog;
+  PT(Texture)            _fog_texture;
 
   CitySplash*            _city_splash;
 };
@@ -0,0 +1,159 @@
+#include "background_save.hpp"
+#include "directory.hpp"
+#include "my_zlib.hpp"
+#include "profiler.hpp"
+#include <panda3d/pnmImage.h>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+BackgroundSave::BackgroundSave(void) : slot_metadata(0), steps(0), steps_done(0), done(false), started(false), joined(false)
+{
+}
+
+BackgroundSave::~BackgroundSave(void)
+{
+  Wait();
+  ForEach(jsons, [](Json& json) { delete json.tree; });
+  if (slot_metadata)
+    delete slot_metadata;
+}
+
+void BackgroundSave::AddBlob(const string& path, Utils::Packet& packet)
+{
+  Blob blob;
+
+  blob.path = path;
+  blob.data.assign(packet.raw(), packet.size());
+  blobs.push_back(blob);
+  steps++;
+}
+
+void BackgroundSave::AddBlob(const string& path, const string& data)
+{
+  Blob blob;
+
+  blob.path = path;
+  blob.data = data;
+  blobs.push_back(blob);
+  steps++;
+}
+
+void BackgroundSave::AddJson(const string& path, Data data)
+{
+  Json json;
+
+  json.path = path;
+  json.tree = new DataTree;
+  Data(json.tree).Duplicate(data);
+  jsons.push_back(json);
+  steps++;
+}
+
+void BackgroundSave::AddScreenshot(const string& path, PT(Texture) texture)
+{
+  PNMImage     image;
+  stringstream stream;
+
+  // The extension tells Panda which image format to use
+  if (texture.is_null() || !(texture->store(image)) || !(image.write(stream, path)))
+  {
+    error = "couldn't write the screenshot";
+    return ;
+  }
+  screenshot_path = path;
+  AddBlob(path, stream.str());
+}
+
+void BackgroundSave::SetSlot(const string& path, const string& directory, const string& previous, Data metadata)
+{
+  slot_path        = path;
+  slot_directory   = directory;
+  previous_archive = previous;
+  slot_metadata    = new DataTree;
+  Data(slot_metadata).Duplicate(metadata);
+  steps++;
+}
+
+void BackgroundSave::Start(void)
+{
+  started = true;
+  Launch();
+}
+
+void BackgroundSave::Wait(void)
+{
+  if (started && !joined)
+  {
+    Join();
+    joined = true;
+  }
+}
+
+void BackgroundSave::Run(void)
+{
+  PROFILE_ZONE("Saving:Write");
+
+  try
+  {
+    ForEach(blobs, [this](const Blob& blob) { WriteBlob(blob); steps_done++; });
+    ForEach(jsons, [this](const Json& json) { WriteJson(json); steps_done++; });
+    if (slot_path != "")
+    {
+      WriteSlot();
+      steps_done++;
+    }
+  }
+  catch (const std::exception& exception)
+  {
+    error = exception.what();
+  }
+  done.store(true);
+}
+
+void BackgroundSave::ReplaceFile(const string& temporary, const string& path)
+{
+#ifdef _WIN32
+  remove(path.c_str());
+#endif
+  if (rename(temporary.c_str(), path.c_str()) != 0)
+    throw std::runtime_error("couldn't write file '" + path + '\'');
+}
+
+void BackgroundSave::WriteBlob(const Blob& blob)
+{
+  const string temporary = blob.path + ".tmp";
+  ofstream     file(temporary.c_str(), ios::binary);
+
+  if (!(file.is_open()))
+    throw std::runtime_error("couldn't open file '" + blob.path + "'.");
+  file.write(blob.data.data(), blob.data.size());
+  file.close();
+  ReplaceFile(temporary, blob.path);
+}
+
+void BackgroundSave::WriteJson(const Json& json)
+{
+  const string temporary = json.path + ".tmp";
+
+  if (!(DataTree::Writers::JSON(json.tree, temporary)))
+    throw std::runtime_error("couldn't write file '" + json.path + "'.");
+  ReplaceFile(temporary, json.path);
+}
+
+void BackgroundSave::WriteSlot(void)
+{
+  const string slot_json = slot_path + ".json";
+
+  Utils::DirectoryCompressor::Update(slot_path, slot_directory, previous_archive, [](const string& name)
+  {
+    return (name != "preview.png");
+  });
+  if (screenshot_path != "")
+    Filesystem::FileCopy(screenshot_path, slot_path + ".png");
+  if (!(DataTree::Writers::JSON(slot_metadata, slot_json + ".tmp")))
+    throw std::runtime_error("couldn't write file '" + slot_json + "'.");
+  ReplaceFile(slot_json + ".tmp", slot_json);
+}
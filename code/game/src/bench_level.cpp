@@ -0,0 +1,251 @@
+#include "gametask.hpp"
+#include "playerparty.hpp"
+#include "quest_manager.hpp"
+#include "musicmanager.hpp"
+#include "executor.hpp"
+#include "ui/general_ui.hpp"
+#include "ui/alert_ui.hpp"
+#include "dices.hpp"
+#include "profiler.hpp"
+#include <mousecursor.hpp>
+#include <options.hpp>
+#include <panda3d/pandaFramework.h>
+#include <panda3d/load_prc_file.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+
+#define BENCH_TIMESTEP (1.f / 60.f)
+#define BENCH_SEED     0
+
+using namespace std;
+
+extern PandaFramework* framework;
+extern bool            world_is_game_save;
+
+#ifdef BENCH_ALLOCATIONS
+/*
+ * Allocations made through operator new, whichever thread makes them.
+ * Replacing operator new costs an atomic increment per allocation: it's only built with the BENCH_ALLOCATIONS
+ * option (see CMakeLists.txt), and --bench-level only reports allocations in such builds.
+ */
+static atomic<unsigned long> allocation_count(0);
+
+void* operator new(size_t size)
+{
+  void* ptr = malloc(size == 0 ? 1 : size);
+
+  if (ptr == 0)
+    throw bad_alloc();
+  allocation_count.fetch_add(1, memory_order_relaxed);
+  return (ptr);
+}
+
+void operator delete(void* ptr) throw()
+{
+  free(ptr);
+}
+
+static unsigned long AllocationCount(void) { return (allocation_count.load(memory_order_relaxed)); }
+#else
+static unsigned long AllocationCount(void) { return (0); }
+#endif
+
+static double Seconds(chrono::steady_clock::time_point start)
+{
+  return (chrono::duration<double>(chrono::steady_clock::now() - start).count());
+}
+
+/*
+ * Writes the 50th, 90th and 99th percentiles and the maximum of a serie of samples, multiplied by scale:
+ * durations in seconds are written in milliseconds, counts are written as is with a scale of 1.
+ */
+static void WritePercentiles(Data data, vector<double> samples, double scale = 1000.0)
+{
+  if (samples.empty())
+    return ;
+  sort(samples.begin(), samples.end());
+  data["p50"] = samples[(samples.size() - 1) * 50 / 100] * scale;
+  data["p90"] = samples[(samples.size() - 1) * 90 / 100] * scale;
+  data["p99"] = samples[(samples.size() - 1) * 99 / 100] * scale;
+  data["max"] = samples.back() * scale;
+}
+
+/*
+ * Loads a map from maps/ the way GameTask does, with a party made out of data/charsheets/self.json,
+ * then steps it with a fixed timestep and no user input.
+ */
+class LevelBenchmark
+{
+public:
+  LevelBenchmark(GameTask& game_task, Data report) : game_task(game_task), report(report) {}
+
+  bool Load(const string& map_name)
+  {
+    auto        start = chrono::steady_clock::now();
+    string      blob;
+    Data        load  = report["load"];
+
+    game_task.player_party  = new PlayerParty(""); // No save: the party is only made of the default character
+    if (game_task.player_party->GetMember("self") == 0)
+      game_task.player_party->Join("self");
+    game_task.player_stats  = game_task.player_party->GetPlayerController();
+    game_task.quest_manager = new QuestManager(game_task.data_engine, game_task.player_stats);
+    load["party"] = Seconds(start) * 1000.0;
+
+    start = chrono::steady_clock::now();
+    {
+      ifstream file(("maps/" + map_name + ".blob").c_str(), ios::binary);
+
+      if (!(file.is_open()))
+      {
+        cerr << "Can't open maps/" << map_name << ".blob" << endl;
+        return (false);
+      }
+      blob.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    }
+    load["read"] = Seconds(start) * 1000.0;
+
+    start = chrono::steady_clock::now();
+    {
+      Utils::Packet packet(blob.c_str(), blob.size());
+
+      world_is_game_save = false;
+      game_task.level    = new Level(map_name, game_task.window, game_task.game_ui, packet, game_task.time_manager);
+    }
+    load["level"] = Seconds(start) * 1000.0;
+
+    start = chrono::steady_clock::now();
+    {
+      Level* level = game_task.level;
+      World* world = level->GetWorld();
+
+      level->SetDataEngine(&game_task.data_engine);
+      level->InsertParty(*game_task.player_party, world->zones.empty() ? "" : world->zones.front().name);
+      game_task.quest_manager->Initialize(level);
+      if (level->GetPlayer() == 0)
+      {
+        cerr << "The player couldn't be placed in " << map_name << endl;
+        return (false);
+      }
+    }
+    load["spawn"] = Seconds(start) * 1000.0;
+    return (true);
+  }
+
+  void Run(Level::State state, unsigned int frames)
+  {
+    Level*                  level       = game_task.level;
+    FramePhases&            phases      = level->GetFramePhases();
+    vector<double>          frame_times, render_times, rml_parses;
+    vector<vector<double> > phase_times(phases.Count());
+    unsigned long           allocations = 0;
+    Data                    data        = report[state == Level::Fight ? "fight" : "normal"];
+
+    if (state == Level::Fight)
+      level->GetCombat().Start(level->GetPlayer());
+    else
+      level->SetState(state);
+    for (unsigned int frame = 0 ; frame < frames && level->GetExit().ReadyForNextZone() == false ; ++frame)
+    {
+      unsigned long allocations_before = AllocationCount();
+      auto          start              = chrono::steady_clock::now();
+
+      game_task._signals.ExecuteRecordedCalls();
+      game_task.time_manager.ExecuteTasks();
+      level->do_task(BENCH_TIMESTEP);
+      Executor::Run();
+      frame_times.push_back(Seconds(start));
+      allocations += AllocationCount() - allocations_before;
+      Rocket::RmlStats::EndFrame();
+      rml_parses.push_back(Rocket::RmlStats::LastFrame());
+      for (unsigned int i = 0 ; i < phases.Count() ; ++i)
+        phase_times[i].push_back(phases.GetDuration(i));
+      start = chrono::steady_clock::now();
+      framework->get_graphics_engine()->render_frame();
+      render_times.push_back(Seconds(start));
+    }
+    data["frames"]                = frame_times.size();
+#ifdef BENCH_ALLOCATIONS
+    data["allocations"]["total"]  = allocations;
+    data["allocations"]["frame"]  = frame_times.empty() ? 0.0 : (double)allocations / frame_times.size();
+#endif
+    WritePercentiles(data["frame"],  frame_times);
+    WritePercentiles(data["render"], render_times);
+    WritePercentiles(data["rml-parses"], rml_parses, 1.0);
+    for (unsigned int i = 0 ; i < phases.Count() ; ++i)
+      WritePercentiles(data["phases"][phases.GetName(i)], phase_times[i]);
+    level->SetState(Level::Normal); // also stops the combat
+  }
+
+private:
+  GameTask& game_task;
+  Data      report;
+};
+
+/*
+ * Headless performance baseline: loads maps/<map_name>.blob in an offscreen window, runs it for
+ * the given amount of frames out of combat, then as many in combat, and writes the load times,
+ * the frame and phase times and RML parses percentiles to bench-<map_name>.json, along with the allocation counts
+ * when built with BENCH_ALLOCATIONS.
+ * The profiler zones are exported to bench-<map_name>.trace.json (empty unless built with the PROFILER option).
+ */
+int bench_level(const string& map_name, unsigned int frames)
+{
+  int              argc   = 0;
+  char**           argv   = 0;
+  ConfigPage*      config = load_prc_file("config.prc");
+  WindowFramework* window;
+  int              result = -1;
+  DataTree         report_tree;
+  Data             report(&report_tree);
+
+  Dices::Initialize(BENCH_SEED); // Runs of a same map draw the same numbers
+  Profiler::SetEnabled(true);
+  load_prc_file_data("", "window-type offscreen");
+  framework->open_framework(argc, argv);
+  window = framework->open_window();
+  if (window)
+  {
+    OptionsManager::Initialize();
+    MusicManager::Initialize();
+    AlertUi::NewAlert.Connect([](const string message) { cerr << "[Bench] " << message << endl; });
+    {
+      GeneralUi      general_ui(window);
+      MouseCursor    mouse_cursor(window, general_ui.GetRocketRegion()->get_context());
+      GameTask       game_task(window, general_ui);
+      LevelBenchmark benchmark(game_task, report);
+
+      report["map"]      = map_name;
+      report["timestep"] = BENCH_TIMESTEP;
+      report["seed"]     = BENCH_SEED;
+      try
+      {
+        if (benchmark.Load(map_name))
+        {
+          benchmark.Run(Level::Normal, frames);
+          benchmark.Run(Level::Fight,  frames);
+          result = 0;
+        }
+      }
+      catch (const std::exception& exception)
+      {
+        cerr << "Benchmark of " << map_name << " failed: " << exception.what() << endl;
+      }
+    }
+    if (result == 0 && !(DataTree::Writers::JSON(report, "bench-" + map_name + ".json")))
+      result = -1;
+    if (result == 0 && !(Profiler::ExportChromeTrace("bench-" + map_name + ".trace.json")))
+      result = -1;
+    if (result == 0)
+      cout << "[Bench] Report written to bench-" << map_name << ".json, zones to bench-" << map_name << ".trace.json" << endl;
+    MusicManager::Finalize();
+    OptionsManager::Finalize();
+  }
+  framework->close_framework();
+  unload_prc_file(config);
+  return (result);
+}
@@ -110,7 +110,7 @@ void           StatModel::SetCurrentHp(short hp)
 
 unsigned short StatModel::GetLevel(void) const
 {
-  return (_statsheet["Variables"]["Level"].Or(1));
+  return (_paths.level.From(_statsheet).Or(1));
 }
 
 void           StatModel::LevelUp(void)
@@ -317,7 +317,7 @@ bool          StatModel::UpdateAllValues(void)
     std::for_each(_statsheet["Skills"].begin(), _statsheet["Skills"].end(), [this](Data value)
     { SkillChanged.Emit(value.Key(), value); });
 
-    MaxHpChanged.Emit(_statsheet["Statistics"]["Hit Points"]);
+    MaxHpChanged.Emit(GetMaxHp());
     PerksChanged.Emit();
 
     return (true);
@@ -411,12 +411,12 @@ std::string    StatModel::GetStatistic(const std::string& stat) const
 
 short          StatModel::GetSpecial(const std::string& stat)   const
 {
-  return (_statsheet["Special"][stat].Or(1));
+  return (_paths.special.From(_statsheet)[stat].Or(1));
 }
 
 short          StatModel::GetSkill(const std::string& stat)     const
 {
-  return (_statsheet["Skills"][stat].Or(1));
+  return (_paths.skills.From(_statsheet)[stat].Or(1));
 }
 
 vector<string> StatModel::GetStatKeys(Data stats) const
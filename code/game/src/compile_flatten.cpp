@@ -0,0 +1,56 @@
+#include "world/world.h"
+#include "world/world_flatten.hpp"
+#include <panda3d/pandaFramework.h>
+#include <panda3d/load_prc_file.h>
+#include <fstream>
+#include <string>
+
+using namespace std;
+
+extern PandaFramework* framework;
+extern bool            world_is_game_save;
+
+/*
+ * Bakes the static geometry of maps/<map_name>.blob into maps/<map_name>.flat.bam (see WorldFlattener).
+ * The blob itself isn't modified: the side file is matched to its map objects by checksum.
+ */
+int compile_flatten(const std::string& map_name)
+{
+  const string     blob_path = "maps/" + map_name + ".blob";
+  ifstream         file(blob_path.c_str(), ios::binary);
+  int              argc = 0;
+  char**           argv = 0;
+  WindowFramework* window;
+  int              result = -1;
+
+  if (!(file.is_open()))
+  {
+    cerr << "Can't open " << blob_path << endl;
+    return (-1);
+  }
+  load_prc_file_data("", "window-type offscreen");
+  framework->open_framework(argc, argv);
+  window = framework->open_window();
+  if (window)
+  {
+    Utils::Packet packet(file);
+    World         world(window);
+
+    world_is_game_save = false;
+    world.UnSerialize(packet);
+    {
+      WorldFlattener flattener(world);
+      NodePath       flattened = flattener.Flatten();
+
+      if (flattened.write_bam_file(WorldFlattener::SideFilePath(blob_path)))
+      {
+        cout << "Wrote " << flattened.get_num_children() << " groups to " << WorldFlattener::SideFilePath(blob_path) << endl;
+        result = 0;
+      }
+      else
+        cerr << "Can't write " << WorldFlattener::SideFilePath(blob_path) << endl;
+    }
+  }
+  framework->close_framework();
+  return (result);
+}
@@ -0,0 +1,88 @@
+#include "world/world.h"
+#include <panda3d/pandaFramework.h>
+#include <panda3d/load_prc_file.h>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+extern PandaFramework* framework;
+extern bool            world_is_game_save;
+
+static bool ConvertBlob(WindowFramework* window, const string& path)
+{
+  ifstream     file(path.c_str(), ios::binary);
+  stringstream backup_path;
+
+  if (!(file.is_open()))
+  {
+    cerr << "Can't open " << path << endl;
+    return (false);
+  }
+  {
+    Utils::Packet packet(file);
+    World         world(window);
+    Utils::Packet converted;
+
+    blob_revision      = CURRENT_BLOB_REVISION;
+    world_is_game_save = false;
+    world.UnSerialize(packet);
+    if (blob_revision >= CURRENT_BLOB_REVISION)
+    {
+      cout << path << " is already at revision " << blob_revision << endl;
+      return (true);
+    }
+    world.Serialize(converted);
+    backup_path << path << ".rev" << blob_revision;
+    {
+      const string tmp_path = path + ".tmp";
+      ofstream     output(tmp_path.c_str(), ios::binary);
+
+      output.write(converted.raw(), converted.size());
+      output.close();
+      if (!output.good() || rename(path.c_str(), backup_path.str().c_str()) || rename(tmp_path.c_str(), path.c_str()))
+      {
+        cerr << "Can't write " << path << endl;
+        return (false);
+      }
+    }
+  }
+  cout << path << " converted, previous version kept as " << backup_path.str() << endl;
+  return (true);
+}
+
+/*
+ * Rewrites map blobs of older revisions to the current one (see WorldSections).
+ * Flattened side files are matched to the blob by checksum: they must be baked again afterwards (--compile-flatten).
+ */
+int convert_blobs(const vector<string>& paths)
+{
+  int              argc = 0;
+  char**           argv = 0;
+  WindowFramework* window;
+  int              result = 0;
+
+  load_prc_file_data("", "window-type offscreen");
+  framework->open_framework(argc, argv);
+  window = framework->open_window();
+  if (!window)
+    result = -1;
+  for (auto it = paths.begin() ; window && it != paths.end() ; ++it)
+  {
+    try
+    {
+      if (!(ConvertBlob(window, *it)))
+        result = -1;
+    }
+    catch (const std::exception& exception)
+    {
+      cerr << "Can't convert " << *it << ": " << exception.what() << endl;
+      result = -1;
+    }
+  }
+  framework->close_framework();
+  return (result);
+}
@@ -10,8 +10,8 @@ Encounter::Encounter(StatController* player_statistics) : player_statistics(play
 
   is_event    = false;
   pos_x       = pos_y = 0;
-  is_detected = Dices::Throw(200) <= outdoorsman;
-  is_special  = Dices::Throw(150) <= luck;
+  is_detected = Dices::Throw(200, Dices::Encounters) <= outdoorsman;
+  is_special  = Dices::Throw(150, Dices::Encounters) <= luck;
 }
 
 void Encounter::SetCoordinates(int x, int y)
@@ -36,9 +36,9 @@ void Encounter::InitializeEncounter(DataEngine &, WorldMap *worldmap)
 
   if (maps.Count() == 0 || (is_event && encounters.Count() == 0))
     throw NoAvailableEncounters();
-  map_name         = maps[Dices::Throw(maps.Count()) - 1].Value();
+  map_name         = maps[Dices::Throw(maps.Count(), Dices::Encounters) - 1].Value();
   if (is_event)
-    encounter_name = encounters[Dices::Throw(encounters.Count()) - 1].Value();
+    encounter_name = encounters[Dices::Throw(encounters.Count(), Dices::Encounters) - 1].Value();
 }
 
 void Encounter::InitializeSpecialEncounter(DataEngine& data_engine, WorldMap* worldmap)
@@ -11,6 +11,10 @@
 #include <loading_exception.hpp>
 #include "scheduled_task.hpp"
 #include "encounter_spawn.hpp"
+#include "background_save.hpp"
+#include "world/asset_cache.hpp"
+#include "level/item_template.hpp"
+#include "profiler.hpp"
 
 using namespace std;
 
@@ -18,6 +22,31 @@ GameTask* GameTask::CurrentGameTask = 0;
 
 extern PandaFramework* framework;
 
+static std::string DeltaPath(const std::string& blob_path)
+{
+  return (blob_path.substr(0, blob_path.rfind(".blob")) + ".delta");
+}
+
+static bool ReadLevelFile(const std::string& path, std::string& out)
+{
+  std::ifstream file(path.c_str(), std::ios::binary);
+
+  if (!(file.is_open()))
+    return (false);
+  out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return (true);
+}
+
+static bool WriteLevelFile(const std::string& path, const std::string& data)
+{
+  std::ofstream file(path.c_str(), std::ios::binary);
+
+  if (!(file.is_open()))
+    return (false);
+  file.write(data.c_str(), data.size());
+  return (true);
+}
+
 GameTask::GameTask(WindowFramework* window, GeneralUi& generalUi) : game_ui(window, generalUi.GetRocketRegion()),
                                                                     pipbuck(window, generalUi.GetRocketRegion()->get_context(), data_engine)
 {
@@ -27,15 +56,23 @@ GameTask::GameTask(WindowFramework* window, GeneralUi& generalUi) : game_ui(wind
   item_index       = DataTree::Factory::JSON("data/objects.json");
   level            = 0;
   save_path        = OptionsManager::Get()["savepath"].Value();
+  if (OptionsManager::Get()["asset-cache-budget"].NotNil())
+  {
+    unsigned int budget = OptionsManager::Get()["asset-cache-budget"]; // in megabytes
+
+    AssetCache::Get().SetBudget(budget * 1024 * 1024);
+  }
   world_map        = 0;
   player_party     = 0;
   player_stats     = 0;
   quest_manager    = 0;
   loading_screen   = 0;
+  background_save  = 0;
   game_ui.GetMenu().SaveClicked.Connect(*this, &GameTask::SaveClicked);
   game_ui.GetMenu().LoadClicked.Connect(*this, &GameTask::LoadClicked);
   game_ui.GetMenu().ExitClicked.Connect(*this, &GameTask::Exit);
   game_ui.GetMenu().OptionsClicked.Connect(generalUi.GetOptions(), &UiBase::FireShow);
+  SaveProgress.Connect(game_ui.GetMenu(), &GameMenu::SetSaveProgress);
   game_ui.OpenPipbuck.Connect(pipbuck, &UiBase::FireShow);
 
   SyncLoadLevel.SetDirect(false);
@@ -46,6 +83,7 @@ GameTask::GameTask(WindowFramework* window, GeneralUi& generalUi) : game_ui(wind
 GameTask::~GameTask()
 {
   Cleanup();
+  ItemTemplate::Clear();
   if (item_index) delete item_index;
   CurrentGameTask = 0;
 }
@@ -149,6 +187,12 @@ AsyncTask::DoneStatus GameTask::do_task()
     return (AsyncTask::DS_done);
   _signals.ExecuteRecordedCalls();
 
+  if (background_save)
+  {
+    SaveProgress.Emit(background_save->GetProgress());
+    if (background_save->IsDone())
+      FinishSave();
+  }
   time_manager.ExecuteTasks();
   if (player_stats && (int)(player_stats->GetData()["Variables"]["Hit Points"]) <= 0)
     GameOver();
@@ -157,44 +201,95 @@ AsyncTask::DoneStatus GameTask::do_task()
   else if (world_map)
     world_map->Run();
   pipbuck.Run();
+  Rocket::RmlStats::EndFrame();
   return (AsyncTask::DS_cont);
 }
 
-bool GameTask::SaveGame()
+/*
+ * Only the snapshot happens here: files are written by a BackgroundSave thread while the game keeps running.
+ * Errors are reported once the BackgroundSave is done (see FinishSave).
+ */
+bool GameTask::SaveGame(const std::string& slot_path)
 {
-  bool     success      = true;
+  PROFILE_ZONE("Saving:Snapshot");
   DateTime current_time = time_manager.GetDateTime();
 
-  world_map->Save(save_path);
+  WaitForSave();
+  background_save = new BackgroundSave;
   if (level)
   {
+    const std::string path = save_path + "/" + level->GetName();
+    std::string       snapshot, delta;
+
     data_engine["system"]["current-level"] = level->GetName();
-    success = success && SaveLevel(level, save_path + "/" + level->GetName() + ".blob");
+    if (level->Save(snapshot, delta))
+      background_save->AddBlob(path + ".blob", snapshot);
+    background_save->AddBlob(path + ".delta", delta);
   }
   else
     data_engine["system"]["current-level"] = 0;
-  player_party->Save(save_path);
+  {
+    Utils::Packet packet;
+
+    player_party->Serialize(packet);
+    background_save->AddBlob(save_path + "/party-" + player_party->GetName() + ".blob", packet);
+  }
+  background_save->AddJson("saves/map.json", world_map->GetMapData());
   data_engine["time"]["seconds"] = current_time.GetSecond();
   data_engine["time"]["minutes"] = current_time.GetMinute();
   data_engine["time"]["hours"]   = current_time.GetHour();
   data_engine["time"]["days"]    = current_time.GetDay();
   data_engine["time"]["month"]   = current_time.GetMonth();
   data_engine["time"]["year"]    = current_time.GetYear();
-  data_engine.Save(save_path + "/dataengine.json");
+  for (unsigned int i = 0 ; i < Dices::StreamCount ; ++i)
+    data_engine["random"][Dices::GetName((Dices::Stream)i)] = Dices::Get((Dices::Stream)i).GetState();
+  background_save->AddJson(save_path + "/dataengine.json", data_engine);
 
   if (level != 0)
   {
     UiBase::ToggleUserInterface.Emit(false);
     window->get_render().set_transparency(TransparencyAttrib::M_alpha, 1);
     framework->get_graphics_engine()->render_frame();
-    window->get_graphics_window()->get_screenshot()->write(save_path + "/preview.png");
+    background_save->AddScreenshot(save_path + "/preview.png", window->get_graphics_window()->get_screenshot());
     UiBase::ToggleUserInterface.Emit(true);
   }
-  return (success);
+  if (slot_path != "")
+  {
+    DataTree metadata;
+    Data     data(&metadata);
+
+    data["time"].Duplicate(data_engine["time"]);
+    data["system"].Duplicate(data_engine["system"]);
+    background_save->SetSlot(slot_path, save_path, slot_archive, data);
+  }
+  background_save->Start();
+  return (true);
+}
+
+void GameTask::FinishSave(void)
+{
+  background_save->Wait();
+  SaveProgress.Emit(1.f);
+  if (!(background_save->Succeeded()))
+    AlertUi::NewAlert.Emit("Failed to save: " + background_save->GetError());
+  else if (background_save->GetSlotPath() != "")
+  {
+    slot_archive = background_save->GetSlotPath();
+    data_engine["system"]["slot-archive"] = slot_archive;
+  }
+  delete background_save;
+  background_save = 0;
+}
+
+void GameTask::WaitForSave(void)
+{
+  if (background_save)
+    FinishSave();
 }
 
 void GameTask::Cleanup(void)
 {
+  WaitForSave();
   if (quest_manager) delete quest_manager;
   if (level)
   {
@@ -214,11 +309,20 @@ void GameTask::Cleanup(void)
 
 void GameTask::LoadDataEngine(void)
 {
-  Data time;
+  Data time, random;
 
   data_engine.Load(save_path + "/dataengine.json");
   time             = data_engine["time"];
+  random           = data_engine["random"];
   time_manager.SetTime(time["seconds"], time["minutes"], time["hours"], time["days"], time["month"], time["year"]);
+  // Saves made before the random streams were saved keep the streams seeded at startup
+  for (unsigned int i = 0 ; i < Dices::StreamCount ; ++i)
+  {
+    Data state = random[Dices::GetName((Dices::Stream)i)];
+
+    if (state.NotNil())
+      Dices::Get((Dices::Stream)i).SetState(state.Value());
+  }
   pipbuck.Restart();
   LoadingScreen::AppendText("The time is " + time_manager.GetDateTime().ToString());
 }
@@ -251,6 +355,9 @@ bool GameTask::LoadGame()
     Data loading_level;
 
     LoadDataEngine();
+    if (slot_archive == "" && !(data_engine["system"]["slot-archive"].Nil()))
+      slot_archive = data_engine["system"]["slot-archive"].Value();
+    data_engine["system"]["slot-archive"] = slot_archive;
     LoadingScreen::SetBackground(data_engine["system"]["current-level"].Value());
     LoadPlayerData();
     LoadWorldMap();
@@ -261,6 +368,7 @@ bool GameTask::LoadGame()
       LoadLevelParams params;
       
       params.name       = current_level.Value();
+      ExtractLevelFromSlot(params.name);
       params.path       = save_path + '/' + params.name + ".blob";
       params.entry_zone = loading_level.Nil() ? "" : loading_level["entry-zone"].Value();
       params.isSaveFile = loading_level.Nil() || Filesystem::FileExists(params.path);
@@ -292,10 +400,12 @@ void GameTask::OpenLevel(const std::string& level_name, const std::string& entry
   std::string     filename = level_name + ".blob";
   LoadLevelParams params;
 
+  WaitForSave();
   data_engine["system"]["loading-level"]["level-name"] = level_name;
   data_engine["system"]["loading-level"]["entry-zone"] = entry_zone;
   params.name       = level_name;
   params.entry_zone = entry_zone;
+  ExtractLevelFromSlot(level_name);
   params.isSaveFile = Filesystem::FileExists(save_path + '/' + filename);
   if (params.isSaveFile)
     params.path     = save_path + '/' + filename;
@@ -307,12 +417,14 @@ void GameTask::OpenLevel(const std::string& level_name, const std::string& entry
 
 void GameTask::ExitLevel()
 {
+  WaitForSave();
   level->RemovePartyFromLevel(*player_party);
   if (level->IsPersistent())
     SaveLevel(level, save_path + "/" + level->GetName() + ".blob");
   quest_manager->Finalize();
   delete level;
   level = 0;
+  AssetCache::Get().Trim();
   world_map->SetInterrupted(false);
 }
 
@@ -322,7 +434,18 @@ void GameTask::EraseSlot(unsigned char slot)
   string       dirname;
   Directory    dir;
   
+  WaitForSave();
   stream << save_path << "/slots/slot-" << (int)slot;
+  if (stream.str() == slot_archive)
+  {
+    // The current progression still needs the levels it didn't extract yet
+    Utils::DirectoryCompressor::Uncompress(slot_archive, save_path, [this](const string& name)
+    {
+      return (!(Filesystem::FileExists(save_path + '/' + name)));
+    });
+    slot_archive = "";
+    data_engine["system"]["slot-archive"] = slot_archive;
+  }
   remove(stream.str().c_str());
   remove((stream.str() + ".png").c_str());
   remove((stream.str() + ".json").c_str());
@@ -330,40 +453,15 @@ void GameTask::EraseSlot(unsigned char slot)
 
 void GameTask::SaveToSlot(unsigned char slot)
 {
-  if (SaveGame())
+  if (!Directory::Exists(save_path + "/slots") && !Directory::MakeDir(save_path + "/slots"))
+    AlertUi::NewAlert.Emit("Failed to save: cannot access directory " + save_path + "/slots");
+  else
   {
-    if (!Directory::Exists(save_path + "/slots") && !Directory::MakeDir(save_path + "/slots"))
-      AlertUi::NewAlert.Emit("Failed to save: cannot access directory " + save_path + "/slots");
-    else
-    {
-      std::stringstream stream;
+    std::stringstream stream;
 
-      stream << save_path << "/slots/slot-" << (int)slot;
-      EraseSlot(slot);
-      CompressSave(stream.str());
-    }
-  }
-}
-
-bool GameTask::CompressSave(const std::string& slotPath)
-{
-  DataTree metadata;
-  Data     data(&metadata);
-
-  try
-  {
-    data["time"].Duplicate(data_engine["time"]);
-    data["system"].Duplicate(data_engine["system"]);
-    Utils::DirectoryCompressor::Compress(slotPath, save_path, [](const string& i) { return (i != "preview.png"); });
-    Filesystem::FileCopy(save_path + "preview.png", slotPath + ".png");
-    DataTree::Writers::JSON(data, slotPath + ".json");
+    stream << save_path << "/slots/slot-" << (int)slot;
+    SaveGame(stream.str());
   }
-  catch (const std::exception& exception)
-  {
-    AlertUi::NewAlert.Emit("Failed to save: " + std::string(exception.what()));
-    return (false);
-  }
-  return (true);
 }
 
 void GameTask::DoLoadSlot(unsigned char slot)
@@ -376,10 +474,22 @@ bool GameTask::LoadSlot(unsigned char slot)
   std::stringstream slot_path;
 
   slot_path << save_path << "/slots/slot-" << (unsigned int)slot;
+  WaitForSave();
   RemoveCurrentProgression();
   try
   {
-    Utils::DirectoryCompressor::Uncompress(slot_path.str(), save_path);
+    if (Utils::Archive::IsArchive(slot_path.str()))
+    {
+      // Levels are only extracted once they are entered
+      Utils::DirectoryCompressor::Uncompress(slot_path.str(), save_path, [](const string& name)
+      {
+        return ((name.size() < 5 || name.substr(name.size() - 5) != ".blob") &&
+                (name.size() < 6 || name.substr(name.size() - 6) != ".delta"));
+      });
+      slot_archive = slot_path.str();
+    }
+    else
+      Utils::DirectoryCompressor::Uncompress(slot_path.str(), save_path);
     return (LoadGame());
   }
   catch (const std::exception& exception)
@@ -396,34 +506,54 @@ void GameTask::RemoveCurrentProgression(void)
   Directory         dir;
 
   dir.OpenDir(save_path);
-
-  std::for_each(dir.GetEntries().begin(), dir.GetEntries().end(), [](const Dirent& entry)
+  slot_archive = "";
+  std::for_each(dir.GetEntries().begin(), dir.GetEntries().end(), [this](const Dirent& entry)
   {
     if (entry.d_type == DT_REG)
     {
-      std::string dname = entry.d_name;
+      std::string dname = save_path + '/' + entry.d_name;
       remove(dname.c_str());
     }
   });
 }
 
-bool GameTask::SaveLevel(Level* level, const std::string& name)
+void GameTask::ExtractLevelFromSlot(const std::string& level_name)
 {
-  Utils::Packet packet;
-  std::ofstream file;
+  const std::string path = save_path + '/' + level_name + ".blob";
+  Utils::Archive    archive;
 
-  level->Serialize(packet);
-  file.open(name.c_str(), std::ios::binary);
-  if (file.is_open())
+  if (slot_archive == "" || Filesystem::FileExists(path))
+    return ;
+  try
   {
-    file.write(packet.raw(), packet.size());
-    file.close();
+    if (archive.Open(slot_archive))
+    {
+      archive.ExtractFile(level_name + ".blob", path);
+      if (archive.Find(level_name + ".delta"))
+        archive.ExtractFile(level_name + ".delta", DeltaPath(path));
+    }
   }
-  else
+  catch (const std::exception& exception)
+  {
+    remove(path.c_str());
+    AlertUi::NewAlert.Emit("Failed to load " + level_name + ": " + std::string(exception.what()));
+  }
+}
+
+bool GameTask::SaveLevel(Level* level, const std::string& name)
+{
+  std::string snapshot, delta;
+
+  if (level->Save(snapshot, delta) && !(WriteLevelFile(name, snapshot)))
   {
     AlertUi::NewAlert.Emit("Failed to save level: couldn't open file '" + name + "'.");
     return (false);
   }
+  if (!(WriteLevelFile(DeltaPath(name), delta)))
+  {
+    AlertUi::NewAlert.Emit("Failed to save level: couldn't open file '" + DeltaPath(name) + "'.");
+    return (false);
+  }
   return (true);
 }
 
@@ -449,18 +579,28 @@ void GameTask::LoadLevelFromPacket(LoadLevelParams params, Utils::Packet& packet
 
 void GameTask::LoadLevel(LoadLevelParams params)
 {
-  ifstream file;
-  bool     success = false;
+  PROFILE_ZONE("Loading:Level");
+  std::string snapshot;
+  bool        success = false;
 
-  file.open(params.path.c_str(), std::ios::binary);
-  if (file.is_open())
+  WaitForSave();
+  if (ReadLevelFile(params.path, snapshot))
   {
-    Utils::Packet packet(file);
+    DeltaSave delta_save;
 
-    file.close();
     try
     {
-      LoadLevelFromPacket(params, packet);
+      std::string delta;
+
+      // Persistent levels may have been saved as a snapshot and a delta: they're merged back before loading
+      if (params.isSaveFile && ReadLevelFile(DeltaPath(params.path), delta) && delta_save.Load(snapshot, delta))
+        snapshot = delta_save.Rebuild(snapshot);
+      {
+        Utils::Packet packet(snapshot.c_str(), snapshot.size());
+
+        LoadLevelFromPacket(params, packet);
+      }
+      level->GetDeltaSave() = delta_save;
       success = true;
     }
     catch (LoadingException exception)
@@ -1,4 +1,5 @@
 #include "level/objects/instance_dynamic_object.hpp"
+#include "logger.hpp"
 #include <panda3d/nodePathCollection.h>
 #include <panda3d/auto_bind.h>
 
@@ -17,7 +18,7 @@ bool                     AnimatedObject::LoadAnimation(const std::string& name)
 
   if (np.get_error_type() != NodePath::ET_ok)
   {
-    std::cout << "Can't load anim " << name << " for " << _modelName << std::endl;
+    LOG(Map, Warning) << "Can't load anim " << name << " for " << _modelName;
     return (false);
   }
   auto_bind(root.node(), _anims, 0xf);
@@ -29,7 +30,7 @@ bool                     AnimatedObject::LoadAnimation(const std::string& name)
 
 void                     AnimatedObject::PlayAnimation(const std::string& name, bool loop)
 {
-  cout << this << " - PlayAnimation('" << name << "')" << endl;
+  LOG(Map, Debug) << this << " - PlayAnimation('" << name << "')";
   MapAnims::iterator     it   = _mapAnims.find(name);
   AnimControl*           anim = (it != _mapAnims.end() ? it->second : 0);
 
@@ -2,7 +2,9 @@
 #include "level/objects/character.hpp"
 #include "level/level.hpp"
 #include "dices.hpp"
+#include "profiler.hpp"
 #include <algorithm>
+#include <iterator>
 
 using namespace std;
 
@@ -34,11 +36,18 @@ void FieldOfView::RunCheck()
 {
   if (needs_update && character.IsAlive())
   {
+    PROFILE_ZONE("Level:Characters:FieldOfView");
+    CharacterList previously_detected  = GetDetectedCharacters();
+    bool          had_enemies_in_sight = HasEnemiesInSight();
+
     SetIntervalDurationFromStatistics();
     LoseTrackOfCharacters(detected_enemies);
     LoseTrackOfCharacters(detected_characters);
     DetectCharacters();
     needs_update = false;
+    EmitDetectionChanges(previously_detected);
+    if (HasEnemiesInSight() != had_enemies_in_sight)
+      EnemiesInSightChanged.Emit(!had_enemies_in_sight);
   }
 }
 
@@ -138,13 +147,13 @@ void FieldOfView::DetectCharacters()
     if (checking_character != &character)
     {
       if (character.IsAlly(checking_character) || !checking_character->IsAlive())
-        SetCharacterDetected(*checking_character);
+        InsertOrUpdateCharacterInList(*checking_character, detected_characters);
       else if (character.HasLineOfSight(checking_character) && CheckIfEnemyIsDetected(*checking_character))
       {
         if (character.IsEnemy(checking_character) && checking_character->IsAlive())
-          SetEnemyDetected(*checking_character);
+          InsertOrUpdateCharacterInList(*checking_character, detected_enemies);
         else
-          SetCharacterDetected(*checking_character);
+          InsertOrUpdateCharacterInList(*checking_character, detected_characters);
       }
     }
   }
@@ -169,20 +178,53 @@ bool FieldOfView::CheckIfSneakingEnemyIsDetected(const ObjectCharacter &enemy) c
 
     if (sneak_success_rate > 95)
       sneak_success_rate     = 95;
-    if (Dices::Throw(100) < sneak_success_rate)
+    if (Dices::Throw(100, Dices::Detection) < sneak_success_rate)
       return (false);
   }
   return (true);
 }
 
+/*
+ * Characters losing track of each other and being detected again during the same check (such as
+ * dead characters) don't cause any event.
+ */
+void FieldOfView::EmitDetectionChanges(CharacterList previously_detected)
+{
+  CharacterList detected = GetDetectedCharacters();
+  CharacterList changes;
+
+  // Characters can be in both lists
+  sort(previously_detected.begin(), previously_detected.end());
+  sort(detected.begin(), detected.end());
+  previously_detected.erase(unique(previously_detected.begin(), previously_detected.end()), previously_detected.end());
+  detected.erase(unique(detected.begin(), detected.end()), detected.end());
+  set_difference(previously_detected.begin(), previously_detected.end(), detected.begin(), detected.end(), back_inserter(changes));
+  ForEach(changes, [this](ObjectCharacter* lost_character) { CharacterLost.Emit(lost_character); });
+  changes.clear();
+  set_difference(detected.begin(), detected.end(), previously_detected.begin(), previously_detected.end(), back_inserter(changes));
+  ForEach(changes, [this](ObjectCharacter* detected_character) { CharacterDetected.Emit(detected_character); });
+}
+
 void FieldOfView::SetEnemyDetected(ObjectCharacter& enemy)
 {
-  InsertOrUpdateCharacterInList(enemy, detected_enemies);
+  SetDetectedInList(enemy, detected_enemies);
 }
 
 void FieldOfView::SetCharacterDetected(ObjectCharacter& character)
 {
-  InsertOrUpdateCharacterInList(character, detected_characters);
+  SetDetectedInList(character, detected_characters);
+}
+
+void FieldOfView::SetDetectedInList(ObjectCharacter& character, std::list<Entry>& list)
+{
+  bool was_detected         = IsCharacterInList(&character, detected_enemies) || IsCharacterInList(&character, detected_characters);
+  bool had_enemies_in_sight = HasEnemiesInSight();
+
+  InsertOrUpdateCharacterInList(character, list);
+  if (!was_detected)
+    CharacterDetected.Emit(&character);
+  if (!had_enemies_in_sight && HasEnemiesInSight())
+    EnemiesInSightChanged.Emit(true);
 }
 
 void FieldOfView::InsertOrUpdateCharacterInList(ObjectCharacter& character, std::list<Entry>& list)
@@ -205,10 +247,14 @@ float FieldOfView::GetRadius() const
   return (20 + (perception * 5));
 }
 
+// Uses the ranges gathered at the start of the frame when they are still valid
 Level::CharacterList FieldOfView::GetCharactersInRange() const
 {
-  float field_of_view_radius = GetRadius();
+  float         field_of_view_radius = GetRadius();
+  CharacterList characters_in_range;
 
+  if (level.GetCharacterRanges().Get(&character, characters_in_range))
+    return (characters_in_range);
   return (level.FindCharacters([this, field_of_view_radius](ObjectCharacter* character) -> bool
   {
       return (character != &this->character &&
@@ -9,42 +9,78 @@ using namespace std;
  */
 void TargetOutliner::UsePerspectiveOfCharacter(ObjectCharacter* subject)
 {
+  bool was_enabled = enabled;
+
+  DisableOutline();
   this->subject = subject;
-  if (outlines.size() > 0)
+  if (was_enabled)
     EnableOutline();
 }
 
+/*
+ * Outlines the characters detected by the subject, then follows the detection changes of its field of view
+ * until DisableOutline is called.
+ */
 void TargetOutliner::EnableOutline(void)
 {
-  FieldOfView& field_of_view = subject->GetFieldOfView();
+  if (enabled)
+    RemoveDeadOutlines();
+  else if (subject)
+  {
+    FieldOfView&                  field_of_view = subject->GetFieldOfView();
+    std::vector<ObjectCharacter*> detected      = field_of_view.GetDetectedCharacters();
 
-  DisableOutline();
-  MakeOutlinesForListWithColor(field_of_view.GetDetectedAllies(),     LVector4f(0, 255, 0, 0.5));
-  MakeOutlinesForListWithColor(field_of_view.GetDetectedEnemies(),    LVector4f(255, 0, 0, 0.5));
-  MakeOutlinesForListWithColor(field_of_view.GetDetectedNonHostile(), LVector4f(255, 0, 0, 0.5));
-  field_of_view.GetDetectedCharacters();
+    enabled = true;
+    ForEach(detected, [this](ObjectCharacter* character) { AddOutline(character); });
+    obs.Connect(field_of_view.CharacterDetected, *this, &TargetOutliner::AddOutline);
+    obs.Connect(field_of_view.CharacterLost,     *this, &TargetOutliner::RemoveOutline);
+  }
 }
 
 void TargetOutliner::DisableOutline(void)
 {
-  for_each(outlines.begin(), outlines.end(), [](Outline& outline) { outline.Finalize(); });
+  obs.DisconnectAll();
+  for_each(outlines.begin(), outlines.end(), [](std::pair<ObjectCharacter* const, Outline>& outline) { outline.second.Finalize(); });
   outlines.clear();
+  enabled = false;
 }
 
-void TargetOutliner::MakeOutlinesForListWithColor(const std::vector<ObjectCharacter*>& targets, LVector4f color)
+void TargetOutliner::AddOutline(ObjectCharacter* character)
 {
-  for_each(targets.begin(), targets.end(), [this, color](ObjectCharacter* character)
+  if (character->IsAlive() && outlines.find(character) == outlines.end())
   {
-    if (character->IsAlive())
-    {
-      Outline outline(character);
+    Outline outline(character);
+
+    outline.SetColor(subject->IsAlly(character) ? LVector4f(0, 255, 0, 0.5) : LVector4f(255, 0, 0, 0.5));
+    outline.Show();
+    outlines.insert(std::make_pair(character, outline));
+  }
+}
 
-      outline.SetColor(color);
-      outlines.push_back(outline);
-      outlines.rbegin()->Initialize();
-      outlines.rbegin()->Show();
+void TargetOutliner::RemoveOutline(ObjectCharacter* character)
+{
+  auto it = outlines.find(character);
+
+  if (it != outlines.end())
+  {
+    it->second.Finalize();
+    outlines.erase(it);
+  }
+}
+
+// Dead characters stay detected: their outline is only removed when the outline is refreshed
+void TargetOutliner::RemoveDeadOutlines(void)
+{
+  for (auto it = outlines.begin() ; it != outlines.end() ;)
+  {
+    if (it->first->IsAlive())
+      ++it;
+    else
+    {
+      it->second.Finalize();
+      outlines.erase(it++);
     }
-  });
+  }
 }
 
 /*
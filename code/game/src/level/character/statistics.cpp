@@ -128,12 +128,23 @@ void  CharacterStatistics::RefreshStatistics()
 
 short CharacterStatistics::GetMaxHitPoints(void) const
 {
-  return (controller->GetData()["Statistics"]["Hit Points"].Or(0));
+  return (controller->Model().GetMaxHp());
 }
 
 short CharacterStatistics::GetHitPoints(void) const
 {
-  return (controller->GetData()["Variables"]["Hit Points"].Or(GetMaxHitPoints()));
+  return (controller->Model().GetCurrentHp());
+}
+
+// Current value from the Variables, such as the remaining hit points, or the base value from the Statistics
+int CharacterStatistics::GetStatistic(const string& stat) const
+{
+  Data statistics = controller->GetData();
+  Data variable   = statistics["Variables"][stat];
+
+  if (variable.Nil())
+    return (statistics["Statistics"][stat].Or(0));
+  return (variable);
 }
 
 void CharacterStatistics::SetHitPoints(short value)
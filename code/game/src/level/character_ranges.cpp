@@ -0,0 +1,51 @@
+#include "level/character_ranges.hpp"
+#include <algorithm>
+
+using namespace std;
+
+void CharacterRanges::Add(ObjectCharacter* character, float x, float y, float radius)
+{
+  Entry entry;
+
+  entry.character = character;
+  entry.x         = x;
+  entry.y         = y;
+  entry.radius    = radius;
+  entries.push_back(entry);
+  computed        = false;
+}
+
+// Same test as FieldOfView::GetCharactersInRange: the distance on the ground plane is below the radius
+void CharacterRanges::Compute(void)
+{
+  for (auto self = entries.begin() ; self != entries.end() ; ++self)
+  {
+    float radius_squared = self->radius * self->radius;
+
+    self->in_range.clear();
+    for (auto other = entries.begin() ; other != entries.end() ; ++other)
+    {
+      float dist_x = other->x - self->x;
+      float dist_y = other->y - self->y;
+
+      if (other != self && dist_x * dist_x + dist_y * dist_y < radius_squared)
+        self->in_range.push_back(other->character);
+    }
+  }
+  computed = true;
+}
+
+bool CharacterRanges::Get(const ObjectCharacter* character, CharacterList& list) const
+{
+  if (computed)
+  {
+    auto it = find_if(entries.begin(), entries.end(), [character](const Entry& entry) { return (entry.character == character); });
+
+    if (it != entries.end())
+    {
+      list = it->in_range;
+      return (true);
+    }
+  }
+  return (false);
+}
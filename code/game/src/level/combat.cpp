@@ -1,34 +1,183 @@
 #include "level/combat.hpp"
 #include "level/level.hpp"
 #include "options.hpp"
+#include "logger.hpp"
+#include <algorithm>
 #define WORLDTIME_TURN          10
 
 using namespace std;
 
 ObjectCharacter* Combat::GetCurrentCharacter(void) const
 {
-  if (iterator != characters.end())
-    return (*iterator);
+  if (current < queue.size())
+    return (queue[current].character);
   return (0);
 }
 
+// The combat goes on as long as a living character who isn't an ally of the player has enemies in sight
 bool Combat::CanStop(void) const
 {
-  auto it  = characters.begin();
-  auto end = characters.end();
+  if (fighting_count[OtherSide] > 0)
+  {
+    LOG(Combat, Debug) << "Can't stop combat: " << fighting_count[OtherSide] << " characters have enemies in sight.";
+    return (false);
+  }
+  return (true);
+}
+
+/*
+ * Combatants
+ */
+// Fallout's Sequence: twice the perception, unless the statistics provide a Sequence
+short Combat::GetInitiative(ObjectCharacter* character)
+{
+  StatController* controller = character->GetStatController();
+
+  if (controller)
+  {
+    Data sequence = controller->GetData()["Statistics"]["Sequence"];
+
+    if (sequence.NotNil())
+      return (sequence);
+    return (controller->Model().GetSpecial("PER") * 2);
+  }
+  return (0);
+}
+
+void Combat::AddCombatant(ObjectCharacter* character)
+{
+  Combatant combatant;
+
+  combatant.character  = character;
+  combatant.initiative = GetInitiative(character);
+  combatant.side       = OtherSide;
+  combatant.fighting   = false;
+  queue.push_back(combatant);
+}
+
+// Characters with the same initiative keep the order in which they were inserted in the level
+void Combat::BuildQueue(void)
+{
+  Clear();
+  for_each(characters.begin(), characters.end(), [this](ObjectCharacter* character) { AddCombatant(character); });
+  stable_sort(queue.begin(), queue.end(), [](const Combatant& a, const Combatant& b) { return (a.initiative > b.initiative); });
+  for (unsigned int i = 0 ; i < queue.size() ; ++i)
+    WatchCombatant(i);
+}
+
+void Combat::WatchCombatant(unsigned int index)
+{
+  ObjectCharacter* character = queue[index].character;
+  ObjectCharacter* player    = level.GetPlayer();
+  FieldOfView&     fov       = character->GetFieldOfView();
+
+  queue[index].side = (player && character->IsAlly(player)) ? PlayerSide : OtherSide;
+  SetFighting(index, character->IsAlive() && fov.HasEnemiesInSight());
+  obs.Connect(fov.EnemiesInSightChanged, [this, index](bool in_sight)
+  {
+    SetFighting(index, in_sight && queue[index].character->IsAlive());
+  });
+  if (character->GetStatController())
+    obs.Connect(character->GetStatController()->Died, [this, index]() { SetFighting(index, false); });
+}
+
+void Combat::SetFighting(unsigned int index, bool fighting)
+{
+  Combatant& combatant = queue[index];
+
+  if (combatant.fighting != fighting)
+  {
+    combatant.fighting = fighting;
+    if (fighting)
+      fighting_count[combatant.side]++;
+    else
+      fighting_count[combatant.side]--;
+  }
+}
+
+unsigned int Combat::FindCombatant(const ObjectCharacter* character) const
+{
+  for (unsigned int i = 0 ; i < queue.size() ; ++i)
+  {
+    if (queue[i].character == character)
+      return (i);
+  }
+  return (queue.size());
+}
 
-  for (; it != end ; ++it)
+// The first combatant still in the level from index on, or queue.size()
+unsigned int Combat::NextCombatant(unsigned int index) const
+{
+  while (index < queue.size() && queue[index].character == 0)
+    ++index;
+  return (index);
+}
+
+// Characters joining the level during a fight play at the end of each round
+void Combat::AddCharacter(ObjectCharacter* character)
+{
+  if (!(queue.empty()))
   {
-    if ((*it)->IsAlive() && !((*it)->IsAlly(level.GetPlayer())))
+    AddCombatant(character);
+    WatchCombatant(queue.size() - 1);
+  }
+}
+
+void Combat::RemoveCharacter(ObjectCharacter* character)
+{
+  unsigned int index = FindCombatant(character);
+
+  if (index < queue.size())
+  {
+    SetFighting(index, false);
+    obs.DisconnectAllFrom(character->GetFieldOfView().EnemiesInSightChanged);
+    if (character->GetStatController())
+      obs.DisconnectAllFrom(character->GetStatController()->Died);
+    queue[index].character = 0;
+  }
+}
+
+// Forgets the combatants without ending the fight for the level (such as when the level is destroyed)
+void Combat::Clear(void)
+{
+  obs.DisconnectAll();
+  queue.clear();
+  current                    = 0;
+  fighting_count[PlayerSide] = fighting_count[OtherSide] = 0;
+}
+
+/*
+ * The weakest living enemy in sight of the character, the closest one when several enemies are as weak.
+ * Replaces the loop the scripts ran over GetCharactersInSight, which described every character in sight
+ * and sorted them by distance for a single pick.
+ */
+ObjectCharacter* Combat::SelectTarget(ObjectCharacter* character) const
+{
+  Level::CharacterList enemies           = character->GetFieldOfView().GetDetectedEnemies();
+  NodePath             render            = level.GetWindow()->get_render();
+  LPoint3              position          = character->GetNodePath().get_pos(render);
+  ObjectCharacter*     target            = 0;
+  short                target_hit_points = 0;
+  float                target_distance   = 0;
+
+  for (auto it = enemies.begin() ; it != enemies.end() ; ++it)
+  {
+    ObjectCharacter* enemy      = *it;
+    short            hit_points = enemy->GetHitPoints();
+
+    if (enemy != character && hit_points > 0)
     {
-      if (!((*it)->GetNearbyEnemies().empty()))
+      float distance = (enemy->GetNodePath().get_pos(render) - position).length();
+
+      if (target == 0 || hit_points < target_hit_points || (hit_points == target_hit_points && distance < target_distance))
       {
-        cout << "Can't stop combat: " << (*it)->GetName() << " has enemies in sight." << endl;
-        return (false);
+        target            = enemy;
+        target_hit_points = hit_points;
+        target_distance   = distance;
       }
     }
   }
-  return (true);
+  return (target);
 }
 
 void Combat::InitializeLevelForFight(void)
@@ -49,22 +198,20 @@ void Combat::FinalizeFightForLevel(void)
 
 void Combat::Start(ObjectCharacter* character)
 {
-  if (iterator == characters.end())
+  if (queue.empty() && find(characters.begin(), characters.end(), character) != characters.end())
   {
-    iterator = find(characters.begin(), characters.end(), character);
-    if (iterator != characters.end())
-    {
-      InitializeLevelForFight();
-      InitializeCharacterTurn(character);
-    }
+    BuildQueue();
+    current = FindCombatant(character);
+    InitializeLevelForFight();
+    InitializeCharacterTurn(character);
   }
 }
 
 void Combat::Stop(void)
 {
-  if (iterator != characters.end())
+  if (!(queue.empty()))
   {
-    iterator = characters.end();
+    Clear();
     FinalizeFightForLevel();
     for_each(characters.begin(), characters.end(), [this](ObjectCharacter* character)
     {
@@ -79,25 +226,23 @@ void Combat::NextTurn(void)
     Stop();
   else
   {
-    if (iterator != characters.end())
-      FinalizeCharacterTurn(*iterator);
-    iterator++;
-    if (iterator == characters.end())
+    if (GetCurrentCharacter())
+      FinalizeCharacterTurn(GetCurrentCharacter());
+    current = NextCombatant(current + 1);
+    if (current >= queue.size())
       FinalizeRound();
-    if (iterator != characters.end())
-      InitializeCharacterTurn(*iterator);
+    if (current < queue.size())
+      InitializeCharacterTurn(queue[current].character);
   }
 }
 
 void Combat::FinalizeRound(void)
 {
-  if (characters.begin() == iterator)
+  current = NextCombatant(0);
+  if (current >= queue.size())
     Stop();
   else
-  {
-    iterator = characters.begin();
     level.GetTimeManager().AddElapsedTime(WORLDTIME_TURN);
-  }
 }
 
 void Combat::FinalizeCharacterTurn(ObjectCharacter* character)
@@ -110,7 +255,7 @@ void Combat::FinalizeCharacterTurn(ObjectCharacter* character)
 
 void Combat::InitializeCharacterTurn(ObjectCharacter* character)
 {
-  cout << "Starting turn for character " << character->GetName() << endl;
+  LOG(Combat, Debug) << "Starting turn for character " << character->GetName();
   character->GetFieldOfView().RunCheck();
   character->RefreshActionPoints();
   RefreshScriptedTasks(character);
@@ -136,10 +281,10 @@ void Combat::RefreshScriptedTasks(ObjectCharacter* character)
 {
   const TaskSet& task_set = character->GetTaskSet();
 
-  cout << "Refreshing tasks for character " << character->GetName() << endl;
+  LOG(Combat, Debug) << "Refreshing tasks for character " << character->GetName();
   for_each(task_set.begin(), task_set.end(), [](pair<string, ScriptedTask*> task)
   {
-    cout << "Refreshing task " << task.first << endl;
+    LOG(Combat, Debug) << "Refreshing task " << task.first;
     task.second->NextTurn();
   });
 }
@@ -149,18 +294,19 @@ void Combat::FinishFightForCharacter(ObjectCharacter* character)
   character->RefreshActionPoints();
 }
 
+/*
+ * The current character is saved as its position in the level's characters: the queue is built again when loading.
+ */
 void Combat::Serialize(Utils::Packet& packet) const
 {
-  char has_combat_data = (iterator != characters.end() ? 1 : 0);
+  ObjectCharacter* current_character = GetCurrentCharacter();
+  char             has_combat_data   = (current_character != 0 ? 1 : 0);
 
   packet << has_combat_data;
   if (has_combat_data)
   {
-    unsigned int iterator_pos  = 0;
-    auto         iterator_comp = characters.begin();
-    
-    for (; iterator_comp != iterator ; ++iterator_comp)
-      iterator_pos++;
+    unsigned int iterator_pos = distance(characters.begin(), find(characters.begin(), characters.end(), current_character));
+
     packet << iterator_pos;
   }
 }
@@ -173,10 +319,12 @@ void Combat::Unserialize(Utils::Packet& packet)
   if (has_combat_data)
   {
     unsigned int iterator_pos;
+    auto         iterator = characters.begin();
     
     packet >> iterator_pos;
-    iterator = characters.begin();
     std::advance(iterator, iterator_pos);
+    BuildQueue();
+    current = (iterator != characters.end() ? FindCombatant(*iterator) : NextCombatant(0));
     InitializeLevelForFight();
   }
 }
@@ -0,0 +1,335 @@
+#include "level/delta_save.hpp"
+#include <zlib.h>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+
+using namespace std;
+
+static const unsigned int delta_revision = 1;
+
+static unsigned int Checksum(const char* data, size_t size)
+{
+  return (crc32(crc32(0, Z_NULL, 0), reinterpret_cast<const Bytef*>(data), size));
+}
+
+static void SerializeRange(Utils::Packet& packet, unsigned int offset, unsigned int length, unsigned int crc)
+{
+  packet << offset << length << crc;
+}
+
+DeltaSave::DeltaSave(void)
+{
+  Clear();
+}
+
+void DeltaSave::Clear(void)
+{
+  has_snapshot   = false;
+  snapshot_size  = snapshot_crc = 0;
+  deltas_written = 0;
+  layout         = Layout();
+  for (unsigned int i = 0 ; i < 2 ; ++i)
+  {
+    changes[i].clear();
+    order[i].clear();
+  }
+  state.clear();
+  combat.clear();
+}
+
+string DeltaSave::Body(const Utils::Packet& packet)
+{
+  const size_t header_size = Utils::Packet().size();
+
+  return (string(packet.raw() + header_size, packet.size() - header_size));
+}
+
+/*
+ * Loading
+ */
+bool DeltaSave::Load(const string& snapshot, const string& delta)
+{
+  Clear();
+  if (delta.size() == 0)
+    return (false);
+  try
+  {
+    Utils::Packet packet(delta.c_str(), delta.size());
+    unsigned int  revision, size, crc;
+
+    packet >> revision >> size >> crc;
+    if (revision != delta_revision || size != snapshot.size() || crc != Checksum(snapshot.c_str(), snapshot.size()))
+    {
+      cerr << "[DeltaSave] Delta doesn't match the level snapshot: it will be ignored." << endl;
+      return (false);
+    }
+    snapshot_size = size;
+    snapshot_crc  = crc;
+    packet >> deltas_written;
+    packet >> layout.head.offset >> layout.head.length >> layout.head.crc;
+    packet >> layout.tail.offset >> layout.tail.length >> layout.tail.crc;
+    for (unsigned int type = 0 ; type < 2 ; ++type)
+    {
+      unsigned int count;
+
+      packet >> count;
+      for (unsigned int i = 0 ; i < count ; ++i)
+      {
+        string name;
+        Range  range;
+
+        packet >> name >> range.offset >> range.length >> range.crc;
+        layout.index[type][name] = range;
+      }
+      packet >> order[type];
+      packet >> count;
+      for (unsigned int i = 0 ; i < count ; ++i)
+      {
+        string name, bytes;
+
+        packet >> name >> bytes;
+        changes[type][name] = bytes;
+      }
+    }
+    packet >> state >> combat;
+    has_snapshot = true;
+  }
+  catch (const Utils::Packet::Exception& exception)
+  {
+    cerr << "[DeltaSave] Corrupted delta: " << exception.what() << endl;
+    Clear();
+  }
+  return (has_snapshot);
+}
+
+string DeltaSave::Rebuild(const string& snapshot) const
+{
+  const Range& head = layout.head;
+  const Range& tail = layout.tail;
+
+  if (!has_snapshot)
+    return (snapshot);
+  if (head.offset + head.length > snapshot.size() || tail.offset + tail.length > snapshot.size())
+    throw std::runtime_error("level delta refers to data outside of its snapshot");
+  return (Assemble(Bytes(snapshot.c_str() + head.offset, head.length),
+                   Bytes(snapshot.c_str() + tail.offset, tail.length),
+                   snapshot, 0));
+}
+
+DeltaSave::Bytes DeltaSave::Find(const string& snapshot, RecordType type, const string& name) const
+{
+  auto change = changes[type].find(name);
+
+  if (change != changes[type].end())
+    return (Bytes(change->second.c_str(), change->second.size()));
+  {
+    auto range = layout.index[type].find(name);
+
+    if (range == layout.index[type].end() || range->second.offset + range->second.length > snapshot.size())
+      throw std::runtime_error("level delta refers to a missing record: " + name);
+    return (Bytes(snapshot.c_str() + range->second.offset, range->second.length));
+  }
+}
+
+/*
+ * Lays out the records the way Level::Serialize would: world head, dynamic objects, world tail,
+ * level state, instances, combat. Packet values don't depend on their position, so records are copied as is.
+ */
+string DeltaSave::Assemble(Bytes head, Bytes tail, const string& snapshot, Layout* new_layout) const
+{
+  Utils::Packet empty;
+  string        blob(empty.raw(), empty.size());
+  auto          append = [&blob](Bytes bytes) -> Range
+  {
+    Range range;
+
+    range.offset = blob.size();
+    range.length = bytes.second;
+    range.crc    = Checksum(bytes.first, bytes.second);
+    blob.append(bytes.first, bytes.second);
+    return (range);
+  };
+
+  blob.reserve(snapshot.size() + ChangesSize());
+  if (new_layout)
+    new_layout->head = append(head);
+  else
+    blob.append(head.first, head.second);
+  {
+    char         type_code = Utils::Packet::Array;
+    std::int32_t count     = order[WorldRecord].size();
+
+    blob.append(&type_code, sizeof(type_code));
+    blob.append(reinterpret_cast<const char*>(&count), sizeof(count));
+  }
+  for (unsigned int type = 0 ; type < 2 ; ++type)
+  {
+    for (auto name = order[type].begin() ; name != order[type].end() ; ++name)
+    {
+      Bytes bytes = Find(snapshot, (RecordType)type, *name);
+
+      if (new_layout)
+        new_layout->index[type][*name] = append(bytes);
+      else
+        blob.append(bytes.first, bytes.second);
+    }
+    if (type == WorldRecord)
+    {
+      if (new_layout)
+        new_layout->tail = append(tail);
+      else
+        blob.append(tail.first, tail.second);
+      blob.append(state);
+    }
+  }
+  blob.append(combat);
+  {
+    std::int32_t size = blob.size();
+
+    memcpy(&blob[0], &size, sizeof(size)); // same as Packet::updateHeader
+  }
+  return (blob);
+}
+
+/*
+ * Saving
+ */
+bool DeltaSave::SetOrder(const vector<string>& world_order, const vector<string>& instance_order)
+{
+  order[WorldRecord]    = world_order;
+  order[InstanceRecord] = instance_order;
+  for (unsigned int type = 0 ; type < 2 ; ++type)
+  {
+    set<string> names(order[type].begin(), order[type].end());
+
+    if (names.size() != order[type].size())
+      return (false);
+  }
+  return (true);
+}
+
+size_t DeltaSave::ChangesSize(void) const
+{
+  size_t size = state.size() + combat.size();
+
+  for (unsigned int type = 0 ; type < 2 ; ++type)
+  {
+    for (auto it = changes[type].begin() ; it != changes[type].end() ; ++it)
+      size += it->second.size();
+  }
+  return (size);
+}
+
+bool DeltaSave::NeedsSnapshot(void) const
+{
+  return (!has_snapshot || deltas_written >= max_deltas || ChangesSize() > snapshot_size / 2);
+}
+
+// The head and tail have no records: when they changed, only a new snapshot can save them
+bool DeltaSave::MatchesSnapshot(const Utils::Packet& head, const Utils::Packet& tail) const
+{
+  const string head_bytes = Body(head);
+  const string tail_bytes = Body(tail);
+
+  return (has_snapshot &&
+          layout.head.length == head_bytes.size() && layout.head.crc == Checksum(head_bytes.c_str(), head_bytes.size()) &&
+          layout.tail.length == tail_bytes.size() && layout.tail.crc == Checksum(tail_bytes.c_str(), tail_bytes.size()));
+}
+
+void DeltaSave::BeginSnapshot(void)
+{
+  vector<string> world_order    = order[WorldRecord];
+  vector<string> instance_order = order[InstanceRecord];
+
+  Clear();
+  order[WorldRecord]    = world_order;
+  order[InstanceRecord] = instance_order;
+}
+
+bool DeltaSave::HasRecord(RecordType type, const string& name) const
+{
+  return (changes[type].count(name) > 0 || (has_snapshot && layout.index[type].count(name) > 0));
+}
+
+void DeltaSave::SetRecord(RecordType type, const string& name, const Utils::Packet& packet)
+{
+  string bytes = Body(packet);
+
+  if (has_snapshot)
+  {
+    auto range = layout.index[type].find(name);
+
+    // A record back to its snapshot state doesn't need to be in the delta anymore
+    if (range != layout.index[type].end() && range->second.length == bytes.size() &&
+        range->second.crc == Checksum(bytes.c_str(), bytes.size()))
+    {
+      changes[type].erase(name);
+      return ;
+    }
+  }
+  changes[type][name] = bytes;
+}
+
+void DeltaSave::SetLevelState(const Utils::Packet& state, const Utils::Packet& combat)
+{
+  this->state  = Body(state);
+  this->combat = Body(combat);
+}
+
+string DeltaSave::WriteSnapshot(const Utils::Packet& head, const Utils::Packet& tail)
+{
+  const string head_bytes = Body(head);
+  const string tail_bytes = Body(tail);
+  Layout       new_layout;
+  string       blob;
+
+  blob = Assemble(Bytes(head_bytes.c_str(), head_bytes.size()),
+                  Bytes(tail_bytes.c_str(), tail_bytes.size()),
+                  "", &new_layout);
+  layout         = new_layout;
+  changes[WorldRecord].clear();
+  changes[InstanceRecord].clear();
+  snapshot_size  = blob.size();
+  snapshot_crc   = Checksum(blob.c_str(), blob.size());
+  deltas_written = 0;
+  has_snapshot   = true;
+  return (blob);
+}
+
+string DeltaSave::WriteDelta(void)
+{
+  Utils::Packet packet;
+
+  packet << delta_revision << snapshot_size << snapshot_crc << (deltas_written + 1);
+  SerializeRange(packet, layout.head.offset, layout.head.length, layout.head.crc);
+  SerializeRange(packet, layout.tail.offset, layout.tail.length, layout.tail.crc);
+  for (unsigned int type = 0 ; type < 2 ; ++type)
+  {
+    set<string>  names(order[type].begin(), order[type].end());
+    unsigned int count = layout.index[type].size();
+
+    packet << count;
+    for (auto it = layout.index[type].begin() ; it != layout.index[type].end() ; ++it)
+    {
+      packet << it->first;
+      SerializeRange(packet, it->second.offset, it->second.length, it->second.crc);
+    }
+    packet << order[type];
+    // Objects which left the level don't need their records anymore
+    for (auto it = changes[type].begin() ; it != changes[type].end() ;)
+    {
+      if (names.count(it->first) == 0)
+        changes[type].erase(it++);
+      else
+        ++it;
+    }
+    count = changes[type].size();
+    packet << count;
+    for (auto it = changes[type].begin() ; it != changes[type].end() ; ++it)
+      packet << it->first << it->second;
+  }
+  packet << state << combat;
+  deltas_written++;
+  return (string(packet.raw(), packet.size()));
+}
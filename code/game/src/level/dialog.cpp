@@ -59,7 +59,7 @@ void DialogView::Destroy()
 
 void DialogView::SetCurrentNpcText(const string& message)
 {
-  _containerNpcLine->SetInnerRML(message.c_str());
+  Rocket::ParseInnerRML(_containerNpcLine, message.c_str());
 }
 
 void DialogView::UpdateView(const std::string& npcLine, const DialogAnswers& answers)
@@ -76,8 +76,8 @@ void DialogView::UpdateView(const std::string& npcLine, const DialogAnswers& ans
     });
     std::cout << "RML -> " << npcLine << std::endl;
     std::cout << "RML -> " << answersRml << std::endl;
-    _containerNpcLine->SetInnerRML(npcLine.c_str());
-    _containerAnswers->SetInnerRML(answersRml.c_str());
+    Rocket::ParseInnerRML(_containerNpcLine, npcLine.c_str());
+    Rocket::ParseInnerRML(_containerAnswers, answersRml.c_str());
     std::for_each(answers.answers.begin(), answers.answers.end(), [this](DialogAnswers::KeyValue data)
     {
       Core::Element* element;
@@ -1,4 +1,5 @@
 #include "level/diplomacy.hpp"
+#include "logger.hpp"
 #include <algorithm>
 
 using namespace std;
@@ -16,8 +17,8 @@ void WorldDiplomacy::Initialize(void)
   Data factions = _data_engine["Factions"];
 
   factions.Output();
-  _next_flag = 1;
   _factions.clear();
+  _faction_ids.clear();
   for_each(factions.begin(), factions.end(), [this](Data faction)
   { AddFaction(faction.Key()); });
   for_each(factions.begin(), factions.end(), [this](Data faction)
@@ -35,7 +36,8 @@ void WorldDiplomacy::Initialize(void)
 	  Data _faction = faction;
       for_each(array.begin(), array.end(), [__this, _faction](Data enemy)
       {
-        __this->SetAsEnemy(enemy.Value() == "1", enemy.Key(), _faction.Key()); cout << _faction.Key() << " enemies with " << enemy.Value() << endl;
+        __this->SetAsEnemy(enemy.Value() == "1", enemy.Key(), _faction.Key());
+        LOG(General, Debug) << _faction.Key() << " enemies with " << enemy.Key() << ": " << enemy.Value();
       });
     });
   });
@@ -45,65 +47,54 @@ void WorldDiplomacy::AddFaction(const string& name)
 {
   Faction faction;
 
-  faction.flag      = _next_flag;
-  faction.name      = name;
-  faction.enemyMask = 0;
-  _next_flag       *= 2;
+  if (_faction_ids.find(name) != _faction_ids.end())
+    return ;
+  faction.id   = _factions.size();
+  faction.name = name;
   _factions.push_back(faction);
+  _faction_ids[name] = faction.id;
 }
 
 WorldDiplomacy::Faction* WorldDiplomacy::GetFaction(const string& name)
 {
-  auto it = find(_factions.begin(), _factions.end(), name);
+  auto it = _faction_ids.find(name);
 
-  if (it != _factions.end())
-    return (&(*it));
+  if (it != _faction_ids.end())
+    return (&_factions[it->second]);
   return (0);
 }
 
-WorldDiplomacy::Faction* WorldDiplomacy::GetFaction(unsigned int flag)
+WorldDiplomacy::Faction* WorldDiplomacy::GetFaction(unsigned int id)
 {
-  auto it = find(_factions.begin(), _factions.end(), flag);
-
-  if (it != _factions.end())
-    return (&(*it));
+  if (id < _factions.size())
+    return (&_factions[id]);
   return (0);
 }
 
 void WorldDiplomacy::SetAsEnemy(bool set, const string& name1, const string& name2)
 {
-  auto it_first  = find(_factions.begin(), _factions.end(), name1);
-  auto it_second = find(_factions.begin(), _factions.end(), name2);
+  Faction* first  = GetFaction(name1);
+  Faction* second = GetFaction(name2);
 
-  if (it_first != _factions.end() && it_second != _factions.end())
-  {  SetAsEnemy(set, *it_first, *it_second); }
+  if (first && second)
+    SetAsEnemy(set, *first, *second);
 }
 
-void WorldDiplomacy::SetAsEnemy(bool set, unsigned int flag_1, unsigned int flag_2)
+void WorldDiplomacy::SetAsEnemy(bool set, unsigned int id_1, unsigned int id_2)
 {
-  auto it_first  = find(_factions.begin(), _factions.end(), flag_1);
-  auto it_second = find(_factions.begin(), _factions.end(), flag_2);
+  Faction* first  = GetFaction(id_1);
+  Faction* second = GetFaction(id_2);
 
-  if (it_first != _factions.end() && it_second != _factions.end())
-  {  SetAsEnemy(set, *it_first, *it_second); }
+  if (first && second)
+    SetAsEnemy(set, *first, *second);
 }
 
 void WorldDiplomacy::SetAsEnemy(bool set, Faction& first, Faction& second)
 {
   Data factions = _data_engine["Factions"];
 
-  if (set)
-  {
-    first.enemyMask  |= second.flag;
-    second.enemyMask |= first.flag;
-  }
-  else
-  {
-    if (first.enemyMask & second.flag)
-      first.enemyMask -= second.flag;
-    if (second.enemyMask & first.flag)
-      second.enemyMask -= first.flag;
-  }
+  first.enemies.Set(second.id, set);
+  second.enemies.Set(first.id, set);
   factions[first.name]["Enemies"][second.name] = (set ? 1 : 0);
   factions[second.name]["Enemies"][first.name] = (set ? 1 : 0);
 }
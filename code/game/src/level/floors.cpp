@@ -1,6 +1,7 @@
 #include "level/floors.hpp"
 #include "level/objects/instance_dynamic_object.hpp"
 #include "level/level.hpp"
+#include "logger.hpp"
 
 using namespace std;
 
@@ -43,7 +44,7 @@ void Floors::SetCurrentFloor(unsigned char floor)
   unsigned char floorAbove       = floor + 1;
   bool          isInsideBuilding = IsInsideBuilding(floorAbove);
 
-  cout << "Floor above: " << (int)floorAbove << endl;
+  LOG(Map, Debug) << "Floor above: " << (int)floorAbove;
   if (floorAbove < floor)
     ShowOnlyFloor(floor);
   else
@@ -77,13 +78,22 @@ void Floors::FadeFloor(NodePath floor, bool fade_in)
   hiding_floors.push_back(hiding_floor);
 }
 
-void Floors::RunFadingEffect(float elapsed_time)
+/*
+ * Fading is split in two so that the alphas can be computed by any thread: ComputeFadingEffect only
+ * touches the alpha of each hiding floor, ApplyFadingEffect writes them to the scene graph.
+ */
+void Floors::ComputeFadingEffect(float elapsed_time)
+{
+  ForEach(hiding_floors, [elapsed_time](HidingFloor& floor) { floor.Run(elapsed_time); });
+}
+
+void Floors::ApplyFadingEffect(void)
 {
   std::list<HidingFloor>::iterator cur, end;
 
   for (cur = hiding_floors.begin(), end = hiding_floors.end() ; cur != end ;)
   {
-    cur->Run(elapsed_time);
+    cur->Apply();
     if (cur->Done())
       cur = hiding_floors.erase(cur);
     else
@@ -109,6 +119,10 @@ void Floors::HidingFloor::Run(float elapsedTime)
 {
   alpha += (fadingIn ? -0.1f : 0.1f) * (elapsedTime * 10);
   done   = (fadingIn ? alpha <= 0.f : alpha >= 1.f);
+}
+
+void Floors::HidingFloor::Apply(void)
+{
   floor.set_alpha_scale(alpha);
   if (fadingIn && done)
     floor.hide();
@@ -0,0 +1,98 @@
+#include "level/frame_phases.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+
+using namespace std;
+
+void FramePhases::Add(const string& name, Affinity affinity, Callback callback, const vector<string>& dependencies)
+{
+  Phase phase;
+
+  phase.name     = name;
+  phase.affinity = affinity;
+  phase.callback = callback;
+  phase.step     = 0;
+  phase.duration = 0;
+  phase.zone     = Profiler::Intern("Level:Phase:" + name);
+  for (auto dependency = dependencies.begin() ; dependency != dependencies.end() ; ++dependency)
+  {
+    auto it = find_if(phases.begin(), phases.end(), [dependency](const Phase& phase) { return (phase.name == *dependency); });
+
+    if (it == phases.end())
+    {
+      cerr << "[FramePhases] Phase '" << name << "' depends on unknown phase '" << *dependency << '\'' << endl;
+      continue ;
+    }
+    phase.step = max(phase.step, it->step + 1);
+  }
+  if (phase.step >= steps.size())
+    steps.resize(phase.step + 1);
+  steps[phase.step].push_back(phases.size());
+  phases.push_back(phase);
+}
+
+/*
+ * Each phase only writes its own duration: the phases of a same step may be timed from different threads.
+ */
+void FramePhases::RunPhase(Phase& phase, float elapsed_time)
+{
+  PROFILE_DYNAMIC_ZONE(phase.zone);
+  auto start = std::chrono::steady_clock::now();
+
+  try
+  {
+    phase.callback(elapsed_time);
+  }
+  catch (...)
+  {
+    phase.duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    throw ;
+  }
+  phase.duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void FramePhases::Run(float elapsed_time)
+{
+  if (!parallel)
+  {
+    // Phases are always added after their dependencies: declaration order is a valid serial order.
+    for (auto it = phases.begin() ; it != phases.end() ; ++it)
+      RunPhase(*it, elapsed_time);
+    return ;
+  }
+  for (auto step = steps.begin() ; step != steps.end() ; ++step)
+  {
+    Sync::JobGroup group;
+
+    for (auto it = step->begin() ; it != step->end() ; ++it)
+    {
+      Phase& phase = phases[*it];
+
+      if (phase.affinity == AnyThread)
+      {
+        Phase* job_phase = &phase;
+
+        jobs.Push(group, [job_phase, elapsed_time]() { RunPhase(*job_phase, elapsed_time); });
+      }
+    }
+    try
+    {
+      for (auto it = step->begin() ; it != step->end() ; ++it)
+      {
+        Phase& phase = phases[*it];
+
+        if (phase.affinity == MainThread)
+          RunPhase(phase, elapsed_time);
+      }
+    }
+    catch (...)
+    {
+      // The jobs still reference the group: they must be done before the exception leaves the step.
+      try { jobs.Wait(group); } catch (...) {}
+      throw ;
+    }
+    jobs.Wait(group);
+  }
+}
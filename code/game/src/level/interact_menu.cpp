@@ -43,7 +43,7 @@ InteractMenu::InteractMenu(WindowFramework* window, Rocket::Core::Context* conte
           rml << "</button></div>";
         });
 
-        element->SetInnerRML(rml.str().c_str());
+        Rocket::ParseInnerRML(element, rml.str().c_str());
       }
 
       int it = 0;
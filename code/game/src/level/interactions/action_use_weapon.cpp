@@ -2,6 +2,7 @@
 #include "level/objects/character.hpp"
 #include "level/level.hpp"
 #include "dices.hpp"
+#include "logger.hpp"
 
 using namespace std;
 using namespace Interactions;
@@ -10,14 +11,14 @@ void Actions::UseWeaponOn::Run()
 {
   if (CheckAndRemoveActionPoints())
   {
-    cout << "Use weapon play animation" << endl;
+    LOG(Interactions, Debug) << "Use weapon play animation";
     PlayAnimation();
   }
 }
 
 void Actions::UseWeaponOn::PlayAnimation()
 {
-  cout << "Use weapon, play animation" << endl;
+  LOG(Interactions, Debug) << "Use weapon, play animation";
   ObjectCharacter* user = GetUser();
 
   user->LookAt(GetObjectTarget());
@@ -55,9 +56,9 @@ void Actions::UseWeaponOn::ApplyEffect()
 void Actions::UseWeaponOn::RunAction()
 {
   ObjectCharacter* target = GetObjectTarget()->Get<ObjectCharacter>();
-  int              score  = Dices::Throw(100);
+  int              score  = Dices::Throw(100, Dices::Combat);
 
-  cout << "Use weapon, play action" << endl;
+  LOG(Interactions, Debug) << "Use weapon, play action";
   hit_success = weapon->HitSuccessRate(GetUser(), target, action_it) >= score;
   if (HasProjectile())
     FireProjectile();
@@ -67,7 +68,7 @@ void Actions::UseWeaponOn::RunAction()
 
 void Actions::UseWeaponOn::TargetDied(ObjectCharacter* target)
 {
-  cout << "Target died" << endl;
+  LOG(Interactions, Debug) << "Target died";
   StatController* controller = GetUser()->GetStatController();
   Data            stats      = target->GetStatistics();
   Data            xp_reward  = stats["Variable"]["XpReward"];
@@ -80,7 +81,7 @@ void Actions::UseWeaponOn::TargetDied(ObjectCharacter* target)
     controller->AddKill(race);
   }
   enemy_died = true;
-  cout << "/Target Died" << endl;
+  LOG(Interactions, Debug) << "/Target Died";
 }
 
 void Actions::UseWeaponOn::TargetAnimate()
@@ -102,7 +103,7 @@ void Actions::UseWeaponOn::TargetAnimate()
 
 void Actions::UseWeaponOn::FireProjectile()
 {
-  cout << "FIRING PROJECTILE!" << endl;
+  LOG(Interactions, Debug) << "FIRING PROJECTILE!";
   Data                   projectile_data = action["animations"]["projectile"];
   NodePath               destination, weapon_node;
   InstanceDynamicObject* target = GetObjectTarget();
@@ -151,7 +152,7 @@ Actions::UseWeaponOn::UseWeaponOn(ObjectCharacter* user, ObjectCharacter* target
 
 ActionRunner* Actions::UseWeaponOn::Factory(ObjectCharacter* user, ObjectCharacter* target, InventoryObject* item, unsigned char action_it)
 {
-  cout << "Use weapon, factory" << endl;
+  LOG(Interactions, Debug) << "Use weapon, factory";
   UseWeaponOn* runner = 0;
   
   if (user == target)
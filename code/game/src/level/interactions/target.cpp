@@ -1,5 +1,6 @@
 #include "level/interactions/target.hpp"
 #include "level/level.hpp"
+#include "logger.hpp"
 
 using namespace std;
 
@@ -33,10 +34,10 @@ void Interactions::Target::ActionLookAt(InstanceDynamicObject* user)
       AngelScript::Type<ObjectCharacter*>       param_player(user->Get<ObjectCharacter>());
 
       script_success = script->Call("LookAt", 2, &param_self, &param_player);
-      cout << "Runned script returned " << script_success << endl;
+      LOG(Interactions, Debug) << "Runned script returned " << script_success;
     }
     else
-      cout << "Cant run script" << endl;
+      LOG(Interactions, Warning) << "Cant run script";
     if (!script_success)
     {
       const InstanceDynamicObject* self = static_cast<const InstanceDynamicObject*>(this);
@@ -51,7 +52,7 @@ void Interactions::Target::ActionLookAt(InstanceDynamicObject* user)
 
 void Interactions::Target::ActionUse(InstanceDynamicObject* user)
 {
-  cout << "ActionUse instancedynamicobject" << endl;
+  LOG(Interactions, Debug) << "ActionUse instancedynamicobject";
   if (script && script->IsDefined("Use"))
   {
     AngelScript::Type<InstanceDynamicObject*> param_self(static_cast<InstanceDynamicObject*>(this));
@@ -74,14 +75,14 @@ bool Interactions::Target::TryToStartConversation(ObjectCharacter* user)
     AngelScript::Type<ObjectCharacter*>       param_player(user);
 
     open_dialog = (bool)(script->Call("TalkTo", 2, &param_self, &param_player)) && open_dialog;
-    cout << "open_dialog: " << open_dialog << endl;
+    LOG(Interactions, Debug) << "open_dialog: " << open_dialog;
   }
   return (open_dialog);
 }
 
 void Interactions::Target::ActionTalkTo(ObjectCharacter* user)
 {
-  cout << "ActionTalkTo" << endl;
+  LOG(Interactions, Debug) << "ActionTalkTo";
   if (TryToStartConversation(user))
     Level::CurrentLevel->GetLevelUi().OpenUiDialog(static_cast<InstanceDynamicObject*>(this));
   else
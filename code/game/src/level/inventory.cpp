@@ -9,79 +9,85 @@
 
 using namespace std;
 
-InventoryObject::InventoryObject(Data data) : Data(&_dataTree), _object("scripts/objects/" + data["script"]["file"].Value())
+/*
+ * Items made out of their item index entry, possibly with values it already has (such as items saved
+ * untouched), use the definition of their template. Others get their own definition, and their own
+ * template when their script or actions differ.
+ */
+InventoryObject::InventoryObject(Data data) : _template(ItemTemplate::Require(data.Key())), _own_template(0)
 {
-  if (data["icon"].Nil() && GameTask::CurrentGameTask)
+  if (_template && _template->Matches(data))
+    Bind(_template->GetDefinitionTree());
+  else
   {
-    Data items = GameTask::CurrentGameTask->GetItemIndex();
-    if (items[data.Key()].NotNil())
-      Duplicate(items[data.Key()]);
-    _object.LoadFromFile("scripts/objects/" + (*this)["script"]["file"].Value());
+    Bind(&_dataTree);
+    ItemTemplate::MakeDefinition(data, *this);
+    if (!_template || !(_template->HasSameScript(*this)))
+      _template = _own_template = new ItemTemplate(*this);
   }
-  Duplicate(data);
+  _equiped = (*this)["equiped"].NotNil();
+}
 
-  // Set the default values
-  (*this)["weight"]   = (data["weight"].Nil()) ? "0" : data["weight"].Value();
-  (*this)["interactions"]["use"] = "1";
-  
-  if (data["mode-mouth"].Nil())
-    (*this)["mode-mouth"] = "1";
-  if (data["mode-magic"].Nil())
-    (*this)["mode-magic"] = "1";
+InventoryObject::InventoryObject(ItemTemplate* item_template) : _template(item_template), _own_template(0)
+{
+  Bind(_template->GetDefinitionTree());
+  _equiped = false;
+}
 
-  _equiped = (*this)["equiped"].NotNil();
+InventoryObject::~InventoryObject()
+{
+  cout << "Destroying InventoryObject" << endl;
+  Bind(0); // _dataTree is destroyed before Data
+  if (_own_template)
+    delete _own_template;
+}
 
-  Data script = (*this)["script"];
+void InventoryObject::Bind(DataBranch* branch)
+{
+  if (_data && _data->pointers > 0)
+    _data->pointers--;
+  _data = branch;
+  if (_data)
+    _data->pointers++;
+}
 
-  if (!(script.Nil()))
+/*
+ * Copy-on-write: must be called before writing in the item's data.
+ */
+void InventoryObject::MakeUnique(void)
+{
+  if (!(IsUnique()))
   {
-    if (script["file"].Value() != "")
-    {
-      _object.asDefineMethod("CanWeild", "bool CanWeild(Item@, Character@, string, int)");
-      _object.asDefineMethod("SetEquiped", "void SetEquiped(Item@, Character@, string, int, string, bool)");
-    }
+    Data(&_dataTree).Duplicate(*this);
+    Bind(&_dataTree);
   }
-
-  std::for_each((*this)["actions"].begin(), (*this)["actions"].end(), [this](Data action)
-  {
-    AngelScript::Object     hooks(this->_object.GetContext(), this->_object.GetModule());
-    Data                    action_data  = (*this)["actions"][action.Key()];
-    function<bool (string)> sanity_check = [&action](string name) -> bool { return (action[name].NotNil() && action[name].Value() != ""); };
-
-    action_data.Duplicate(action);
-    if (action_data["targeted"].Nil())
-      action_data["targeted"] = 1;
-    if (sanity_check("hookUse"))
-      hooks.asDefineMethod("Use",             "bool " + action["hookUse"].Value() + "(Item@, Character@)");
-    if (sanity_check("hookCharacters"))
-      hooks.asDefineMethod("UseOnCharacter",  "bool " + action["hookCharacters"].Value() + "(Item@, Character@, Character@)");
-    if (sanity_check("hookDoors"))
-      hooks.asDefineMethod("UseOnDoor",       "bool " + action["hookDoors"].Value() + "(Item@, Character@, Door@)");
-    if (sanity_check("hookOthers"))
-      hooks.asDefineMethod("UseOnOthers",     "bool " + action["hookOthers"].Value() + "(Item@, Character@, DynamicObject@)");
-    if (sanity_check("hookWeapon"))
-      hooks.asDefineMethod("UseAsWeapon",     "bool " + action["hookWeapon"].Value() + "(Item@, Character@, Character@)");
-    if (sanity_check("hookHitChances"))
-      hooks.asDefineMethod("HitChances",      "int " + action["hookHitChances"].Value() + "(Item@, Character@, Character@)");
-    if (sanity_check("hookCanUse"))
-      hooks.asDefineMethod("CanUse",          "bool " + action["hookCanUse"].Value() + "(Item@, Character@, DynamicObject@)");
-    if (sanity_check("hookActionPoints"))
-      hooks.asDefineMethod("ActionPointCost", "int " + action["hookActionPoints"].Value() + "(Item@, Character@, DynamicObject@)");
-    if (sanity_check("hookSplashEffect"))
-      hooks.asDefineMethod("SplashEffect",    "void " + action["hookSplashEffect"].Value() + "(Item@, Character@, float, float, float)");
-    _actionHooks.push_back(hooks);
-  });
 }
 
-InventoryObject::~InventoryObject()
+/*
+ * Dropped items and shop inventories are stored as JSON: those matching their template are not parsed again.
+ */
+InventoryObject* InventoryObject::FromJSON(const std::string& name, const std::string& json)
 {
-  cout << "Destroying InventoryObject" << endl;
+  ItemTemplate*    item_template = ItemTemplate::Require(name);
+  InventoryObject* item;
+
+  if (item_template && item_template->GetJSON() == json)
+    return (new InventoryObject(item_template));
+  {
+    DataTree* item_data = DataTree::Factory::StringJSON(json);
+
+    item_data->key = name;
+    item           = new InventoryObject(item_data);
+    delete item_data;
+  }
+  return (item);
 }
 
 void InventoryObject::ResetFromFixture(void)
 {
   DataTree* objects = DataTree::Factory::JSON("data/objects.json");
 
+  MakeUnique();
   if (objects)
   {
     {
@@ -123,7 +129,7 @@ bool InventoryObject::IsWeapon(void) const
 
 void InventoryObject::SetEquiped(ObjectCharacter* character, bool set, std::string slot, unsigned short mode, std::string joint)
 {
-  if (_equiped != set && _object.IsDefined("SetEquiped"))
+  if (_equiped != set && _template->GetScript().IsDefined("SetEquiped"))
   {
     AngelScript::Type<InventoryObject*> this_param(this);
     AngelScript::Type<ObjectCharacter*> character_param(character);
@@ -132,21 +138,21 @@ void InventoryObject::SetEquiped(ObjectCharacter* character, bool set, std::stri
     AngelScript::Type<unsigned short>   mode_param(mode);
     AngelScript::Type<std::string*>     joint_param(&joint);
 
-    _object.Call("SetEquiped", 6, &this_param, &character_param, &slot_param, &mode_param, &joint_param, &set_param);
+    _template->GetScript().Call("SetEquiped", 6, &this_param, &character_param, &slot_param, &mode_param, &joint_param, &set_param);
   }
   _equiped = set;
 }
 
 bool InventoryObject::CanWeild(ObjectCharacter* character, std::string slot, unsigned char mode)
 {
-  if (_object.IsDefined("CanWeild"))
+  if (_template->GetScript().IsDefined("CanWeild"))
   {
     AngelScript::Type<InventoryObject*> this_param(this);
     AngelScript::Type<ObjectCharacter*> character_param(character);
     AngelScript::Type<std::string*>     slot_param(&slot);
     AngelScript::Type<int>              mode_param(mode);
 
-    return (_object.Call("CanWeild", 4, &this_param, &character_param, &slot_param, &mode_param));
+    return (_template->GetScript().Call("CanWeild", 4, &this_param, &character_param, &slot_param, &mode_param));
   }
   return (false);
 }
@@ -267,7 +273,7 @@ DynamicObject* InventoryObject::CreateDynamicObject(World* world) const
 
 bool              InventoryObject::CanUse(ObjectCharacter* user, InstanceDynamicObject* target, unsigned int use_type)
 {
-  AngelScript::Object& hooks = _actionHooks[use_type];
+  AngelScript::Object& hooks = _template->GetActionHooks()[use_type];
 
   if (hooks.IsDefined("CanUse"))
   {
@@ -282,9 +288,9 @@ bool              InventoryObject::CanUse(ObjectCharacter* user, InstanceDynamic
 
 int               InventoryObject::HitSuccessRate(ObjectCharacter* user, ObjectCharacter* target, unsigned char use_type)
 {
-  if (_actionHooks.size() > use_type)
+  if (_template->GetActionHooks().size() > use_type)
   {
-    AngelScript::Object& hooks = _actionHooks[use_type];
+    AngelScript::Object& hooks = _template->GetActionHooks()[use_type];
 
     if (hooks.IsDefined("HitChances"))
     {
@@ -302,9 +308,9 @@ int               InventoryObject::HitSuccessRate(ObjectCharacter* user, ObjectC
 
 unsigned short    InventoryObject::GetActionPointCost(ObjectCharacter* user, unsigned char use_type)
 {
-  if (_actionHooks.size() > use_type)
+  if (_template->GetActionHooks().size() > use_type)
   {
-    AngelScript::Object hooks = _actionHooks[use_type];
+    AngelScript::Object hooks = _template->GetActionHooks()[use_type];
 
     if (hooks.IsDefined("ActionPointCost"))
     {
@@ -328,11 +334,11 @@ bool InventoryObject::UseAsWeapon(ObjectCharacter* user, ObjectCharacter* target
 
 bool InventoryObject::UseOn(ObjectCharacter* user, InstanceDynamicObject* target, unsigned char useType)
 {
-  if (_actionHooks.size() > useType)
+  if (_template->GetActionHooks().size() > useType)
   {
     ObjectCharacter*     charTarget;
     Lockable*            lockTarget;
-    AngelScript::Object& hooks = _actionHooks[useType];
+    AngelScript::Object& hooks = _template->GetActionHooks()[useType];
 
     if (hooks.IsDefined("UseOnCharacter") && (charTarget = target->Get<ObjectCharacter>()) != 0)
       return (ExecuteHook("UseOnCharacter", user, charTarget, useType));
@@ -357,7 +363,7 @@ bool InventoryObject::ExecuteHook(const std::string& hook, ObjectCharacter* user
 {
   try
   {
-    AngelScript::Object& handle = _actionHooks[useType];
+    AngelScript::Object& handle = _template->GetActionHooks()[useType];
 
     if (handle.IsDefined(hook))
     {
@@ -383,7 +389,7 @@ void InventoryObject::ApplySplashEffect(ObjectCharacter *user, LPoint3f position
 {
   try
   {
-    AngelScript::Object& handle = _actionHooks[use_type];
+    AngelScript::Object& handle = _template->GetActionHooks()[use_type];
 
     if (handle.IsDefined("SplashEffect"))
     {
@@ -407,10 +413,12 @@ void Inventory::LoadItemFromData(Data item)
 {
   InventoryObject* newObject     = new InventoryObject(item);
 
-  (*newObject)["quantity"].Remove();
   AddObject(newObject);
   if (item["equiped"].NotNil())
+  {
+    newObject->MakeUnique();
     (*newObject)["equiped"].Duplicate(item["equiped"]);
+  }
 }
 
 void Inventory::LoadInventory(DynamicObject* object)
@@ -440,7 +448,7 @@ void Inventory::LoadInventory(Data items)
     {
       Data objectTree(item_index);
 
-      _content.clear();
+      ClearContent();
       for_each(items.begin(), items.end(), [this, objectTree](Data item)
       {
         unsigned int quantity;
@@ -487,43 +495,37 @@ void Inventory::InitializeSlots(void)
 
 void Inventory::SaveInventory(DynamicObject* object)
 {
-  Content::iterator it  = _content.begin();
-  Content::iterator end = _content.end();
+  std::unordered_map<std::string, int> unequiped;
 
   object->inventory.clear();
-  for (; it != end ; ++it)
+  for (Content::iterator it = _content.begin() ; it != _content.end() ; ++it)
   {
-    Content::iterator groupIt  = _content.begin();
-    InventoryObject&  item     = **it;
-    bool              ignore   = true;
-    int               quantity = 0;
+    if ((**it)["equiped"].Nil())
+      unequiped[(*it)->GetName()]++;
+  }
+  // Unequiped items are saved once per type, with the first of them
+  for (Content::iterator it = _content.begin() ; it != _content.end() ; ++it)
+  {
+    InventoryObject& item     = **it;
+    int              quantity = 1;
 
     if (item["equiped"].Nil())
     {
-      for (; groupIt != end ; ++groupIt)
-      {
-        if (groupIt == it)
-        {
-          if (quantity == 0)
-          {
-            ignore = false;
-            quantity = 1;
-          }
-          else
-            break ;
-        }
-        else if (item.IsGroupableWith(*groupIt) && (**groupIt)["equiped"].Nil())
-          quantity++;
-      }
+      int& group_quantity = unequiped[item.GetName()];
+
+      if (group_quantity == 0)
+        continue ;
+      quantity       = group_quantity;
+      group_quantity = 0;
     }
-    else
-      ignore = false;
-    if (!ignore)
     {
       std::string str;
 
-      if (quantity == 0) quantity = 1;
-      item["Name"] = item.Key();
+      if (item["Name"].Value() != item.Key())
+      {
+        item.MakeUnique();
+        item["Name"] = item.Key();
+      }
       DataTree::Writers::StringJSON(item, str);
       object->inventory.push_back(std::pair<std::string, int>(str, quantity));
     }
@@ -544,43 +546,93 @@ InventoryObject* Inventory::AddObject(const string& name)
   return (0);
 }
 
+static unsigned short GetItemWeight(InventoryObject& item)
+{
+  Data weight = item["weight"];
+
+  return (weight.Nil() ? 0 : (unsigned short)weight);
+}
+
 void Inventory::AddObject(InventoryObject* toAdd)
 {
-  Data weight = (*toAdd)["weight"];
+  unsigned short weight = GetItemWeight(*toAdd);
+  Stack&         stack  = _stacks[toAdd->GetName()];
 
-  if (!(weight.Nil()))
-    _currentWeight += (unsigned short)((*toAdd)["weight"]);
+  _currentWeight += weight;
+  stack.weight   += weight;
   (*toAdd)["equiped"].Remove();
-  _content.push_back(toAdd);
+  stack.items.push_back(_content.insert(_content.end(), toAdd));
   ContentChanged.Emit();
 }
 
 void Inventory::DelObject(InventoryObject* toDel)
 {
-  Content::iterator it = std::find(_content.begin(), _content.end(), toDel);
+  Stacks::iterator stack_it = _stacks.find(toDel->GetName());
 
-  if (it != _content.end())
+  if (stack_it != _stacks.end())
   {
-    Data weight  = (*toDel)["weight"];
-    Data equiped = (*toDel)["equiped"];
+    std::string  name  = stack_it->first;
+    Stack&       stack = stack_it->second;
+    auto         it    = std::find_if(stack.items.begin(), stack.items.end(), [toDel](Content::iterator item) { return (*item == toDel); });
 
-    if (!(weight.Nil()))
-      _currentWeight -= (unsigned short)((*toDel)["weight"]);
-    if (equiped.NotNil())
+    if (it != stack.items.end())
     {
-      SetEquipedItem(equiped["target"], equiped["slot"], 0, 0);
-      (*toDel)["equiped"].Remove();
+      unsigned short weight   = GetItemWeight(*toDel);
+      Data           equiped  = (*toDel)["equiped"];
+      unsigned int   position = it - stack.items.begin();
+
+      _currentWeight -= weight;
+      stack.weight   -= weight;
+      if (equiped.NotNil())
+      {
+        SetEquipedItem(equiped["target"], equiped["slot"], 0, 0);
+        (*toDel)["equiped"].Remove();
+      }
+      // Signals emitted by SetEquipedItem may have changed the stack
+      _content.erase(stack.items[position]);
+      stack.items.erase(stack.items.begin() + position);
+      if (stack.items.empty())
+        _stacks.erase(name);
+      ContentChanged.Emit();
     }
-    _content.erase(it);
-    ContentChanged.Emit();
   }
 }
 
+void Inventory::ClearContent(void)
+{
+  _content.clear();
+  _stacks.clear();
+  _currentWeight = 0;
+}
+
+void Inventory::UpdateWeights(void)
+{
+  _currentWeight = 0;
+  for (auto it = _stacks.begin() ; it != _stacks.end() ; ++it)
+  {
+    Stack& stack = it->second;
+
+    stack.weight = 0;
+    for (auto item = stack.items.begin() ; item != stack.items.end() ; ++item)
+      stack.weight += GetItemWeight(***item);
+    _currentWeight += stack.weight;
+  }
+}
+
+const Inventory::Stack* Inventory::GetStack(const std::string& name) const
+{
+  Stacks::const_iterator it = _stacks.find(name);
+
+  return (it != _stacks.end() ? &(it->second) : 0);
+}
+
 bool Inventory::IncludesObject(InventoryObject* obj) const
 {
-  Content::const_iterator it = std::find(_content.begin(), _content.end(), obj);
+  const Stack* stack = GetStack(obj->GetName());
 
-  return (it != _content.end());
+  if (stack)
+    return (std::find_if(stack->items.begin(), stack->items.end(), [obj](Content::iterator item) { return (*item == obj); }) != stack->items.end());
+  return (false);
 }
 
 int              Inventory::GetObjectIterator(InventoryObject* object) const
@@ -600,29 +652,16 @@ int              Inventory::GetObjectIterator(InventoryObject* object) const
 
 InventoryObject* Inventory::GetObject(const std::string& name)
 {
-  Content::iterator it  = _content.begin();
-  Content::iterator end = _content.end();
-  
-  for (; it != end ; ++it)
-  {
-    if ((*(*it)).GetName() == name)
-      return (*it);
-  }
-  return (0);
+  const Stack* stack = GetStack(name);
+
+  return (stack ? stack->Front() : 0);
 }
 
 unsigned short Inventory::ContainsHowMany(const std::string& name) const
 {
-  Content::const_iterator it    = _content.begin();
-  Content::const_iterator end   = _content.end();
-  unsigned short          count = 0;
+  const Stack* stack = GetStack(name);
 
-  for (; it != end ; ++it)
-  {
-    if ((*(*it)).GetName() == name)
-      count++;
-  }
-  return (count);
+  return (stack ? stack->Count() : 0);
 }
 
 bool Inventory::CanCarry(InventoryObject* object, unsigned short quantity)
@@ -726,6 +765,7 @@ void                   Inventory::SetEquipedItem(const std::string& type_slot, u
   }
   if (object)
   {
+    object->MakeUnique();
     Data data = *object;
 
     data["equiped"]["target"] = type_slot;
@@ -746,4 +786,5 @@ void Inventory::ResetItemsFromFixtures()
   {
     object->ResetFromFixture();
   });
+  UpdateWeights();
 }
@@ -0,0 +1,153 @@
+#include "level/item_template.hpp"
+#include "gametask.hpp"
+#include <functional>
+
+using namespace std;
+
+map<string, ItemTemplate*> ItemTemplate::templates;
+
+/*
+ * Every value of subset exists in superset. Nil branches are ignored.
+ */
+static bool IsSubsetOf(Data subset, Data superset)
+{
+  for (auto it = subset.begin() ; it != subset.end() ; ++it)
+  {
+    Data child = *it;
+
+    if (child.Nil())
+      continue ;
+    {
+      Data other = superset[child.Key()];
+
+      if (other.Nil() || other.Value() != child.Value() || !(IsSubsetOf(child, other)))
+        return (false);
+    }
+  }
+  return (true);
+}
+
+ItemTemplate::ItemTemplate(Data source) : script("scripts/objects/" + source["script"]["file"].Value())
+{
+  Data self(&definition);
+
+  self.Duplicate(source);
+  DataTree::Writers::StringJSON(self, json);
+  if (self["script"]["file"].Value() != "")
+  {
+    script.asDefineMethod("CanWeild", "bool CanWeild(Item@, Character@, string, int)");
+    script.asDefineMethod("SetEquiped", "void SetEquiped(Item@, Character@, string, int, string, bool)");
+  }
+  Data actions = self["actions"];
+
+  ForEach(actions, [this](Data action)
+  {
+    AngelScript::Object     hooks(script.GetContext(), script.GetModule());
+    function<bool (string)> sanity_check = [&action](string name) -> bool { return (action[name].NotNil() && action[name].Value() != ""); };
+
+    if (sanity_check("hookUse"))
+      hooks.asDefineMethod("Use",             "bool " + action["hookUse"].Value() + "(Item@, Character@)");
+    if (sanity_check("hookCharacters"))
+      hooks.asDefineMethod("UseOnCharacter",  "bool " + action["hookCharacters"].Value() + "(Item@, Character@, Character@)");
+    if (sanity_check("hookDoors"))
+      hooks.asDefineMethod("UseOnDoor",       "bool " + action["hookDoors"].Value() + "(Item@, Character@, Door@)");
+    if (sanity_check("hookOthers"))
+      hooks.asDefineMethod("UseOnOthers",     "bool " + action["hookOthers"].Value() + "(Item@, Character@, DynamicObject@)");
+    if (sanity_check("hookWeapon"))
+      hooks.asDefineMethod("UseAsWeapon",     "bool " + action["hookWeapon"].Value() + "(Item@, Character@, Character@)");
+    if (sanity_check("hookHitChances"))
+      hooks.asDefineMethod("HitChances",      "int " + action["hookHitChances"].Value() + "(Item@, Character@, Character@)");
+    if (sanity_check("hookCanUse"))
+      hooks.asDefineMethod("CanUse",          "bool " + action["hookCanUse"].Value() + "(Item@, Character@, DynamicObject@)");
+    if (sanity_check("hookActionPoints"))
+      hooks.asDefineMethod("ActionPointCost", "int " + action["hookActionPoints"].Value() + "(Item@, Character@, DynamicObject@)");
+    if (sanity_check("hookSplashEffect"))
+      hooks.asDefineMethod("SplashEffect",    "void " + action["hookSplashEffect"].Value() + "(Item@, Character@, float, float, float)");
+    action_hooks.push_back(hooks);
+  });
+}
+
+/*
+ * Returns 0 for items missing from the item index: their instances get a template of their own.
+ */
+ItemTemplate* ItemTemplate::Require(const string& name)
+{
+  auto it = templates.find(name);
+
+  if (it == templates.end())
+  {
+    Data items = GameTask::CurrentGameTask ? GameTask::CurrentGameTask->GetItemIndex() : Data();
+
+    if (items.Nil() || items[name].Nil())
+      return (0);
+    {
+      DataTree tree;
+      Data     definition(&tree);
+
+      MakeDefinition(items[name], definition);
+      definition["Name"] = name; // written by Inventory::SaveInventory
+      it = templates.insert(pair<string, ItemTemplate*>(name, new ItemTemplate(definition))).first;
+    }
+  }
+  return (it->second);
+}
+
+void ItemTemplate::Clear(void)
+{
+  for (auto it = templates.begin() ; it != templates.end() ; ++it)
+    delete it->second;
+  templates.clear();
+}
+
+/*
+ * Completes the definition an item was created from with the item index and the default values.
+ */
+void ItemTemplate::MakeDefinition(Data source, Data definition)
+{
+  if (source["icon"].Nil() && GameTask::CurrentGameTask)
+  {
+    Data items = GameTask::CurrentGameTask->GetItemIndex();
+
+    if (items[source.Key()].NotNil())
+      definition.Duplicate(items[source.Key()]);
+  }
+  definition.Duplicate(source);
+  definition["quantity"].Remove();
+  definition["weight"]   = (source["weight"].Nil()) ? "0" : source["weight"].Value();
+  definition["interactions"]["use"] = "1";
+  if (source["mode-mouth"].Nil())
+    definition["mode-mouth"] = "1";
+  if (source["mode-magic"].Nil())
+    definition["mode-magic"] = "1";
+  {
+    Data actions = definition["actions"];
+
+    ForEach(actions, [](Data action)
+    {
+      if (action["targeted"].Nil())
+        action["targeted"] = 1;
+    });
+  }
+}
+
+/*
+ * Whether MakeDefinition builds this template's definition out of source.
+ */
+bool ItemTemplate::Matches(Data source)
+{
+  Data     self(&definition);
+  DataTree tree;
+  Data     candidate(&tree);
+
+  MakeDefinition(source, candidate);
+  candidate["Name"] = self["Name"].Value();
+  return (IsSubsetOf(candidate, self) && IsSubsetOf(self, candidate));
+}
+
+bool ItemTemplate::HasSameScript(Data other)
+{
+  Data self(&definition);
+
+  return (self["script"]["file"].Value() == other["script"]["file"].Value() &&
+          IsSubsetOf(self["actions"], other["actions"]) && IsSubsetOf(other["actions"], self["actions"]));
+}
@@ -13,6 +13,8 @@
 #include "ui/ui_equip_mode.hpp"
 #include <ui/loading_screen.hpp>
 #include "options.hpp"
+#include "profiler.hpp"
+#include "logger.hpp"
 #include <mousecursor.hpp>
 
 #include "loading_exception.hpp"
@@ -30,7 +32,7 @@ MainScript::MainScript(const std::string& level_name) : AngelScript::Object("scr
 
 MainScript::~MainScript()
 {
-  cout << "Destroying MainScript" << endl;
+  LOG(Map, Debug) << "Destroying MainScript";
 }
 
 Level* Level::CurrentLevel = 0;
@@ -55,6 +57,7 @@ Level::Level(const std::string& name, WindowFramework* window, GameUi& gameUi, U
   floors.EnableShowLowerFloors(true);
 
   hovered_path.SetRenderNode(window->get_render());
+  InitializeFramePhases();
 
   obs.Connect(level_ui.InterfaceOpened, *this, &Level::SetInterrupted);
 
@@ -72,7 +75,7 @@ Level::Level(const std::string& name, WindowFramework* window, GameUi& gameUi, U
     throw LoadingException("Couldn't load the level's world");
   }
 
-  cout << "Level Loading Step #6" << endl;
+  LOG(Map, Debug) << "Level Loading Step #6";
   if (world->sunlight_enabled)
   {
     LoadingScreen::AppendText("Celestial bodies detected.");
@@ -100,82 +103,21 @@ Level::Level(const std::string& name, WindowFramework* window, GameUi& gameUi, U
   
   LoadingScreen::AppendText("Flattening objects...");
   {
-    //WorldFlattener flattener(*world);
-    
-    //flattener.Flatten();
-  }
+    // Baked offline with --compile-flatten
+    unsigned int baked_objects = WorldFlattener::Load(*world, "maps/" + name + ".blob");
 
-  /*
-   * DIVIDE AND CONQUER WAYPOINTS
-   */
-  std::vector<Waypoint*>                      entries;
-  
-  for_each(world->waypoints.begin(), world->waypoints.end(), [&entries](Waypoint& wp) { entries.push_back(&wp); });
-  world->waypoint_graph.SetHeuristic([](LPoint3f position1, LPoint3f position2) -> float
-  {
-    float xd = position2.get_x() - position1.get_x();
-    float yd = position2.get_y() - position1.get_y();
-    float zd = position2.get_z() - position1.get_z();
+    if (baked_objects > 0)
+      LOG(Map, Debug) << "[Level] " << baked_objects << " map objects are drawn from flattened geometry";
+  }
 
-    return (SQRT(xd * xd + yd * yd + zd * zd));
-  });
-  world->waypoint_graph.Initialize(entries, [](const std::vector<Waypoint*>& entries) -> std::vector<LPoint3f>
-  {
-    std::vector<LPoint3f> positions;
-    
-    {
-      LPoint3f block_size;
-      LPoint3f max_pos(0, 0, 0);
-      LPoint3f min_pos(0, 0, 0);
-      auto     it  = entries.begin();
-      auto     end = entries.end();
-
-      for (; it != end ; ++it)
-      {
-        LPoint3f pos = (*it)->GetPosition();
-
-        if (pos.get_x() < min_pos.get_x()) { min_pos.set_x(pos.get_x()); }
-        if (pos.get_y() < min_pos.get_y()) { min_pos.set_y(pos.get_y()); }
-        if (pos.get_z() < min_pos.get_z()) { min_pos.set_z(pos.get_z()); }
-        if (pos.get_x() > max_pos.get_x()) { max_pos.set_x(pos.get_x()); }
-        if (pos.get_y() > max_pos.get_y()) { max_pos.set_y(pos.get_y()); }
-        if (pos.get_z() > max_pos.get_z()) { max_pos.set_z(pos.get_z()); }
-      }
-      
-      function<float (float, float)> distance = [](float min_pos, float max_pos) -> float
-      {
-        if (min_pos < 0 && max_pos > 0)
-          return (ABS(min_pos - max_pos));
-        return (ABS(max_pos) - ABS(min_pos));
-      };
-      
-      block_size.set_x(distance(min_pos.get_x(), max_pos.get_x()));
-      block_size.set_y(distance(min_pos.get_y(), max_pos.get_y()));
-      block_size.set_z(distance(min_pos.get_z(), max_pos.get_z()));
-
-      unsigned short block_count = ceil(entries.size() / 200.f);
-      for (unsigned short i = 0 ; i < block_count ; ++i)
-      {
-        LPoint3f block_position;
-        
-        block_position.set_x(min_pos.get_x() + block_size.get_x() / block_count * i);
-        block_position.set_y(min_pos.get_y() + block_size.get_y() / block_count * i);
-        block_position.set_z(min_pos.get_z() + block_size.get_z() / block_count * i);
-        positions.push_back(block_position);
-      }
-    }
-    return (positions);
-  });
-  /*
-   * END DIVIDE AND CONQUER
-   */
+  world->IndexWaypoints();
 
   window->get_render().set_shader_auto();
 }
 
 Level::~Level()
 {
-  cout << "- Destroying Level" << endl;
+  LOG(Map, Debug) << "- Destroying Level";
   try
   {
     if (main_script.IsDefined("Finalize"))
@@ -200,6 +142,7 @@ Level::~Level()
 
   time_manager.ClearTasks(TASK_LVL_CITY);
   projectiles.CleanUp();
+  combat.Clear();
   ForEach(characters,  [](ObjectCharacter* obj)       { delete obj;        });
   ForEach(objects,     [](InstanceDynamicObject* obj) { delete obj;        });
   ScriptZone::DestroyAll();
@@ -209,6 +152,10 @@ Level::~Level()
   if (world)    delete world;
 }
 
+/*
+ * Only needed when the player changes: afterwards, visibility follows the detection changes of the
+ * player's field of view (see Player::InitializePlayer).
+ */
 void Level::RefreshCharactersVisibility(void)
 {
   ObjectCharacter*   player              = GetPlayer();
@@ -217,15 +164,12 @@ void Level::RefreshCharactersVisibility(void)
   {
     auto             detected_characters = player->GetFieldOfView().GetDetectedCharacters();
 
+    sort(detected_characters.begin(), detected_characters.end());
     for_each(characters.begin(), characters.end(),
-            [this, detected_characters, player](ObjectCharacter* character)
+            [&detected_characters, player](ObjectCharacter* character)
     {
       if (character != player)
-      {
-        auto it = find(detected_characters.begin(), detected_characters.end(), character);
-
-        character->SetVisible(it != detected_characters.end());
-      }
+        character->SetVisible(binary_search(detected_characters.begin(), detected_characters.end(), character));
     });
   }
 }
@@ -238,11 +182,71 @@ void Level::InsertCharacter(ObjectCharacter* character)
   character->GetFieldOfView().Launch();
   character->ProcessCollisions();
   characters.push_back(character);
+  RegisterCharacter(character);
+  combat.AddCharacter(character);
+  if (GetPlayer() && character != GetPlayer())
+    character->SetVisible(GetPlayer()->GetFieldOfView().IsDetected(character));
 }
 
 void Level::InsertInstanceDynamicObject(InstanceDynamicObject* object)
 {
   objects.push_back(object);
+  RegisterObject(object);
+}
+
+/*
+ * Lookup indexes: when several objects share a name, the first one in the list wins,
+ * as it did when GetObject and GetCharacter were linear searches. Unregistering that
+ * one hands the entry over to the next object of the list bearing the same name.
+ */
+void Level::RegisterObject(InstanceDynamicObject* object)
+{
+  instances_by_object[object->GetDynamicObject()] = object;
+  objects_by_name.insert(ObjectsByName::value_type(object->GetName(), object));
+}
+
+void Level::UnregisterObject(InstanceDynamicObject* object)
+{
+  auto it = objects_by_name.find(object->GetName());
+
+  if (it != objects_by_name.end() && it->second == object)
+  {
+    auto homonym = find_if(objects.begin(), objects.end(), [object](InstanceDynamicObject* candidate)
+    {
+      return (candidate != object && candidate->GetName() == object->GetName());
+    });
+
+    objects_by_name.erase(it);
+    if (homonym != objects.end())
+      objects_by_name.insert(ObjectsByName::value_type(object->GetName(), *homonym));
+  }
+  instances_by_object.erase(object->GetDynamicObject());
+}
+
+void Level::RegisterCharacter(ObjectCharacter* character)
+{
+  instances_by_object[character->GetDynamicObject()] = character;
+  characters_by_name.insert(CharactersByName::value_type(character->GetName(), character));
+  character_ranges.Invalidate();
+}
+
+void Level::UnregisterCharacter(ObjectCharacter* character)
+{
+  auto it = characters_by_name.find(character->GetName());
+
+  if (it != characters_by_name.end() && it->second == character)
+  {
+    auto homonym = find_if(characters.begin(), characters.end(), [character](ObjectCharacter* candidate)
+    {
+      return (candidate != character && candidate->GetName() == character->GetName());
+    });
+
+    characters_by_name.erase(it);
+    if (homonym != characters.end())
+      characters_by_name.insert(CharactersByName::value_type(character->GetName(), *homonym));
+  }
+  instances_by_object.erase(character->GetDynamicObject());
+  character_ranges.Invalidate();
 }
 
 void Level::InsertDynamicObject(DynamicObject& object)
@@ -262,13 +266,9 @@ void Level::InsertDynamicObject(DynamicObject& object)
       break ;
     case DynamicObject::Item:
     {
-      DataTree*        item_data = DataTree::Factory::StringJSON(object.inventory.front().first);
-      InventoryObject* item;
+      InventoryObject* item = InventoryObject::FromJSON(object.key, object.inventory.front().first);
 
-      item_data->key = object.key;
-      item           = new InventoryObject(item_data);
-      instance       = new ObjectItem(this, &object, item);
-      delete item_data;
+      instance = new ObjectItem(this, &object, item);
       break ;
     }
     case DynamicObject::Locker:
@@ -285,10 +285,11 @@ void Level::InsertDynamicObject(DynamicObject& object)
       AlertUi::NewAlert.Emit(stream.str());
     }
   }
-  cout << "Added an instance => " << instance << endl;
+  LOG(Map, Debug) << "Added an instance => " << instance;
   if (instance != 0)
   {
     objects.push_back(instance);
+    RegisterObject(instance);
     instance->ProcessCollisions();
   }
 }
@@ -316,7 +317,7 @@ void Level::SetAsPlayerParty(Party&)
     character->ChangedFloor.DisconnectAll();
     character->ChangedFloor.Connect([this](unsigned char new_floor)
     {
-      cout << "<event name='ChangedFloor' data-floor='"<<(int)new_floor<<"' />" << endl;
+      LOG(Map, Debug) << "<event name='ChangedFloor' data-floor='"<<(int)new_floor<<"' />";
       floors.SetCurrentFloor(new_floor);
     });
   }
@@ -340,6 +341,8 @@ void Level::InsertParty(Party& party, const std::string& zone_name)
 
       member->LinkCharacter(character);
       characters.insert(characters.begin(), character);
+      characters_by_name[character->GetName()] = character;
+      instances_by_object[world_object]        = character;
       ++it;
     }
     else
@@ -379,12 +382,14 @@ void Level::RemovePartyFromLevel(Party& party)
     character->GetEquipment().SetInventory(0);
     member->SaveCharacter(character);
     character->UnprocessCollisions();
+    UnregisterCharacter(character);
+    combat.RemoveCharacter(character);
     delete character;
     characters.erase(character_it);
     world->DeleteDynamicObject(world_object);
   });
   parties.remove(&party);
-  cout << ">>>>>>>>>>>>>> Party size: " << parties.size() << endl;
+  LOG(Map, Debug) << ">>>>>>>>>>>>>> Party size: " << parties.size();
 }
 
 void Level::RunForPartyMembers(Party& party, function<void (Party::Member*,ObjectCharacter*)> callback)
@@ -419,7 +424,7 @@ void Level::SetPlayerInventory(Inventory* inventory)
 
   if (!inventory)
   {
-    cout << "Using map's inventory" << endl;
+    LOG(Map, Debug) << "Using map's inventory";
     inventory = &(player->GetInventory());
   }
   else
@@ -431,15 +436,9 @@ void Level::SetPlayerInventory(Inventory* inventory)
 
 InstanceDynamicObject* Level::GetObject(const string& name)
 {
-  InstanceObjects::iterator it  = objects.begin();
-  InstanceObjects::iterator end = objects.end();
+  auto it = objects_by_name.find(name);
 
-  for (; it != end ; ++it)
-  {
-    if ((*(*it)) == name)
-      return (*it);
-  }
-  return (0);
+  return (it != objects_by_name.end() ? it->second : 0);
 }
 
 Level::CharacterList Level::FindCharacters(function<bool (ObjectCharacter*)> selector) const
@@ -460,15 +459,9 @@ Level::CharacterList Level::FindCharacters(function<bool (ObjectCharacter*)> sel
 
 ObjectCharacter* Level::GetCharacter(const string& name)
 {
-  Characters::const_iterator it  = characters.begin();
-  Characters::const_iterator end = characters.end();
+  auto it = characters_by_name.find(name);
 
-  for (; it != end ; ++it)
-  {
-    if ((*(*it)) == name)
-      return (*it);
-  }
-  return (0);
+  return (it != characters_by_name.end() ? it->second : 0);
 }
 
 ObjectCharacter* Level::GetCharacter(const DynamicObject* object)
@@ -522,13 +515,13 @@ list<InstanceDynamicObject*> Level::GetObjectsInRadius(LPoint3f position, float
 
   for_each(world->dynamicObjects.begin(), world->dynamicObjects.end(), [this, position, radius, &objects](const DynamicObject& dyn_object)
   {
+    auto                   it = instances_by_object.find(&dyn_object);
     InstanceDynamicObject* instance;
     LPoint3f               object_position;
 
-    if (dyn_object.type == DynamicObject::Character)
-      instance      = GetCharacter(dyn_object.name);
-    else
-      instance      = this->GetObject(dyn_object.name);
+    if (it == instances_by_object.end())
+      return ;
+    instance        = it->second;
     object_position = instance->GetDynamicObject()->nodePath.get_pos(window->get_render());
     if (GetDistance(object_position, position) <= radius)
       objects.push_back(instance);
@@ -538,7 +531,15 @@ list<InstanceDynamicObject*> Level::GetObjectsInRadius(LPoint3f position, float
 
 AsyncTask::DoneStatus Level::do_task(void)
 {
-  float elapsedTime = timer.GetElapsedTime();
+  return (do_task(timer.GetElapsedTime()));
+}
+
+/*
+ * Runs a frame with a given timestep (--bench-level steps the level with a fixed one).
+ */
+AsyncTask::DoneStatus Level::do_task(float elapsedTime)
+{
+  PROFILE_ZONE("Level:Frame");
 
   if (level_ui.GetContext()->GetHoverElement() == level_ui.GetContext()->GetRootElement())
     mouse.SetCursorFromState();
@@ -548,84 +549,139 @@ AsyncTask::DoneStatus Level::do_task(void)
     mouse.SetMouseState('i');
   }
 
-  bool use_fog_of_war = false;
-  if (use_fog_of_war == false)
-    RefreshCharactersVisibility();
-
   if (GetPlayer() == 0)
     return (AsyncTask::DS_cont);
-  camera.SlideToHeight(GetPlayer()->GetDynamicObject()->nodePath.get_z());
-  camera.Run(elapsedTime);  
-  mouse.Run(elapsedTime);
-
-  std::function<void (InstanceDynamicObject*)> run_object = [elapsedTime](InstanceDynamicObject* obj) { obj->Run(elapsedTime); };
-  switch (level_state)
-  {
-    case Fight:
-      ForEach(objects,    run_object);
-      ForEach(characters, [elapsedTime](ObjectCharacter* character) { character->RunFade(elapsedTime); });
-      // If projectiles are moving, run them. Otherwise, run the current character
-      if (projectiles.size() > 0)
-        projectiles.Run(elapsedTime);
-      else
-      {
-        ObjectCharacter* combat_character = combat.GetCurrentCharacter();
-
-        if (combat_character)
-        {
-          run_object(combat_character);
-          if (combat_character == GetPlayer() && mouse.Hovering().hasWaypoint && mouse.GetState() == MouseEvents::MouseAction)
-            hovered_path.DisplayHoveredPath(GetPlayer(), mouse);
-        }
-        if (level_state != Fight)
-          hovered_path.Hide();
-        else if (combat_character != combat.GetCurrentCharacter())
+  frame_phases.Run(elapsedTime);
+  timer.Restart();
+  return (exit.ReadyForNextZone() ? AsyncTask::DS_done : AsyncTask::DS_cont);
+}
+
+/*
+ * Phases touching the scene graph or the scripts run on the main thread. The others only compute from
+ * data gathered by a previous phase, and run on the job system meanwhile:
+ * - ranges: the characters within each field of view, from the positions taken by the snapshot phase,
+ *   while the camera and the mouse are updated;
+ * - fade: the alpha of the fading floors, while the chatter boxes are updated.
+ */
+void Level::InitializeFramePhases(void)
+{
+  frame_phases.Add("snapshot", FramePhases::MainThread, [this](float)
+  {
+    NodePath render = window->get_render();
+
+    character_ranges.Clear();
+    ForEach(characters, [this, &render](ObjectCharacter* character)
+    {
+      LPoint3f position = character->GetDynamicObject()->nodePath.get_pos(render);
+
+      character_ranges.Add(character, position.get_x(), position.get_y(), character->GetFieldOfView().GetRadius());
+    });
+  });
+
+  frame_phases.Add("ranges", FramePhases::AnyThread, [this](float)
+  {
+    character_ranges.Compute();
+  }, { "snapshot" });
+
+  frame_phases.Add("camera", FramePhases::MainThread, [this](float elapsed_time)
+  {
+    camera.SlideToHeight(GetPlayer()->GetDynamicObject()->nodePath.get_z());
+    camera.Run(elapsed_time);
+    mouse.Run(elapsed_time);
+  }, { "snapshot" });
+
+  frame_phases.Add("objects", FramePhases::MainThread, [this](float elapsed_time)
+  {
+    std::function<void (InstanceDynamicObject*)> run_object = [elapsed_time](InstanceDynamicObject* obj) { obj->Run(elapsed_time); };
+
+    switch (level_state)
+    {
+      case Fight:
+        ForEach(objects, run_object);
+        ForEach(characters, [elapsed_time](ObjectCharacter* character) { character->RunFade(elapsed_time); });
+        // If projectiles are moving, run them. Otherwise, run the current character
+        if (projectiles.size() > 0)
+          projectiles.Run(elapsed_time);
+        else
         {
-          combat_character->UnprocessCollisions();
-          combat_character->ProcessCollisions();
+          ObjectCharacter* combat_character = combat.GetCurrentCharacter();
+
+          if (combat_character)
+          {
+            run_object(combat_character);
+            if (combat_character == GetPlayer() && mouse.Hovering().hasWaypoint && mouse.GetState() == MouseEvents::MouseAction)
+              hovered_path.DisplayHoveredPath(GetPlayer(), mouse);
+          }
+          if (level_state != Fight)
+            hovered_path.Hide();
+          else if (combat_character != combat.GetCurrentCharacter())
+          {
+            combat_character->UnprocessCollisions();
+            combat_character->ProcessCollisions();
+          }
         }
-      }
-      break ;
-      particle_manager.do_particles(ClockObject::get_global_clock()->get_dt());
-    case Normal:
-      projectiles.Run(elapsedTime);
-      time_manager.AddElapsedSeconds(elapsedTime);
-      ForEach(objects,    run_object);
-      ForEach(characters, run_object);
-      particle_manager.do_particles(ClockObject::get_global_clock()->get_dt());
-      break ;
-    case Interrupted:
-      break ;
-  }
-  zones.Refresh();
+        break ;
+      case Normal:
+        projectiles.Run(elapsed_time);
+        time_manager.AddElapsedSeconds(elapsed_time);
+        ForEach(objects,    run_object);
+        ForEach(characters, run_object);
+        particle_manager.do_particles(ClockObject::get_global_clock()->get_dt());
+        break ;
+      case Interrupted:
+        break ;
+    }
+  }, { "camera", "ranges" });
 
-  if (main_script.IsDefined("Run"))
+  frame_phases.Add("zones", FramePhases::MainThread, [this](float)
   {
-    AngelScript::Type<float> param_time(elapsedTime);
+    zones.Refresh();
+  }, { "objects" });
 
-    main_script.Call("Run", 1, &param_time);
-  }
+  frame_phases.Add("script", FramePhases::MainThread, [this](float elapsed_time)
+  {
+    if (main_script.IsDefined("Run"))
+    {
+      AngelScript::Type<float> param_time(elapsed_time);
 
-  floors.SetCurrentFloorFromObject(GetPlayer());
-  floors.RunFadingEffect(elapsedTime);
-  chatter_manager.Run(elapsedTime, camera.GetNodePath());
-  timer.Restart();
-  return (exit.ReadyForNextZone() ? AsyncTask::DS_done : AsyncTask::DS_cont);
+      main_script.Call("Run", 1, &param_time);
+    }
+  }, { "zones" });
+
+  frame_phases.Add("floors", FramePhases::MainThread, [this](float)
+  {
+    floors.SetCurrentFloorFromObject(GetPlayer());
+  }, { "script" });
+
+  frame_phases.Add("fade", FramePhases::AnyThread, [this](float elapsed_time)
+  {
+    floors.ComputeFadingEffect(elapsed_time);
+  }, { "floors" });
+
+  frame_phases.Add("chatter", FramePhases::MainThread, [this](float elapsed_time)
+  {
+    chatter_manager.Run(elapsed_time, camera.GetNodePath());
+  }, { "floors" });
+
+  frame_phases.Add("floors-apply", FramePhases::MainThread, [this](float)
+  {
+    floors.ApplyFadingEffect();
+  }, { "fade" });
+
+  frame_phases.SetParallel(OptionsManager::Get()["parallel-frame"].Value() != "0");
 }
 
 InstanceDynamicObject* Level::FindObjectFromNode(NodePath node)
 {
-  function<bool (InstanceDynamicObject*)> condition = [node](InstanceDynamicObject* object) -> bool { return (*object == node); };
-  auto result_object = find_if(objects.begin(), objects.end(), condition);
-  
-  if (result_object != objects.end())
-    return (*result_object);
-  else
+  DynamicObject* dynamic_object = world->GetDynamicObjectFromNodePath(node);
+
+  while (dynamic_object != 0)
   {
-    auto result_character = find_if(characters.begin(), characters.end(), condition);
-    
-    if (result_character != characters.end())
-      return (*result_character);
+    auto it = instances_by_object.find(dynamic_object);
+
+    if (it != instances_by_object.end())
+      return (it->second);
+    dynamic_object = world->GetDynamicObjectFromNodePath(dynamic_object->nodePath.get_parent());
   }
   return (0);
 }
@@ -636,6 +692,7 @@ void                   Level::RemoveObject(InstanceDynamicObject* object)
   
   if (it != objects.end())
   {
+    UnregisterObject(*it);
     world->DeleteDynamicObject((*it)->GetDynamicObject());
     delete (*it);
     objects.erase(it);
@@ -769,6 +826,84 @@ void Level::Serialize(Utils::Packet& packet)
   ProcessAllCollisions();
 }
 
+/*
+ * Same data as Serialize, split between a snapshot and a delta (see DeltaSave).
+ * Only the objects flagged dirty since the previous save, the new objects and the characters
+ * (which change nearly every turn) are serialized again. The world (waypoints, map objects, lights,
+ * zones) has no records: a new snapshot is written whenever it changed since the previous one.
+ * Returns true when a new snapshot was written: otherwise the snapshot on disk is still valid.
+ */
+bool Level::Save(std::string& snapshot, std::string& delta)
+{
+  std::vector<std::string> world_order, instance_order;
+  bool                     full;
+
+  ForEach(GetWorld()->dynamicObjects, [&world_order](const DynamicObject& object) { world_order.push_back(object.name); });
+  ForEach(objects,    [&instance_order](InstanceDynamicObject* object) { instance_order.push_back(object->GetName());    });
+  ForEach(characters, [&instance_order](ObjectCharacter* character)    { instance_order.push_back(character->GetName()); });
+  if (!(delta_save.SetOrder(world_order, instance_order)))
+  {
+    Utils::Packet packet;
+
+    // Records are found by name: levels with homonyms can only be saved whole
+    delta_save.Clear();
+    Serialize(packet);
+    snapshot.assign(packet.raw(), packet.size());
+    delta.clear();
+    return (true);
+  }
+  full = delta_save.NeedsSnapshot();
+  BackupInventoriesToDynamicObjects();
+  UnprocessAllCollisions();
+  {
+    Utils::Packet head, tail, state, combat_state;
+    auto          record_object   = [this](const DynamicObject& object)
+    {
+      Utils::Packet packet;
+
+      object.Serialize(packet);
+      delta_save.SetRecord(DeltaSave::WorldRecord, object.name, packet);
+    };
+    auto          record_instance = [this, &record_object](InstanceDynamicObject* instance)
+    {
+      Utils::Packet packet;
+
+      record_object(*instance->GetDynamicObject());
+      instance->Serialize(packet);
+      delta_save.SetRecord(DeltaSave::InstanceRecord, instance->GetName(), packet);
+      instance->ClearDirty();
+    };
+
+    LoadingScreen::AppendText("Recording topology...");
+    GetWorld()->SerializeHead(head); // renumbers the waypoints: must come before the records referring to them
+    GetWorld()->SerializeTail(tail);
+    full = full || !(delta_save.MatchesSnapshot(head, tail));
+    if (full)
+      delta_save.BeginSnapshot();
+    LoadingScreen::AppendText("Recording demographic data...");
+    ForEach(objects, [this, full, &record_instance](InstanceDynamicObject* object)
+    {
+      if (full || object->IsDirty() || !(delta_save.HasRecord(DeltaSave::InstanceRecord, object->GetName())))
+        record_instance(object);
+    });
+    ForEach(characters, [&record_instance](ObjectCharacter* character) { record_instance(character); });
+    // DynamicObjects which have no instance
+    ForEach(GetWorld()->dynamicObjects, [this, full, &record_object](const DynamicObject& object)
+    {
+      if (full || !(delta_save.HasRecord(DeltaSave::WorldRecord, object.name)))
+        record_object(object);
+    });
+    state << (char)(combat.GetCurrentCharacter() != 0 ? State::Fight : State::Normal);
+    combat.Serialize(combat_state);
+    delta_save.SetLevelState(state, combat_state);
+    if (full)
+      snapshot = delta_save.WriteSnapshot(head, tail);
+    delta = delta_save.WriteDelta();
+  }
+  ProcessAllCollisions();
+  return (full);
+}
+
 void Level::Unserialize(Utils::Packet& packet)
 {
   char tmpState;
@@ -776,8 +911,8 @@ void Level::Unserialize(Utils::Packet& packet)
   packet >> tmpState;
   level_state = (State)tmpState;
   for_each(objects.begin(),    objects.end(),    [&packet](InstanceDynamicObject* object) { object->Unserialize(packet);    });
-  cout << "objects unserialized" << endl;
+  LOG(Map, Debug) << "objects unserialized";
   for_each(characters.begin(), characters.end(), [&packet](ObjectCharacter* character)    { character->Unserialize(packet); });
-  cout << "characters unserialized" << endl;
+  LOG(Map, Debug) << "characters unserialized";
   combat.Unserialize(packet);
 }
@@ -2,6 +2,7 @@
 #include "world/world.h"
 #include <mousecursor.hpp>
 #include <timer.hpp>
+#include <profiler.hpp>
 #include <panda3d/cardMaker.h>
 #include <panda3d/collisionPlane.h>
 
@@ -13,17 +14,20 @@ Mouse::Mouse(WindowFramework* window) : _window(window)
   MouseWatcher::init_type();
   _lastMousePos.set_x(0);
   _lastMousePos.set_y(0);
+  _waypointResolved      = false;
   _camera                = window->get_camera_group();
   _hovering.Reset();
   _mouseWatcher          = dynamic_cast<MouseWatcher*>(window->get_mouse().node());
   _pickerNode            = new CollisionNode("mouseRay");
   _pickerPath            = _camera.attach_new_node(_pickerNode);
-  _pickerNode->set_from_collide_mask(CollideMask(/*ColMask::Waypoint | */ColMask::DynObject));
+  _pickerNode->set_from_collide_mask(CollideMask(ColMask::DynObject | ColMask::WpPlane));
   _pickerNode->set_into_collide_mask(0);
   _pickerRay             = new CollisionRay();
   _pickerNode->add_solid(_pickerRay);
   _collisionHandlerQueue = new CollisionHandlerQueue();
   _collisionTraverser.add_collider(_pickerPath, _collisionHandlerQueue);
+  _modelHandlerQueue     = new CollisionHandlerQueue();
+  _modelTraverser.add_collider(_pickerPath, _modelHandlerQueue);
 
   EventHandler* events = EventHandler::get_global_event_handler();
 
@@ -133,119 +137,100 @@ LPoint2f Mouse::GetPositionRatio(void) const
   return (position);
 }
 
-void Mouse::ClosestWaypoint(World* world, short current_floor)
+/*
+ * Picks what's under the cursor with a single traversal of the picking root (the current floor, or
+ * the whole scene when none was set). Results are kept until the cursor, the camera or the root change.
+ */
+bool Mouse::Pick(void)
 {
-  //if (_mouseWatcher->has_mouse())
+  LPoint2f  cursorPos  = GetPositionRatio();
+  LMatrix4f camera_mat = _pickerPath.get_net_transform()->get_mat();
+  NodePath  root       = _pickingRoot.is_empty() ? _window->get_render() : _pickingRoot;
+
+  if (cursorPos == _lastMousePos && camera_mat == _lastCameraMat && root == _lastPickingRoot)
+    return (false);
+  _lastMousePos     = cursorPos;
+  _lastCameraMat    = camera_mat;
+  _lastPickingRoot  = root;
+  _waypointResolved = false;
+  _pickerRay->set_from_lens(_window->get_camera(0), cursorPos.get_x(), cursorPos.get_y());
+  _collisionTraverser.traverse(root);
+  _collisionHandlerQueue->sort_entries();
+  _hovering.hasDynObject = false;
+  _hovering.dynObject    = NodePath();
+  for (int i = 0 ; i < _collisionHandlerQueue->get_num_entries() ; ++i)
   {
-    PStatCollector collector("Level:Mouse:FindWaypoint"); collector.start();
-    PT(CollisionRay)          pickerRay;
-    PT(CollisionNode)         pickerNode;
-    NodePath                  pickerPath;
-    CollisionTraverser        collisionTraverser;
-    PT(CollisionHandlerQueue) collisionHandlerQueue = new CollisionHandlerQueue();
-    LPoint2f                  cursorPos             = GetPositionRatio();
-    static bool               updated               = false;
-    static LPoint2f           last_update;
-
-    if (ABS(cursorPos.get_x() - last_update.get_x()) > 0.05 || ABS(cursorPos.get_y() - last_update.get_y()) > 0.05)
-      updated         = false;
-    if (!(updated == false))
-      return ;
-    last_update       = cursorPos;
-    updated           = true;
-    pickerNode        = new CollisionNode("mouseRay2");
-    pickerPath        = _camera.attach_new_node(pickerNode);
-    pickerRay         = new CollisionRay();
-    pickerNode->set_from_collide_mask(CollideMask(ColMask::WpPlane));
-    pickerNode->set_into_collide_mask(0);
-    pickerRay->set_from_lens(_window->get_camera(0), cursorPos.get_x(), cursorPos.get_y());
-    pickerNode->add_solid(pickerRay);
-
-    collisionTraverser.add_collider(pickerPath, collisionHandlerQueue);
-    collisionTraverser.traverse(_window->get_render());
-    //collisionTraverser.traverse(world->floors[current_floor]);
-
-    collisionHandlerQueue->sort_entries();
-
-    if (_hovering.waypoint_ptr && _hovering.hasWaypoint)
-      _hovering.waypoint_ptr->SetSelected(false);
-    _hovering.hasWaypoint  = false;
-    _hovering.waypoint_ptr = 0;
-    for (int i = 0 ; i < collisionHandlerQueue->get_num_entries() ; ++i)
-    {
-      CollisionTraverser        model_traverser;
-      PT(CollisionHandlerQueue) handler_queue = new CollisionHandlerQueue();
-
-      CollisionEntry* entry      = collisionHandlerQueue->get_entry(i);
-      NodePath        np         = entry->get_into_node_path();
-      MapObject*      map_object = world->GetMapObjectFromNodePath(np);
-      LPoint3         pos;
-      static LPoint3  spheresize = NodePathSize(world->model_sphere);
+    CollisionEntry* entry = _collisionHandlerQueue->get_entry(i);
+    NodePath        into  = entry->get_into_node_path();
 
-      if (!map_object || map_object->nodePath.is_hidden())
-        continue ;
-      if (map_object->collider.type == Collider::MODEL)
-      {
-        CollideMask initial_collide_mask = map_object->render.get_collide_mask();
-
-        map_object->render.set_collide_mask(initial_collide_mask | CollideMask(ColMask::WpPlane));
-        model_traverser.add_collider(pickerPath, handler_queue);
-        model_traverser.traverse(map_object->render);
-        map_object->render.set_collide_mask(initial_collide_mask);
-        if (handler_queue->get_num_entries() == 0)
-          continue ;
-        entry = handler_queue->get_entry(0);
-      }
-      pos = entry->get_surface_point(world->window->get_render()) - spheresize;
-      _hovering.waypoint_ptr = world->waypoint_graph.GetClosest(pos);
-      if (_hovering.waypoint_ptr)
-      {
-        _hovering.SetWaypoint(_hovering.waypoint_ptr->nodePath);
-        _hovering.waypoint_ptr->SetSelected(true);
-      }
+    if (into.is_hidden())
+      continue ;
+    switch (into.get_collide_mask().get_word())
+    {
+      case ColMask::DynObject:
+      if (!(_hovering.hasDynObject))
+        _hovering.SetDynObject(into);
       break ;
     }
-
-    // Detaching seems to be causing some memory issues.
-    //pickerPath.detach_node();
-    collector.stop();
   }
+  return (true);
 }
 
-void Mouse::Run(void)
+void Mouse::ResolveWaypoint(World* world)
 {
-  PStatCollector collector("Level:Mouse:Run");
-
-  collector.start();
-  //if (pointer.get_in_window())
+  static LPoint3 spheresize = NodePathSize(world->model_sphere);
+
+  if (_hovering.waypoint_ptr && _hovering.hasWaypoint)
+    _hovering.waypoint_ptr->SetSelected(false);
+  _hovering.hasWaypoint  = false;
+  _hovering.waypoint_ptr = 0;
+  _waypointResolved      = true;
+  for (int i = 0 ; i < _collisionHandlerQueue->get_num_entries() ; ++i)
   {
-      LPoint2f cursorPos = GetPositionRatio();
-
-    if (cursorPos != _lastMousePos)
+    CollisionEntry* entry      = _collisionHandlerQueue->get_entry(i);
+    NodePath        np         = entry->get_into_node_path();
+    MapObject*      map_object;
+    LPoint3         pos;
+
+    if ((entry->get_into_node()->get_into_collide_mask() & CollideMask(ColMask::WpPlane)).is_zero())
+      continue ;
+    map_object = world->GetMapObjectFromNodePath(np);
+    if (!map_object || map_object->nodePath.is_hidden())
+      continue ;
+    // The geometry may be shared with other objects: the ray's mask changes, not the model's
+    if (map_object->collider.type == Collider::MODEL)
+    {
+      _pickerNode->set_from_collide_mask(CollideMask(ColMask::Render));
+      _modelTraverser.traverse(map_object->render);
+      _pickerNode->set_from_collide_mask(CollideMask(ColMask::DynObject | ColMask::WpPlane));
+      if (_modelHandlerQueue->get_num_entries() == 0)
+        continue ;
+      entry = _modelHandlerQueue->get_entry(0);
+    }
+    pos = entry->get_surface_point(world->window->get_render()) - spheresize;
+    _hovering.waypoint_ptr = world->waypoint_grid.GetClosest(pos.get_x(), pos.get_y(), pos.get_z());
+    if (_hovering.waypoint_ptr)
     {
-      _lastMousePos = cursorPos;
-      _pickerRay->set_from_lens(_window->get_camera(0), cursorPos.get_x(), cursorPos.get_y());
-      _collisionTraverser.traverse(_window->get_render());
-      _collisionHandlerQueue->sort_entries();
-      //_hovering.Reset();
-      _hovering.hasDynObject = false;
-      _hovering.dynObject    = NodePath();
-      for (int i = 0 ; i < _collisionHandlerQueue->get_num_entries() ; ++i)
-      {
-        CollisionEntry* entry = _collisionHandlerQueue->get_entry(i);
-        NodePath        into  = entry->get_into_node_path();
-
-        if (into.is_hidden())
-          continue ;
-        switch (into.get_collide_mask().get_word())
-        {
-          case ColMask::DynObject:
-          if (!(_hovering.hasDynObject))
-            _hovering.SetDynObject(into);
-          break ;
-        }
-      }
+      _hovering.SetWaypoint(_hovering.waypoint_ptr->nodePath);
+      _hovering.waypoint_ptr->SetSelected(true);
     }
+    break ;
   }
-  collector.stop();
+}
+
+void Mouse::ClosestWaypoint(World* world, short current_floor)
+{
+  PROFILE_ZONE("Level:Mouse:FindWaypoint");
+
+  if (current_floor >= 0 && (unsigned int)current_floor < world->floors.size())
+    SetPickingRoot(world->floors[current_floor]);
+  if (Pick() || !_waypointResolved)
+    ResolveWaypoint(world);
+}
+
+void Mouse::Run(void)
+{
+  PROFILE_ZONE("Level:Mouse:Run");
+
+  Pick();
 }
@@ -10,6 +10,11 @@ MouseHint::MouseHint(Level& level, LevelUi& level_ui) : MouseInteractionHint(lev
 
 void MouseHint::Run(float elapsed_time)
 {
+  World* world = level.GetWorld();
+
+  // Only the current floor is picked from
+  if (world && level.GetCurrentFloor() < world->floors.size())
+    SetPickingRoot(world->floors[level.GetCurrentFloor()]);
   if (!(IsHoveringUi()))
   {
     switch (GetState())
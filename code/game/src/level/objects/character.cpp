@@ -6,12 +6,13 @@
 #include <options.hpp>
 #include <dices.hpp>
 #include <iterator>
+#include <algorithm>
 #include "gametask.hpp"
-#include "debuginfo.hpp"
+#include "logger.hpp"
+#include "profiler.hpp"
 
 using namespace std;
 
-extern DebugInfo warning, info, debug;
 
 ObjectCharacter::ObjectCharacter(Level* level, DynamicObject* object) :
   CharacterActionPoints(level, object),
@@ -34,7 +35,6 @@ ObjectCharacter::ObjectCharacter(Level* level, DynamicObject* object) :
 
   // Faction
   _faction        = 0;
-  _self_enemyMask = 0;
   
   // Script
   if (object->script == "")
@@ -132,7 +132,7 @@ void ObjectCharacter::ActionTalkTo(ObjectCharacter* user)
 
 void ObjectCharacter::ActionUse(InstanceDynamicObject* user)
 {
-  debug.out() << "ActionUse character" << endl;
+  LOG(Characters, Debug) << "ActionUse character";
   if (user == _level->GetPlayer())
   {
     if (IsAlive())
@@ -255,7 +255,7 @@ void ObjectCharacter::ItemNextUseType(unsigned short it)
 
   if (equiped_item && equiped_item->item)
   {
-    debug.out() << "Equiped item on slot " << it << " is " << equiped_item->item->GetName() << endl;
+    LOG(Characters, Debug) << "Equiped item on slot " << it << " is " << equiped_item->item->GetName();
     Data             itemData   = *(equiped_item->item);
     Data             actionData = itemData["actions"];
     unsigned char    action     = equiped_item->current_action;
@@ -288,18 +288,17 @@ bool ObjectCharacter::IsInterrupted() const
     if (std::abs(target.get_x() - pos.get_x()) > 0.01f ||
         std::abs(target.get_y() - pos.get_y()) > 0.01f)
       {
-        debug.out() << "Not yet in position " << pos << " - " << target << endl;
+        LOG(Characters, Debug) << "Not yet in position " << pos << " - " << target;
       return (true);
       }
   }
   //else if (AnimationEndForObject.ObserverCount() > 0)
-    debug.out() << "Not yet done with animations" << endl;
+    LOG(Characters, Debug) << "Not yet done with animations";
   return (AnimationEndForObject.ObserverCount() > 0);
 }
 
 void ObjectCharacter::Run(float elapsedTime)
 {
-  //Timer profile;
   Level::State state = _level->GetState();
 
   CharacterActionPoints::Run(elapsedTime);
@@ -321,19 +320,16 @@ void ObjectCharacter::Run(float elapsedTime)
     }
   }
   else
-    debug.out() << "Character " << GetName() << " is interrupted (" << IsInterrupted() << ")" << endl;
-  //profile.Profile("Level:Characters:AI");
+    LOG(Characters, Debug) << "Character " << GetName() << " is interrupted (" << IsInterrupted() << ")";
 }
 
 void ObjectCharacter::RunRegularBehaviour(float elapsedTime)
 {
-  PStatCollector                      collector_ai("Level:Characters:AI");
+  PROFILE_ZONE("Level:Characters:AI");
   AngelScript::Type<ObjectCharacter*> self(this);
   AngelScript::Type<float>            p_time(elapsedTime);
 
-  collector_ai.start();
   script->Call("main", 2, &self, &p_time);
-  collector_ai.stop();
 }
 
 void ObjectCharacter::RunCombatBehaviour(float)
@@ -346,12 +342,11 @@ void ObjectCharacter::RunCombatBehaviour(float)
     if (nodepath.get_x() == waypoint_nodepath.get_x() && nodepath.get_y() == waypoint_nodepath.get_y())
       _level->GetCombat().NextTurn();
     else
-      debug.out() << "Waiting end of movement to pass turn" << endl;
+      LOG(Ai, Debug) << "Waiting end of movement to pass turn";
   }
   else if (!IsBusy())
   {
-    PStatCollector collector_ai("Level:Characters:AI");
-    bool           idle_during_fights = (this != _level->GetPlayer() && !script->IsDefined("combat"));
+    bool idle_during_fights = (this != _level->GetPlayer() && !script->IsDefined("combat"));
 
     if (GetHitPoints() <= 0 || GetActionPoints() == 0 || idle_during_fights)
       _level->GetCombat().NextTurn();
@@ -360,24 +355,26 @@ void ObjectCharacter::RunCombatBehaviour(float)
       AngelScript::Type<ObjectCharacter*> self(this);
       unsigned int                        ap_before = GetActionPoints();
 
-      debug.out() << "Calling AI" << endl;
-      collector_ai.start();
-      script->Call("combat", 1, &self);
-      debug.out() << "End Calling AI" << endl;
-      collector_ai.stop();
+      LOG(Ai, Debug) << "Calling AI";
+      {
+        PROFILE_ZONE("Level:Characters:AI");
+
+        script->Call("combat", 1, &self);
+      }
+      LOG(Ai, Debug) << "End Calling AI";
       if (ap_before == GetActionPoints() && !IsBusy()) // If stalled, skip turn
       {
-        debug.out() << "Character " << GetName() << " is stalling" << endl;
+        LOG(Ai, Debug) << "Character " << GetName() << " is stalling";
         _level->GetCombat().NextTurn();
       }
       else if (IsMoving())
-        debug.out() << "Character " << GetName() << " is moving" << endl;
+        LOG(Ai, Debug) << "Character " << GetName() << " is moving";
       else
-        debug.out() << "Character " << GetName() << " is playing" << endl;
+        LOG(Ai, Debug) << "Character " << GetName() << " is playing";
     }
   }
   else
-    debug.out() << "Combat AI: Nothing to do (playing animation: " << PlayingAnimationName() << ")" << endl;
+    LOG(Ai, Debug) << "Combat AI: Nothing to do (playing animation: " << PlayingAnimationName() << ")";
 }
 
 bool ObjectCharacter::IsBusy(void) const
@@ -399,7 +396,7 @@ void                ObjectCharacter::GoToRandomWaypoint(void)
       
       if (!(wplist.empty()))
       {
-	int                       rit    = rand() % wplist.size();
+	int                       rit    = Dices::Get(Dices::Ai).Below(wplist.size());
 	list<Waypoint*>::iterator it     = wplist.begin();
 
 	for (it = wplist.begin() ; rit ; --rit, ++it);
@@ -437,22 +434,22 @@ Pathfinding::Path   ObjectCharacter::GetPathTowardsObject(Collider* character)
 
 void                ObjectCharacter::RunDeath()
 {
-  debug.out() << "Running death" << endl;
-  debug.out() << "- unequipping items" << endl;
+  LOG(Characters, Debug) << "Running death";
+  LOG(Characters, Debug) << "- unequipping items";
   if (_inventory)
     _inventory->UnequipAllItems();
-  debug.out() << "- clearing interactions" << endl;
+  LOG(Characters, Debug) << "- clearing interactions";
   ClearInteractions();
-  debug.out() << "- adding looting interaction" << endl;
+  LOG(Characters, Debug) << "- adding looting interaction";
   AddInteraction("use", _level->GetInteractions().Use);
 
   GetNodePath().set_hpr(0, 0, 90);
   UnprocessCollisions();
-  debug.out() << "- etting hit points if superior to 0" << endl;
+  LOG(Characters, Debug) << "- etting hit points if superior to 0";
   if (GetHitPoints() > 0)
     SetHitPoints(0);
   can_be_walked_on = true;
-  debug.out() << "Death ran" << endl;
+  LOG(Characters, Debug) << "Death ran";
 }
 
 bool ObjectCharacter::IsPlayer(void) const
@@ -488,6 +485,52 @@ Script::StdList<ObjectCharacter*> ObjectCharacter::GetNearbyAllies(void) const
   return (ret);
 }
 
+/*
+ * Bulk queries: what AI scripts usually read about the characters around them, filled in one call and
+ * sorted by distance, instead of one native call per character and per value.
+ */
+ObjectCharacter::NearbyCharacters ObjectCharacter::GetCharactersInRadius(float radius) const
+{
+  return (DescribeCharacters(_level->FindCharacters(), radius));
+}
+
+ObjectCharacter::NearbyCharacters ObjectCharacter::GetCharactersInSight(void) const
+{
+  return (DescribeCharacters(field_of_view.GetDetectedCharacters(), -1));
+}
+
+// A negative radius keeps every character
+ObjectCharacter::NearbyCharacters ObjectCharacter::DescribeCharacters(const vector<ObjectCharacter*>& characters, float radius) const
+{
+  NearbyCharacters result;
+  NodePath         render   = _level->GetWindow()->get_render();
+  LPoint3f         position = GetNodePath().get_pos(render);
+
+  result.reserve(characters.size());
+  for (auto it = characters.begin() ; it != characters.end() ; ++it)
+  {
+    ObjectCharacter* character = *it;
+    float            distance  = (character->GetNodePath().get_pos(render) - position).length();
+
+    if (character != this && (radius < 0 || distance <= radius))
+    {
+      NearbyCharacter entry;
+
+      entry.character     = character;
+      entry.distance      = distance;
+      entry.hit_points    = character->GetHitPoints();
+      entry.action_points = character->GetActionPoints();
+      entry.faction       = character->GetFaction() ? (int)character->GetFaction()->id : -1;
+      entry.is_enemy      = IsEnemy(character);
+      entry.is_ally       = IsAlly(character);
+      entry.in_sight      = field_of_view.IsDetected(character);
+      result.push_back(entry);
+    }
+  }
+  sort(result.begin(), result.end(), [](const NearbyCharacter& a, const NearbyCharacter& b) { return (a.distance < b.distance); });
+  return (result);
+}
+
 /*
  * Script Communication
  */
@@ -553,53 +596,65 @@ void     ObjectCharacter::SetFaction(const std::string& name)
   WorldDiplomacy& diplomacy = GameTask::CurrentGameTask->GetDiplomacy();
 
   _faction = diplomacy.GetFaction(name);
-  debug.out() << "Faction pointer for " << name << " is " << _faction << endl;
+  LOG(Characters, Debug) << "Faction pointer for " << name << " is " << _faction;
 }
 
-void     ObjectCharacter::SetFaction(unsigned int flag)
+void     ObjectCharacter::SetFaction(unsigned int id)
 {
   WorldDiplomacy& diplomacy = GameTask::CurrentGameTask->GetDiplomacy();
 
-  _faction = diplomacy.GetFaction(flag);
+  _faction = diplomacy.GetFaction(id);
 }
 
 void     ObjectCharacter::SetAsEnemy(ObjectCharacter* other, bool enemy)
 {
-  if (_faction && other->GetFaction() != 0)
+  if (_faction && other->_faction)
   {
     WorldDiplomacy& diplomacy = GameTask::CurrentGameTask->GetDiplomacy();
 
-    debug.out() << "Factions are now enemies: " << GetFactionName() << " -> " << other->GetFactionName() << endl;
-    diplomacy.SetAsEnemy(enemy, _faction->flag, other->GetFaction());
-  }
-  else if (other->GetFaction() != 0)
-  {
-    if (enemy)
-      _self_enemyMask |= other->GetFaction();
-    else if (_self_enemyMask & other->GetFaction())
-      _self_enemyMask -= other->GetFaction();
+    LOG(Characters, Debug) << "Factions are now enemies: " << GetFactionName() << " -> " << other->GetFactionName();
+    diplomacy.SetAsEnemy(enemy, _faction->id, other->_faction->id);
   }
-  else if (GetFaction() != 0)
+  else if (other->_faction)
+    _self_enemies.Set(other->_faction->id, enemy);
+  else if (_faction)
     other->SetAsEnemy(this, enemy);
 }
 
 bool     ObjectCharacter::IsEnemy(const ObjectCharacter* other) const
 {
-  if (other->GetFaction() == 0 && _faction)
-    return (other->IsEnemy(this));
+  if (other->_faction == 0)
+    return (_faction && other->IsEnemy(this));
   if (_faction)
-    return ((_faction->enemyMask & other->GetFaction()) != 0);
-  return ((_self_enemyMask & other->GetFaction()) != 0);
+    return (_faction->IsEnemy(other->_faction->id));
+  return (_self_enemies.Test(other->_faction->id));
 }
 
 bool     ObjectCharacter::IsAlly(const ObjectCharacter* other) const
 {
-  return (_faction && _faction->flag == other->GetFaction());
+  return (_faction && _faction == other->_faction);
 }
 
 void ObjectCharacter::Unserialize(Utils::Packet& packet)
 {
-  packet >> _self_enemyMask >> _flags;
+  if (blob_revision >= 18)
+  {
+    std::vector<unsigned int> enemy_factions;
+
+    packet >> enemy_factions;
+    _self_enemies.Clear();
+    ForEach(enemy_factions, [this](unsigned int id) { _self_enemies.Set(id); });
+  }
+  else
+  {
+    unsigned int enemy_mask; // One bit per faction, up to 32 factions
+
+    packet >> enemy_mask;
+    _self_enemies.Clear();
+    for (unsigned int id = 0 ; id < 32 ; ++id)
+      _self_enemies.Set(id, ((enemy_mask >> id) & 1) != 0);
+  }
+  packet >> _flags;
   CharacterActionPoints::Unserialize(packet);
   if (GetHitPoints() <= 0)
     RunDeath();
@@ -607,6 +662,9 @@ void ObjectCharacter::Unserialize(Utils::Packet& packet)
 
 void ObjectCharacter::Serialize(Utils::Packet& packet)
 {
-  packet << _self_enemyMask << _flags;
+  std::vector<unsigned int> enemy_factions;
+
+  _self_enemies.ForEachSet([&enemy_factions](unsigned int id) { enemy_factions.push_back(id); });
+  packet << enemy_factions << _flags;
   CharacterActionPoints::Serialize(packet);
 }
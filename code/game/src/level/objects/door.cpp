@@ -3,7 +3,7 @@
 #include "level/level.hpp"
 #include <level/pathfinding/path.hpp>
 
-ObjectDoor::ObjectDoor(Level* level, DynamicObject* object): InstanceDynamicObject(level, object), Lockable(object)
+ObjectDoor::ObjectDoor(Level* level, DynamicObject* object): InstanceDynamicObject(level, object), Lockable(this)
 {
   _type             = ObjectTypes::Door;
   _closed           = true;
@@ -92,11 +92,13 @@ void ObjectDoor::SetOpened(bool set_open)
   if (set_open != _closed)
     PlayAnimation(set_open ? "open" : "close");
   _closed = !set_open;
+  MarkDirty();
 }
 
 void ObjectDoor::SetLocked(bool set_locked)
 {
     _object->locked = set_locked;
+    MarkDirty();
 }
 
 bool ObjectDoor::IsWayBlocked(void)
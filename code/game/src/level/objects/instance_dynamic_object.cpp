@@ -14,6 +14,7 @@ InstanceDynamicObject::InstanceDynamicObject(Level* level, DynamicObject* object
   _type                 = Other;
   _level                = level;
   _flags                = 0;
+  dirty                 = false;
   data_store            = new DataTree;
   idle_size             = NodePathSize(object->nodePath);
   waypoint_disconnected = object->lockedArcs;
@@ -73,16 +74,23 @@ void InstanceDynamicObject::Serialize(Utils::Packet& packet)
 
 void InstanceDynamicObject::SerializeDataStore(Utils::Packet& packet)
 {
-  string data_store_json;
-  
   DataTree::Writers::StringJSON(data_store, data_store_json);
   packet << data_store_json;
 }
 
-void InstanceDynamicObject::UnserializeDataStore(Utils::Packet& packet)
+// Scripts write in the data store through GetDataStore: its changes are found by comparing it with its last serialized state
+bool InstanceDynamicObject::IsDirty(void) const
 {
-  string data_store_json;
+  string current_json;
+
+  if (dirty)
+    return (true);
+  DataTree::Writers::StringJSON(data_store, current_json);
+  return (current_json != data_store_json);
+}
 
+void InstanceDynamicObject::UnserializeDataStore(Utils::Packet& packet)
+{
   packet >> data_store_json;
   if (data_store)
     delete data_store;
@@ -3,7 +3,7 @@
 
 using namespace std;
 
-ObjectLocker::ObjectLocker(Level* level, DynamicObject* object) : ObjectShelf(level, object), Lockable(object)
+ObjectLocker::ObjectLocker(Level* level, DynamicObject* object) : ObjectShelf(level, object), Lockable(this)
 {
   _type   = ObjectTypes::Locker;
   _closed = true;
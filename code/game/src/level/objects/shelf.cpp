@@ -10,6 +10,7 @@ ObjectShelf::ObjectShelf(Level* level, DynamicObject* object) : InstanceDynamicO
   _type   = ObjectTypes::Shelf;
   _inventory.LoadInventory(object);
   _inventory.SetCapacity(450);
+  _inventory.ContentChanged.Connect([this]() { MarkDirty(); });
 }
 
 void ObjectShelf::ActionUse(InstanceDynamicObject* object)
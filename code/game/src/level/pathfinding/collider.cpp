@@ -1,4 +1,5 @@
 #include "level/level.hpp"
+#include "logger.hpp"
 
 using namespace std;
 using namespace Pathfinding;
@@ -41,7 +42,7 @@ Path      Pathfinding::Collider::GetPathTowardsObject(Collider* character)
     character->ProcessCollisions();
   }
   else
-    cout << "Target has no waypoint" << endl;
+    LOG(Pathfinding, Warning) << "Target has no waypoint";
   return (path);
 }
 
@@ -86,7 +87,7 @@ void      Pathfinding::Collider::SetOccupiedWaypoint(Waypoint* wp)
 
       for (; it != end ; ++it)
       {
-        cout << "Setting light " << (*it)->nodePath.get_name() << endl;
+        LOG(Pathfinding, Debug) << "Setting light " << (*it)->nodePath.get_name();
         np.set_light((*it)->light->as_node());
       }
 //      waypoint_occupied->nodePath.reparent_to(Level::CurrentLevel->GetWorld()->window->get_render());
@@ -112,7 +113,7 @@ Waypoint* Pathfinding::Collider::GetClosestWaypointFrom(Collider* object, bool c
     {
       list<Waypoint*> list = self->GetSuccessors(other);
       
-      cout << "BestWaypoint choices: " << list.size() << endl;
+      LOG(Pathfinding, Debug) << "BestWaypoint choices: " << list.size();
       for_each(list.begin(), list.end(), [&wp, &currentDistance, other, closest](Waypoint* waypoint)
       {
         float compDistance = waypoint->GetDistanceEstimate(*other);
@@ -124,6 +125,6 @@ Waypoint* Pathfinding::Collider::GetClosestWaypointFrom(Collider* object, bool c
     }
     ProcessCollisions();
   }
-  cout << self->id << " versus " << wp->id << endl;
+  LOG(Pathfinding, Debug) << self->id << " versus " << wp->id;
   return (wp);
 }
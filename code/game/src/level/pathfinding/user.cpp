@@ -1,6 +1,8 @@
 #include "level/pathfinding/user.hpp"
 #include "level/level.hpp"
 #include "circular_value_set.hpp"
+#include "profiler.hpp"
+#include "logger.hpp"
 
 using namespace std;
 
@@ -95,11 +97,10 @@ void                Pathfinding::User::TeleportTo(Waypoint* waypoint)
 
 void                Pathfinding::User::GoTo(Waypoint* waypoint)
 {
-  PStatCollector collector("Level:Characters:Pathfinding");
-  Waypoint*      start_from = GetOccupiedWaypoint();
+  PROFILE_ZONE("Level:Characters:Pathfinding");
+  Waypoint* start_from = GetOccupiedWaypoint();
 
   current_target = Destination();
-  collector.start();
   ReachedDestination.DisconnectAll();
   UnprocessCollisions();
   current_user = this;
@@ -114,10 +115,9 @@ void                Pathfinding::User::GoTo(Waypoint* waypoint)
       StartRunAnimation();
   }
   else
-    cout << "Character " << GetName() << " doesn't have a waypointOccupied" << endl;
+    LOG(Pathfinding, Warning) << "Character " << GetName() << " doesn't have a waypointOccupied";
   current_user = 0;
   ProcessCollisions();
-  collector.stop();
 }
 
 void                Pathfinding::User::GoTo(InstanceDynamicObject* object, int min_distance)
@@ -237,14 +237,14 @@ void Pathfinding::User::RunNextMovement(float elapsedTime)
   }
   else
   {
-    cout << "Destination reached" << endl;
+    LOG(Pathfinding, Debug) << "Destination reached";
     TriggerDestinationReached();
   }
 }
 
 void Pathfinding::User::TriggerDestinationReached(void)
 {
-  cout << "Trigger destination reached" << endl;
+  LOG(Pathfinding, Debug) << "Trigger destination reached";
   path.Clear();
   ReachedDestination.Emit();
   ReachedDestination.DisconnectAll();
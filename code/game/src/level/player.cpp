@@ -4,6 +4,7 @@
 void Player::UnsetPlayer(void)
 {
   level.GetLevelUi().GetMainBar().SetStatistics(0);
+  level.GetTargetOutliner().UsePerspectiveOfCharacter(0);
   obs.DisconnectAll();
   player = 0;
 }
@@ -29,6 +30,9 @@ void Player::InitializePlayer(void)
   level.GetTargetOutliner().UsePerspectiveOfCharacter(player);
   player->GetFieldOfView().Launch();
   player->SetVisible(true);
+  obs.Connect(player->GetFieldOfView().CharacterDetected, [](ObjectCharacter* character) { character->SetVisible(true);  });
+  obs.Connect(player->GetFieldOfView().CharacterLost,     [](ObjectCharacter* character) { character->SetVisible(false); });
+  level.RefreshCharactersVisibility();
 }
 
 void Player::InitializeInteractions(void)
@@ -1,6 +1,7 @@
 #include "level/tasks/scripted_task.hpp"
 #include "level/objects/instance_dynamic_object.hpp"
 #include "level/level.hpp"
+#include "logger.hpp"
 
 using namespace std;
 
@@ -32,7 +33,7 @@ void ScriptedTask::Run(void)
     }
     catch (const std::exception& exception)
     {
-      cout << "[AngelScript][ScriptTask][" << name << "][Run] script crashed: " << exception.what() << endl;
+      LOG(Scripts, Error) << "[AngelScript][ScriptTask][" << name << "][Run] script crashed: " << exception.what();
     }
   }
   ScheduledTask::Run();
@@ -50,7 +51,7 @@ void ScriptedTask::Finalize(void)
     }
     catch (const std::exception& exception)
     {
-      cout << "[AngelScript][ScriptTask][" << name << "][Finalize] script crashed: " << exception.what() << endl;
+      LOG(Scripts, Error) << "[AngelScript][ScriptTask][" << name << "][Finalize] script crashed: " << exception.what();
     }
   }
 }
@@ -67,7 +68,7 @@ void ScriptedTask::Start(void)
     }
     catch (const std::exception& exception)
     {
-      cout << "[AngelScript][ScriptTask][" << name << "][Start] script crashed: " << exception.what() << endl;
+      LOG(Scripts, Error) << "[AngelScript][ScriptTask][" << name << "][Start] script crashed: " << exception.what();
     }
   }
 }
@@ -84,7 +85,7 @@ void ScriptedTask::NextTurn(void)
     }
     catch (const std::exception& exception)
     {
-      cout << "[AngelScript][ScriptTask][" << name << "][NextTurn] script crashed: " << exception.what() << endl;
+      LOG(Scripts, Error) << "[AngelScript][ScriptTask][" << name << "][NextTurn] script crashed: " << exception.what();
     }
   }
 }
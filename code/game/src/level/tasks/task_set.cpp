@@ -1,4 +1,5 @@
 #include "level/tasks/task_set.hpp"
+#include "level/objects/instance_dynamic_object.hpp"
 #include <executor.hpp>
 
 using namespace std;
@@ -22,6 +23,7 @@ ScriptedTask* TaskSet::PushTask(const string& name)
   {
     task = new ScriptedTask(name, target);
     insert(pair<string, ScriptedTask*>(name, task));
+    target->MarkDirty();
   }
   return (task);
 }
@@ -37,6 +39,7 @@ void TaskSet::RemoveTask(const string& name)
     // This needs to be delayed, in case the ScriptedTask itself is doing this
     Executor::ExecuteLater([task]() { delete task; });
     erase(it);
+    target->MarkDirty();
   }
 }
 
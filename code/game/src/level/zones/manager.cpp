@@ -1,6 +1,7 @@
 #include "level/zones/manager.hpp"
 #include <level/zones/exception.hpp>
 #include "level/level.hpp"
+#include "logger.hpp"
 #include <ui/alert_ui.hpp>
  
 using namespace std;
@@ -164,7 +165,7 @@ void Zones::Manager::InsertPartyInZone(Party& party, const string& zone)
   }
   catch (ZoneException exception)
   {
-    cerr << "Inserting party '" << party.GetName() << "': " << exception.what() << endl;
+    LOG(Map, Error) << "Inserting party '" << party.GetName() << "': " << exception.what();
     exception.Display();
   }
 }
@@ -179,7 +180,7 @@ void Zones::Manager::InsertObjectInZone(InstanceDynamicObject* object, const str
   }
   catch (ZoneException exception)
   {
-    cerr << "Inserting object '" << object->GetName() << "': " << exception.what() << endl;
+    LOG(Map, Error) << "Inserting object '" << object->GetName() << "': " << exception.what();
   }
 }
 
@@ -10,10 +10,14 @@
 #include "options.hpp"
 #include "scriptengine.hpp"
 #include "dices.hpp"
+#include "logger.hpp"
 
 void AngelScriptInitialize(void);
 int  compile_statsheet(std::string);
 int  compile_heightmap(const std::string& sourcefile, const std::string& out);
+int  compile_flatten(const std::string& map_name);
+int  convert_blobs(const std::vector<std::string>& paths);
+int  bench_level(const std::string& map_name, unsigned int frames);
 
 PandaFramework*      framework   = NULL;
 
@@ -30,17 +34,26 @@ int main(int argc, char *argv[])
   Script::Engine::Initialize(); // Script Engine initialization (obviously)
   AngelScriptInitialize();      // Registering script API (see script_api.cpp)
 
-  // With some options, game binary can also be used to compile statsheet or heightmaps.
+  // With some options, game binary can also be used to compile statsheet, heightmaps or flattened maps,
+  // to convert map blobs to the current revision, or to benchmark a level without a window.
   // If used as compiler of some sort
   if (argc == 3 && std::string(argv[1]) == "--compile-statsheet")
     return (compile_statsheet(argv[2]));
   if (argc == 4 && std::string(argv[1]) == "--compile-heightmap")
     return (compile_heightmap(argv[2], argv[3]));
+  if (argc == 3 && std::string(argv[1]) == "--compile-flatten")
+    return (compile_flatten(argv[2]));
+  if (argc >= 3 && std::string(argv[1]) == "--convert-blob")
+    return (convert_blobs(std::vector<std::string>(argv + 2, argv + argc)));
+  if (argc == 5 && std::string(argv[1]) == "--bench-level" && std::string(argv[3]) == "--frames")
+    return (bench_level(argv[2], atoi(argv[4])));
   // Otherwise run the game
   {
     WindowFramework* window;
     ConfigPage*      config = load_prc_file("config.prc");
 
+    Logger::Initialize();         // Logs are written by their own thread from now on
+
     cout << "[FoE] Loading configuration" << endl;
 # ifdef PSTAT_ENABLED
     if (!(PStatClient::connect("localhost", 5185))) // Initialize client for profiling collector
@@ -86,7 +99,8 @@ int main(int argc, char *argv[])
     cout << "[FoE] Properly wrapping up." << endl;
     OptionsManager::Finalize();
     Script::Engine::Finalize();
+    Logger::Finalize();
   }
   return (0);
 }
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "musicmanager.hpp"
 #include "options.hpp"
+#include "dices.hpp"
 
 using namespace std;
 
@@ -95,7 +96,7 @@ void MusicManager::PlayNext(void)
   }
   else
   {
-    selected = rand() % max;
+    selected = Dices::Get(Dices::Global).Below(max);
     Play(_current_category, category[selected].Key());
   }
 }
@@ -183,13 +183,13 @@ void UiNewGame::GoToProfile(const string& profile)
   Core::Element* cons        = root->GetElementById("character-cons");
   
   name->SetInnerRML       (profiles[profile]["Name"].Value().c_str());
-  description->SetInnerRML(profiles[profile]["Description"].Value().c_str());
+  Rocket::ParseInnerRML(description, profiles[profile]["Description"].Value().c_str());
   pros->SetInnerRML       (profiles[profile]["Pros"].Value().c_str());
   cons->SetInnerRML       (profiles[profile]["Cons"].Value().c_str());
   
   string rml = "<img src='newgame/" + profiles[profile]["Image"].Value() + "' style='width: 100%; height: 100%;' />";
   Core::Element* image = root->GetElementById("background-image");
-  image->SetInnerRML(rml.c_str());
+  Rocket::ParseInnerRML(image, rml.c_str());
 }
 
 void UiNewGame::SelectedProfile(Rocket::Core::Event&)
@@ -23,7 +23,7 @@ void PipbuckClockApp::Focused(Rocket::Core::Element* root, DataEngine& de)
 {
   _minutes_to_spend = 0;
   
-  root->SetInnerRML(_inner_rml.c_str());
+  Rocket::ParseInnerRML(root, _inner_rml.c_str());
   
   _span_error = root->GetElementById("span-error");
 
@@ -106,7 +106,7 @@ void PipbuckClockApp::WaitChange(int change)
       {
         strvalue << value;
         _selected_wait->SetAttribute<int>("data-value", value);
-        _selected_wait->SetInnerRML(strvalue.str().c_str());
+        Rocket::ParseInnerRML(_selected_wait, strvalue.str().c_str());
       }
     }
   }
@@ -133,7 +133,7 @@ void PipbuckClockApp::SetValue(Rocket::Core::Element* element, unsigned short va
   stringstream strval;
   
   strval << value;
-  element->SetInnerRML(strval.str().c_str());
+  Rocket::SetInnerRML(element, strval.str());
 }
 
 void PipbuckClockApp::RunAsMainTask(Rocket::Core::Element* root, DataEngine& de)
@@ -152,13 +152,13 @@ void PipbuckClockApp::RunAsMainTask(Rocket::Core::Element* root, DataEngine& de)
      {
        if (Level::CurrentLevel->GetState() == Level::Fight)
        {
-        _span_error->SetInnerRML(i18n::T("You can't wait while fighting").c_str());
+        Rocket::ParseInnerRML(_span_error, i18n::T("You can't wait while fighting").c_str());
         _minutes_to_spend = 0;
         return ;
        }
        Level::CurrentLevel->SetState(Level::Interrupted);
      }
-     _span_error->SetInnerRML("");
+     Rocket::ParseInnerRML(_span_error, "");
      if (_minutes_to_spend > 60)
      {
          _time_manager.AddElapsedTime(DateTime::Hours(1));
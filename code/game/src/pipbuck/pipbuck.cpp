@@ -256,7 +256,7 @@ void Pipbuck::ReloadApps(void)
   });
   rml << "</div>";
   if (elem)
-    elem->SetInnerRML(rml.str().c_str());
+    Rocket::ParseInnerRML(elem, rml.str().c_str());
   for (unsigned int i = 0 ; i < iterator ; ++i)
   {
     stringstream id;
@@ -66,7 +66,7 @@ void PipbuckQuestApp::LoadQuestList(Rocket::Core::Element* root)
   Rocket::Core::Element* quest_list;
   
   _root = root;
-  root->SetInnerRML(_rml_index.c_str());
+  Rocket::ParseInnerRML(root, _rml_index.c_str());
   quest_list = root->GetElementById("quest_containers");
   if (quest_list)
   {
@@ -87,7 +87,7 @@ void PipbuckQuestApp::LoadQuestList(Rocket::Core::Element* root)
       rml << "  <div class='quest-prog'>" << (completed ? "Done" : "In progress") << "</div>";
       rml << "</div>";
     });
-    quest_list->SetInnerRML(rml.str().c_str());
+    Rocket::ParseInnerRML(quest_list, rml.str().c_str());
     
     std::for_each(quests.begin(), quests.end(), [this, quest_list](Data quest)
     {
@@ -149,7 +149,7 @@ void PipbuckQuestApp::LoadQuestView(Rocket::Core::Element* root)
   {
     _last_hovered = 0;
     _current_view = QuestView;
-    root->SetInnerRML(_rml_view.c_str());
+    Rocket::ParseInnerRML(root, _rml_view.c_str());
     {
       std::stringstream      html;
       Data                   objectives = quest["objectives"];
@@ -159,9 +159,9 @@ void PipbuckQuestApp::LoadQuestView(Rocket::Core::Element* root)
       Rocket::Core::Element* back_button= root->GetElementById("back_button");
 
       if (elem_title)
-        elem_title->SetInnerRML(i18n::T(quest.Key()).c_str());
+        Rocket::ParseInnerRML(elem_title, i18n::T(quest.Key()).c_str());
       if (elem_desc)
-        elem_desc->SetInnerRML(i18n::T(quest["description"].Value()).c_str());
+        Rocket::ParseInnerRML(elem_desc, i18n::T(quest["description"].Value()).c_str());
       back_button->AddEventListener("click", &EventBackClicked);
       
       for_each(objectives.begin(), objectives.end(), [&html](Data objective)
@@ -187,7 +187,7 @@ void PipbuckQuestApp::LoadQuestView(Rocket::Core::Element* root)
         html << objective["description"].Value() << "</div>";
         html << "</div>";
       });
-      elem_objs->SetInnerRML(html.str().c_str());
+      Rocket::ParseInnerRML(elem_objs, html.str().c_str());
     }
   }
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "scriptengine.hpp"
 #include "dataengine.hpp"
+#include "data_path.hpp"
 
 #include "gametask.hpp"
 #include "quest_manager.hpp"
@@ -22,12 +23,12 @@
  */
 #include "timer.hpp"
 #include "executor.hpp"
+#include "dices.hpp"
+#include "profiler.hpp"
 
 //#include "gameui.hpp"
 #include "ui/alert_ui.hpp"
-#include "debuginfo.hpp"
-
-DebugInfo warning, info, debug;
+#include "logger.hpp"
 
 void ScriptApiDeclareFunction(const std::string& name, const std::string& decl)
 {
@@ -351,7 +352,22 @@ namespace ScriptApi
 
 void AngelCout(const std::string& str)
 {
-  std::cout << "[AngelScript][Output] " << str << std::endl;
+  LOG(Scripts, Info) << str;
+}
+
+void EnableProfiler(bool set)
+{
+  Profiler::SetEnabled(set);
+  GameConsole::WriteOn(set ? "Profiler enabled" : "Profiler disabled");
+}
+
+// Open the file with chrome://tracing
+void ExportProfile(const std::string& path)
+{
+  if (Profiler::ExportChromeTrace(path))
+    GameConsole::WriteOn("Profile written to " + path);
+  else
+    GameConsole::WriteOn("Can't write profile to " + path);
 }
 
 namespace asData
@@ -372,14 +388,34 @@ namespace asData
   float       getAsFloat(Data* obj)                               { return (obj && obj->NotNil() ? (float)*obj : 0.f);  }
 }
 
+namespace asDataPath
+{
+  void Constructor(void* memory)                                    { new(memory) DataPath();           }
+  void ConstructorFromString(const std::string& path, void* memory) { new(memory) DataPath(path);       }
+  void Destructor (void* memory)                                    { ((DataPath*)memory)->~DataPath(); }
+}
+
 namespace asUtils
 {
-  void SetDebugOutputEnabled(bool enabled) { debug.set_enabled(enabled); }
+  void SetDebugOutputEnabled(bool enabled)
+  {
+    Logger::SetLevel(Logger::Characters, enabled ? Logger::Debug : Logger::Info);
+    Logger::SetLevel(Logger::Ai,         enabled ? Logger::Debug : Logger::Info);
+  }
+
+  // Category and severity names are the ones written before each line (such as SetLogLevel("Pathfinding", "Warning"))
+  void SetLogLevel(const std::string& category, const std::string& severity)
+  {
+    if (!(Logger::SetLevel(category, severity)))
+      AlertUi::NewAlert.Emit("Unknown log category or severity: " + category + ", " + severity);
+  }
 
   InstanceDynamicObject* CharacterAsObject(ObjectCharacter* character)    { return (character); }
   ObjectCharacter*       DynObjAsCharacter(InstanceDynamicObject* object) { return (object->Get<ObjectCharacter>()); }
   ObjectDoor*            DynObjAsDoor(InstanceDynamicObject* object)      { return (object->Get<ObjectDoor>()); }
-  Data                   ItemAsData(InventoryObject* item)                { return (*item); }
+  Data                   ItemAsData(InventoryObject* item)                { item->MakeUnique(); return (*item); }
+  // Items share the data of their template until written in: writing through this would change every such item
+  Data                   ItemAsReadOnlyData(InventoryObject* item)        { return (*item); }
 
   list<InstanceDynamicObject*> GetObjectsInRadius(Level* self, float x, float y, float z, float radius)
   {
@@ -395,7 +431,7 @@ namespace asUtils
 
   std::string            RocketGetId(Rocket::Core::Element* self)                            { return (self->GetId().CString());          }
   Rocket::Core::Element* RocketGetElementById(Rocket::Core::Element* self, const string& id) { return (self->GetElementById(id.c_str())); }
-  void                   RocketSetInnerRML(Rocket::Core::Element* self, const string& rml)   { return (self->SetInnerRML(rml.c_str()));   }
+  void                   RocketSetInnerRML(Rocket::Core::Element* self, const string& rml)   { Rocket::ParseInnerRML(self, rml);            }
 
   void GoTo(int x, int y, int z, ObjectCharacter* character)
   {
@@ -462,6 +498,13 @@ namespace asUtils
       if (level)
         level->GetCombat().NextTurn();
     }
+
+    ObjectCharacter* SelectTarget(Level* level, ObjectCharacter* character)
+    {
+      if (level && character)
+        return (level->GetCombat().SelectTarget(character));
+      return (0);
+    }
     
     bool StopFight(Level* level)
     {
@@ -515,12 +558,15 @@ void AngelScriptInitialize(void)
   Script::Engine::ScriptError.Connect(asConsole, &asConsoleOutput::OutputError);
   
   engine->RegisterGlobalFunction("void SetDebugOutputEnabled(bool)", asFUNCTION(asUtils::SetDebugOutputEnabled), asCALL_CDECL);
+  engine->RegisterGlobalFunction("void SetLogLevel(const string &in, const string &in)", asFUNCTION(asUtils::SetLogLevel), asCALL_CDECL);
   engine->RegisterGlobalFunction("void Cout(string)", asFUNCTION(AngelCout), asCALL_CDECL);
   engine->RegisterGlobalFunction("void LF()", asFUNCTION( GameConsole::ListFunctions ), asCALL_CDECL);
   engine->RegisterGlobalFunction("void PrintScenegraph()", asFUNCTION( GameConsole::PrintScenegraph ), asCALL_CDECL);
+  engine->RegisterGlobalFunction("void EnableProfiler(bool)",  asFUNCTION(EnableProfiler), asCALL_CDECL);
+  engine->RegisterGlobalFunction("void ExportProfile(string)", asFUNCTION(ExportProfile),  asCALL_CDECL);
   engine->RegisterGlobalFunction("void Write(const string &in)", asFUNCTION(GameConsole::WriteOn), asCALL_CDECL);
   engine->RegisterGlobalFunction("void SetLanguage(const string& in)", asFUNCTION(i18n::Load), asCALL_CDECL);
-  engine->RegisterGlobalFunction("int  Random()", asFUNCTION(rand), asCALL_CDECL);
+  engine->RegisterGlobalFunction("int  Random()", asFUNCTION(Dices::Random), asCALL_CDECL);
   engine->RegisterGlobalFunction("int ceil(float)", asFUNCTION(asUtils::ceil), asCALL_CDECL);
   engine->RegisterGlobalFunction("int floor(float)", asFUNCTION(asUtils::floor), asCALL_CDECL);
 
@@ -613,6 +659,14 @@ void AngelScriptInitialize(void)
   engine->RegisterObjectMethod   (dataClass, "void   Output()",                asMETHOD(Data,Output),              asCALL_THISCALL);
   engine->RegisterObjectMethod   (dataClass, "void   Remove()",                asMETHOD(Data,Remove),              asCALL_THISCALL);
 
+  const char* dataPathClass = "DataPath";
+  engine->RegisterObjectType     (dataPathClass, sizeof(DataPath), asOBJ_VALUE | asOBJ_APP_CLASS_CDA);
+  engine->RegisterObjectBehaviour(dataPathClass, asBEHAVE_CONSTRUCT, "void f()",                   asFUNCTION(asDataPath::Constructor),           asCALL_CDECL_OBJLAST);
+  engine->RegisterObjectBehaviour(dataPathClass, asBEHAVE_CONSTRUCT, "void f(const string &in)",   asFUNCTION(asDataPath::ConstructorFromString), asCALL_CDECL_OBJLAST);
+  engine->RegisterObjectBehaviour(dataPathClass, asBEHAVE_DESTRUCT,  "void f()",                   asFUNCTION(asDataPath::Destructor),            asCALL_CDECL_OBJLAST);
+  engine->RegisterObjectMethod   (dataPathClass, "DataPath &opAssign(const DataPath &in)", asMETHODPR(DataPath,operator=, (const DataPath&), DataPath&), asCALL_THISCALL);
+  engine->RegisterObjectMethod   (dataPathClass, "Data From(Data)",                        asMETHOD(DataPath,From),                                  asCALL_THISCALL);
+
   const char* statsheetClass = "Special";
   engine->RegisterObjectType(statsheetClass, 0, asOBJ_REF | asOBJ_NOCOUNT);
   engine->RegisterObjectMethod(statsheetClass, "void SetCurrentHp(int)",          asMETHOD(StatController,SetCurrentHp),    asCALL_THISCALL);
@@ -671,6 +725,7 @@ void AngelScriptInitialize(void)
 
   engine->RegisterObjectMethod(itemClass, "string GetName() const",                                asMETHOD(InventoryObject,GetName),               asCALL_THISCALL);
   engine->RegisterObjectMethod(itemClass, "Data   AsData()",                                       asFUNCTION(asUtils::ItemAsData),                 asCALL_CDECL_OBJFIRST);
+  engine->RegisterObjectMethod(itemClass, "Data   AsReadOnlyData()",                               asFUNCTION(asUtils::ItemAsReadOnlyData),         asCALL_CDECL_OBJFIRST);
   engine->RegisterObjectMethod(itemClass, "bool   IsWeapon() const",                               asMETHOD(InventoryObject,IsWeapon),              asCALL_THISCALL);
   engine->RegisterObjectMethod(itemClass, "int    HitSuccessRate(Character@, Character@, string)", asFUNCTION(ScriptApi::Item::HitSuccessRate),     asCALL_CDECL_OBJFIRST);
   engine->RegisterObjectMethod(itemClass, "bool   UseWeaponOn(Character@, Character@, string)",    asFUNCTION(ScriptApi::Item::UseAsWeapon),        asCALL_CDECL_OBJFIRST);
@@ -690,6 +745,20 @@ void AngelScriptInitialize(void)
   engine->RegisterObjectMethod(charClass, "CharacterList GetNearbyAllies()",  asMETHOD(ObjectCharacter,GetNearbyAllies),  asCALL_THISCALL);
   engine->RegisterObjectMethod(charClass, "CharacterList GetNearbyEnemies()", asMETHOD(ObjectCharacter,GetNearbyEnemies), asCALL_THISCALL);
 
+  const char* nearbyCharacterClass = "NearbyCharacter";
+  engine->RegisterObjectType(nearbyCharacterClass, sizeof(ObjectCharacter::NearbyCharacter), asOBJ_VALUE | asOBJ_POD | asOBJ_APP_CLASS_C);
+  engine->RegisterObjectProperty(nearbyCharacterClass, "Character@ character",     asOFFSET(ObjectCharacter::NearbyCharacter,character));
+  engine->RegisterObjectProperty(nearbyCharacterClass, "float      distance",      asOFFSET(ObjectCharacter::NearbyCharacter,distance));
+  engine->RegisterObjectProperty(nearbyCharacterClass, "int        hit_points",    asOFFSET(ObjectCharacter::NearbyCharacter,hit_points));
+  engine->RegisterObjectProperty(nearbyCharacterClass, "int        action_points", asOFFSET(ObjectCharacter::NearbyCharacter,action_points));
+  engine->RegisterObjectProperty(nearbyCharacterClass, "int        faction",       asOFFSET(ObjectCharacter::NearbyCharacter,faction));
+  engine->RegisterObjectProperty(nearbyCharacterClass, "bool       is_enemy",      asOFFSET(ObjectCharacter::NearbyCharacter,is_enemy));
+  engine->RegisterObjectProperty(nearbyCharacterClass, "bool       is_ally",       asOFFSET(ObjectCharacter::NearbyCharacter,is_ally));
+  engine->RegisterObjectProperty(nearbyCharacterClass, "bool       in_sight",      asOFFSET(ObjectCharacter::NearbyCharacter,in_sight));
+  ObjectCharacter::NearbyCharacters::Register(engine, "NearbyCharacters", nearbyCharacterClass);
+  engine->RegisterObjectMethod(charClass, "NearbyCharacters GetCharactersInRadius(float) const", asMETHOD(ObjectCharacter,GetCharactersInRadius), asCALL_THISCALL);
+  engine->RegisterObjectMethod(charClass, "NearbyCharacters GetCharactersInSight() const",      asMETHOD(ObjectCharacter,GetCharactersInSight),  asCALL_THISCALL);
+
   Script::StdList<ObjectCharacter*>::Register(engine, "ObjectList", "DynamicObject@");
   engine->RegisterObjectMethod(dynObjectClass, "ObjectList GetObjectsInRadius(float)",          asMETHOD(InstanceDynamicObject,GetObjectsInRadius), asCALL_THISCALL);
   engine->RegisterObjectMethod(dynObjectClass, "float GetDistance()",                           asMETHOD(InstanceDynamicObject,GetDistance),        asCALL_THISCALL);
@@ -728,6 +797,9 @@ void AngelScriptInitialize(void)
   engine->RegisterObjectMethod(charClass, "float GetDistance(DynamicObject@)",        asMETHOD(ObjectCharacter,GetDistance), asCALL_THISCALL);
   engine->RegisterObjectMethod(charClass, "Inventory@ GetInventory()",                asMETHODPR(ObjectCharacter,GetInventory, (), Inventory&), asCALL_THISCALL);
   engine->RegisterObjectMethod(charClass, "Data GetStatistics()",                     asMETHOD(ObjectCharacter,GetStatistics), asCALL_THISCALL);
+  engine->RegisterObjectMethod(charClass, "int  GetSpecial(const string &in) const",   asMETHOD(ObjectCharacter,GetSpecial),   asCALL_THISCALL);
+  engine->RegisterObjectMethod(charClass, "int  GetSkill(const string &in) const",     asMETHOD(ObjectCharacter,GetSkill),     asCALL_THISCALL);
+  engine->RegisterObjectMethod(charClass, "int  GetStatistic(const string &in) const", asMETHOD(ObjectCharacter,GetStatistic), asCALL_THISCALL);
   //MSVC2010 strangeness for this function: Base/Derived thingymajig complications
   engine->RegisterObjectMethod(charClass, "int  GetCurrentWaypoint() const",          asFUNCTION(ScriptApi::Character::GetCurrentWaypoint), asCALL_CDECL_OBJFIRST);
   engine->RegisterObjectMethod(charClass, "int  GetPathSize() const",                 asFUNCTION(ScriptApi::Character::GetPathSize), asCALL_CDECL_OBJFIRST);
@@ -824,6 +896,7 @@ void AngelScriptInitialize(void)
   engine->RegisterObjectMethod(levelClass, "void           StartFight(Character@)",                asFUNCTION(asUtils::Combat::StartFight),asCALL_CDECL_OBJFIRST);
   engine->RegisterObjectMethod(levelClass, "void           StopFight()",                           asFUNCTION(asUtils::Combat::StopFight), asCALL_CDECL_OBJFIRST);
   engine->RegisterObjectMethod(levelClass, "void           NextTurn()",                            asFUNCTION(asUtils::Combat::NextTurn),  asCALL_CDECL_OBJFIRST);
+  engine->RegisterObjectMethod(levelClass, "Character@     SelectTarget(Character@)",              asFUNCTION(asUtils::Combat::SelectTarget), asCALL_CDECL_OBJFIRST);
   engine->RegisterObjectMethod(levelClass, "Sound@         PlaySound(string)",                     asMETHOD(Level,PlaySound),              asCALL_THISCALL);
 
   engine->RegisterObjectMethod(levelClass, "void SunlightSetNearFar(float, float)", asFUNCTION(asUtils::LevelUtils::SunlightNearFar), asCALL_CDECL_OBJFIRST);
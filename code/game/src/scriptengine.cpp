@@ -1,4 +1,5 @@
 #include "scriptengine.hpp"
+#include "profiler.hpp"
 #include <iostream>
 #include <sstream>
 
@@ -160,6 +161,7 @@ void AngelScript::Object::asDefineMethod(const std::string& name, const std::str
 
 AngelScript::Object::ReturnType AngelScript::Object::Call(const std::string name, unsigned int argc, ...)
 {
+  PROFILE_ZONE("Script:Call");
   ContextLock context_lock(context, module, this);
   va_list     ap;
   auto        it                 = functions.find(name);
@@ -13,7 +13,7 @@ AlertUi::AlertUi(WindowFramework* window, Core::Context* context, const string&
   {
     Core::Element* elem_message = root->GetElementById("message");
 
-    elem_message->SetInnerRML(message.c_str());
+    Rocket::ParseInnerRML(elem_message, message.c_str());
     ToggleEventListener(true, "button-ok", "click", ButtonClicked);
     ButtonClicked.EventReceived.Connect([this](Core::Event&) { _continue = false; });
   }
@@ -1,5 +1,6 @@
 #include "ui/game_console.hpp"
 #include "scriptengine.hpp"
+#include "logger.hpp"
 #include <scripthelper/scripthelper.h>
 #include <sstream>
 #include <Rocket/Controls.h>
@@ -134,6 +135,7 @@ void GameConsole::Execute(Rocket::Core::Event&)
 
 void GameConsole::WriteOn(const std::string& str)
 {
+  LOG(Console, Info) << str;
   GConsole->Output("<span class='console-write'>[Write]</span><span class='console-write-output'> " + str + "</span>");
 }
 
@@ -144,7 +146,7 @@ void GameConsole::Output(const std::string str)
 
   element->GetInnerRML(string);
   string  = (str + "<br />" + string.CString()).c_str();
-  element->SetInnerRML(string);
+  Rocket::ParseInnerRML(element, string);
 }
 
 void GameConsole::KeyUp(Rocket::Core::Event& event)
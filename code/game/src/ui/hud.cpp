@@ -89,7 +89,7 @@ void GameMainBar::AppendToConsole(const std::string& str)
       toAdd  = "<li>- ";
       toAdd += str.c_str();
       toAdd += "</li><br />";
-      console->SetInnerRML(toAdd + rml);
+      Rocket::ParseInnerRML(console, toAdd + rml);
     }
   }
 }
@@ -105,7 +105,7 @@ void GameMainBar::SetCurrentHp(short hp)
       stringstream rml;
 
       rml << hp;
-      elem_hp->SetInnerRML(rml.str().c_str());
+      Rocket::SetInnerRML(elem_hp, rml.str());
     }
   }
 }
@@ -121,15 +121,17 @@ void GameMainBar::SetCurrentAc(short ac)
       stringstream rml;
 
       rml << ac;
-      elem_ac->SetInnerRML(rml.str().c_str());
+      Rocket::SetInnerRML(elem_ac, rml.str());
     }
   }
 }
 
 void GameMainBar::SetCurrentAP(unsigned short ap, unsigned short max)
 {
-  SetMaxAP(max);
-  if (_apEnabled && root)
+  _apMax = max;
+  if (!_apEnabled)
+    SetMaxAP(max);
+  else if (root)
   {
     Rocket::Core::Element* apbar = root->GetElementById("action_points");
     string                 rml;
@@ -140,7 +142,7 @@ void GameMainBar::SetCurrentAP(unsigned short ap, unsigned short max)
 	rml += "<img class='img-ap'   height='20px' src='../textures/ap-active.png' /> ";
       for (unsigned short i = ap ; i < _apMax ; ++i)
 	rml += "<img class='img-ap' height='20px' src='../textures/ap-inactive.png' /> ";
-      apbar->SetInnerRML(rml.c_str());
+      Rocket::SetInnerRML(apbar, rml);
     }
   }
 }
@@ -157,7 +159,7 @@ void GameMainBar::SetMaxAP(unsigned short ap)
     {
       for (unsigned short i = 0 ; i < ap ; ++i)
         rml += "<img class='img-ap' src='../textures/ap-inactive.png' /> ";
-      apbar->SetInnerRML(rml.c_str());
+      Rocket::SetInnerRML(apbar, rml);
     }
   }
 }
@@ -219,7 +221,7 @@ void GameMainBar::SetEquipedItemAction(unsigned short it, InventoryObject* item,
       if (actionExists) rml << "<p class='equiped_action'>" << (*item)["actions"][actionIt].Key() << "</p>";
       rml << "<p class='equiped_image'><img src='../textures/itemIcons/" << (*item)["icon"].Value() << "' /></p>";
       if (actionExists) rml << "<p class='equiped_apcost'>" << (*item)["actions"][actionIt]["ap-cost"].Value() << "AP</p>";
-      elem->SetInnerRML(rml.str().c_str());
+      Rocket::SetInnerRML(elem, rml.str());
     }
   }
 }
@@ -32,7 +32,7 @@ GameInventory::GameInventory(WindowFramework* window, Rocket::Core::Context* con
     {
       Rocket::Core::Element* item = root->CreateElement("invitem");
 
-      item->SetInnerRML("<img src=\"item.png\" class='inventory-item' />");
+      Rocket::ParseInnerRML(item, "<img src=\"item.png\" class='inventory-item' />");
       itemListContainer->AppendChild(item);
     }
     
@@ -135,7 +135,7 @@ void GameInventory::SetEquipedItem(unsigned short slot, InventoryObject* item)
           rml << "'><img src='../textures/itemIcons/" << (*item)["icon"].Value() << "' />";
         rml << "</p>";
       }
-      element->SetInnerRML(rml.str().c_str());
+      Rocket::ParseInnerRML(element, rml.str().c_str());
     }
   }
   else
@@ -171,7 +171,7 @@ void GameInventory::UpdateInventoryCapacity(void)
     stringstream stream;
     
     stream << "Weight: " << (int)(_inventory->GetCurrentWeight()) << " / " << (int)(_inventory->GetCapacity()) << " kg";
-    capacity->SetInnerRML(stream.str().c_str());
+    Rocket::SetInnerRML(capacity, stream.str());
   }
 }
 
@@ -183,9 +183,9 @@ void GameInventory::SetSelectedObject(InventoryObject* inventory)
   if (itemDescription)
   {
     if (_selectedObject == 0)
-      itemDescription->SetInnerRML(i18n::T("Click on an object to get a description.").c_str());
+      Rocket::ParseInnerRML(itemDescription, i18n::T("Click on an object to get a description.").c_str());
     else
-      itemDescription->SetInnerRML(_selectedObject->GetName().c_str());
+      Rocket::ParseInnerRML(itemDescription, _selectedObject->GetName().c_str());
   }
 }
 
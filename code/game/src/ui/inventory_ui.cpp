@@ -27,6 +27,10 @@ Sync::Signal<void (InventoryObject*)>                       ObjectSelected;
 Sync::Signal<void (InventoryObject*)>                       ObjectMenuRequested;
 Sync::Signal<void (InventoryObject*)>                       ObjectFocused;
 
+/*
+ * Views are updated in place while they display the same items in the same order: only the cells whose
+ * quantity or position changed are parsed again. Other changes rebuild the whole view.
+ */
 void InventoryView::UpdateView(void)
 {
   Inventory::Content&          content = _inventory.GetContent();
@@ -34,53 +38,35 @@ void InventoryView::UpdateView(void)
   Inventory::Content::iterator end     = content.end();
   std::string                  rml;
   unsigned short               count;
+  Groups                       groups;
+  Displayed                    displayed;
+  std::vector<std::string>     cell_ids, cell_rmls;
 
-  Destroy();
+  // Unequiped items are displayed once per type, with the first of them
+  for (; it != end ; ++it)
+  {
+    if (!((*it)->IsEquiped()))
+    {
+      Group& group = groups[(*it)->GetName()];
+
+      if (group.second++ == 0)
+        group.first = *it;
+    }
+  }
 
-  for (count = 0 ; it != end ; ++it, ++count)
+  for (it = content.begin(), count = 0 ; it != end ; ++it, ++count)
   {
     InventoryObject&  item = *(*it);
 
     if (!(item.IsHidden() || item.IsEquiped()))
     {
-      std::stringstream stream;
-      bool              notVisible = false;
-      unsigned short    quantity   = 1;
-
-      // Look for groupable objects
-      {
-        Inventory::Content::iterator groupIt     = content.begin();
-        Inventory::Content::iterator groupEnd    = content.end();
-        bool                         hideIfFound = true;
-
-        for (; groupIt != groupEnd ; ++groupIt)
-        {
-          if (groupIt == it)
-          {
-            hideIfFound = false;
-            continue ;
-          }
-          if ((*groupIt)->IsGroupableWith(*it))
-          {
-            if ((*groupIt)->IsEquiped())
-              continue ;
-            if (hideIfFound)
-            {
-              notVisible = true;
-              break ;
-            }
-            quantity++;
-          }
-        }
-      }
+      std::stringstream stream, id;
+      const Group&      group      = groups[item.GetName()];
+      bool              notVisible = group.first != &item;
+      unsigned short    quantity   = group.second;
 
       if (!notVisible)
       {
-        stream << "<span class='inventory-item-icon";
-#ifdef INVENTORY_USE_DRAGDROP
-        stream << " inventory-item-draggable";
-#endif
-        stream << "' id='" << count << "'>";
         stream << "<img src='../textures/itemIcons/";
         if (item["icon"].Value() != "")
           stream << item["icon"].Value();
@@ -89,15 +75,40 @@ void InventoryView::UpdateView(void)
         stream << "' />";
         if (quantity > 1)
           stream << "<span class='inventory-item-quantity'>x" << quantity << "</span>";
-        stream << "</span>";
-        rml += stream.str();
+        id << count;
+        displayed.push_back(&item);
+        cell_ids.push_back(id.str());
+        cell_rmls.push_back(stream.str());
       }
     }
   }
-  _element.SetInnerRML(rml.c_str());
+
+  if (displayed == _displayed && _element.GetNumChildren() == (int)displayed.size())
+  {
+    for (unsigned short i = 0 ; i < displayed.size() ; ++i)
+    {
+      Rocket::SetAttribute(_element.GetChild(i), "id", cell_ids[i]);
+      Rocket::SetInnerRML(_element.GetChild(i), cell_rmls[i]);
+    }
+    return ;
+  }
+
+  Destroy();
+  for (unsigned short i = 0 ; i < displayed.size() ; ++i)
+  {
+    rml += "<span class='inventory-item-icon";
+#ifdef INVENTORY_USE_DRAGDROP
+    rml += " inventory-item-draggable";
+#endif
+    rml += "' id='" + cell_ids[i] + "'>";
+    rml += cell_rmls[i] + "</span>";
+  }
+  Rocket::ParseInnerRML(&_element, rml);
+  _displayed = displayed;
   
   for (unsigned short i = 0 ; i < _element.GetNumChildren() ; ++i)
   {
+    Rocket::SetAttribute(_element.GetChild(i), "data-rml", cell_rmls[i]);
     _element.GetChild(i)->AddEventListener("dblclick",  this);
     _element.GetChild(i)->AddEventListener("mouseover", this);
     _element.GetChild(i)->AddEventListener("click",     this);
@@ -114,6 +125,7 @@ void             InventoryView::Destroy()
     element->RemoveEventListener("mouseover", this);
     element->RemoveEventListener("click",     this);
   }
+  _displayed.clear();
 }
 
 InventoryObject* InventoryView::GetObjectFromId(const std::string& id)
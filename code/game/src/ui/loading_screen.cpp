@@ -60,7 +60,7 @@ void LoadingScreen::DoAppendText(const std::string& str)
 
     input->GetInnerRML(content);
     content = Core::String(content + "<br />" + str.c_str());
-    input->SetInnerRML(content);
+    Rocket::ParseInnerRML(input, content);
   }
   Post();
   Refresh();
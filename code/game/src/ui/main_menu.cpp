@@ -1,4 +1,5 @@
 #include "ui/game_menu.hpp"
+#include <sstream>
 
 using namespace std;
 using namespace Rocket;
@@ -28,6 +29,25 @@ GameMenu::GameMenu(WindowFramework* window, Rocket::Core::Context* context) : Ui
   }
 }
 
+// The save button shows the progress of the save being written
+void GameMenu::SetSaveProgress(float progress)
+{
+  if (root)
+  {
+    Rocket::Core::Element* elem_save = root->GetElementById("save");
+
+    if (elem_save)
+    {
+      stringstream rml;
+
+      rml << i18n::T("Save");
+      if (progress < 1.f)
+        rml << " (" << (int)(progress * 100) << "%)";
+      Rocket::SetInnerRML(elem_save, rml.str());
+    }
+  }
+}
+
 GameMenu::~GameMenu()
 {
   ToggleEventListener(false, "continue", "click", _continueClicked);
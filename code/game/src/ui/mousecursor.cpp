@@ -30,10 +30,10 @@ void MouseCursor::SetHint(const std::string& key)
     {
       std::string rml = "<img src='../textures/mouse-hints/" + key + ".png' />";
       
-      _hint->SetInnerRML(rml.c_str());
+      Rocket::ParseInnerRML(_hint, rml.c_str());
     }
     else
-      _hint->SetInnerRML("");
+      Rocket::ParseInnerRML(_hint, "");
     _current_hint = key;
   }
 }
@@ -49,7 +49,7 @@ void MouseCursor::SetHint(int value)
   {
     _current_hint = str;
     str           = "<span class='mouse-hint-success-rate'>" + str + "</span>";
-    _hint->SetInnerRML(str.c_str());
+    Rocket::ParseInnerRML(_hint, str.c_str());
   }
 }
 
@@ -32,7 +32,7 @@ GameOptions::GameOptions(WindowFramework* window, Core::Context* context) : UiBa
 	  rml << " (Fullscreen)";
 	rml << "</option>";
       }
-      screen_select->SetInnerRML(rml.str().c_str());
+      Rocket::ParseInnerRML(screen_select, rml.str().c_str());
     }
 
     if (OptionsManager::Get()["screen"]["fullscreen"] == 1)
@@ -48,7 +48,7 @@ GameOptions::GameOptions(WindowFramework* window, Core::Context* context) : UiBa
 	  rml << " selected";
 	rml << ">" << language << "</option>\n";
       });
-      language_select->SetInnerRML(rml.str().c_str());
+      Rocket::ParseInnerRML(language_select, rml.str().c_str());
     }
 
     {
@@ -77,7 +77,7 @@ void UiLoad::LoadSlots(const string& savePath)
     std::stringstream rml;
     for (int it = 0 ; it < nSlots ; ++it)
       rml << UiLoad::LoadSlotRml("load", it);
-    slotContainer->SetInnerRML(rml.str().c_str());
+    Rocket::ParseInnerRML(slotContainer, rml.str().c_str());
     
     for (int it = 0 ; it < nSlots ; ++it)
     {
@@ -139,7 +139,7 @@ void UiLoad::ClickSlot(Rocket::Core::Event& event)
 
     var_slot      = _selectedSlot->GetAttribute("data-slot");
     rml_preview << "<img id='preview-picture' style='color:rgba(255, 0, 255, 0);' src='../saves/slots/slot-" << var_slot->Get<unsigned int>() << ".png' />";
-    preview->SetInnerRML(rml_preview.str().c_str());
+    Rocket::ParseInnerRML(preview, rml_preview.str().c_str());
   }
 }
 
@@ -206,7 +206,7 @@ void UiSave::LoadSlots(const string& savePath)
     {
       rml << UiLoad::LoadSlotRml("save", it);
     }
-    slotContainer->SetInnerRML(rml.str().c_str());
+    Rocket::ParseInnerRML(slotContainer, rml.str().c_str());
     for (unsigned short it = 0 ; it < nSlots ; ++it)
     {
       std::stringstream      idSlot;
@@ -280,7 +280,7 @@ void UiSave::ClickSlot(Rocket::Core::Event& event)
 
     var_slot      = _selectedSlot->GetAttribute("data-slot");
     rml_preview << "<img id='preview-picture' src='../saves/slot-" << var_slot->Get<unsigned int>() << "/preview.png' />";
-    preview->SetInnerRML(rml_preview.str().c_str());
+    Rocket::ParseInnerRML(preview, rml_preview.str().c_str());
   }
 }
 
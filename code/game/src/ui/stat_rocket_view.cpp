@@ -116,7 +116,7 @@ void StatViewRocket::SetPartyMembers(const std::vector<std::string>& members)
       rml << "<span class='party-member-name'>" << member << "</span>";
       rml << "</div>";
     });
-    team_panel->SetInnerRML(rml.str().c_str());
+    Rocket::ParseInnerRML(team_panel, rml.str().c_str());
   }
 }
 
@@ -265,9 +265,9 @@ void StatViewRocket::SetDetails(const string& icon, const string& title, const s
   Core::Element* elem_title = root->GetElementById("details-title");
   Core::Element* elem_text  = root->GetElementById("details-text");
 
-  if (elem_icon)  elem_icon->SetInnerRML(Core::String("<img src='") + icon.c_str() + "'/>");
-  if (elem_title) elem_title->SetInnerRML(title.c_str());
-  if (elem_text)  elem_text->SetInnerRML(text.c_str());
+  if (elem_icon)  Rocket::ParseInnerRML(elem_icon, Core::String("<img src='") + icon.c_str() + "'/>");
+  if (elem_title) Rocket::ParseInnerRML(elem_title, title.c_str());
+  if (elem_text)  Rocket::ParseInnerRML(elem_text, text.c_str());
 }
 
 void StatViewRocket::SkillClicked(Core::Event& event)
@@ -409,7 +409,7 @@ void StatViewRocket::SetInformation(const std::string& name, const std::string&
   
   element = root->GetElementById(id.c_str());
   if (element)
-    element->SetInnerRML(value.c_str());
+    Rocket::SetInnerRML(element, value);
 }
 
 void StatViewRocket::SetInformation(const std::string& name, short value)
@@ -427,7 +427,7 @@ void StatViewRocket::SetFieldValue(const std::string& category, const std::strin
 
   strId = underscore(category) + "-value-" + underscore(key);
   if ((element = root->GetElementById(strId.c_str())))
-    element->SetInnerRML(value.c_str());
+    Rocket::SetInnerRML(element, value);
   else
   {
     if (category == "Kills")
@@ -442,7 +442,7 @@ void StatViewRocket::SetFieldValue(const std::string& category, const std::strin
         rml << "<div class='kills-key' i18n='" << key << "'>" << i18n::T(key) << "</div>";
         rml << "<div class='kills-value' id='" << strId << "'>" << value << "</div>";
         rml << "</div>";
-        element->SetInnerRML(old_rml + rml.str().c_str());
+        Rocket::ParseInnerRML(element, old_rml + rml.str().c_str());
       }
     }
     else if (category == "Reputation")
@@ -457,7 +457,7 @@ void StatViewRocket::SetFieldValue(const std::string& category, const std::strin
         rml << "<div class='reputation-key' i18n='" << key << "'>" << i18n::T(key) << "</div>";
         rml << "<div class='reputation-value' id='" << strId << "'>" << i18n::T(value) << "</div>";
         rml << "</div>";
-        element->SetInnerRML(old_rml + rml.str().c_str());
+        Rocket::ParseInnerRML(element, old_rml + rml.str().c_str());
       }
     }
     cout << "[Warning] Element '" << strId << "' should exist but doesn't" << endl;
@@ -489,7 +489,7 @@ void StatViewRocket::SetFieldValue(const std::string& category, const std::strin
         comm = "Great";
       if (value > 9)
         comm = "Heroic";
-      elem->SetInnerRML(comm.c_str());
+      Rocket::ParseInnerRML(elem, comm.c_str());
     }
   }
 }
@@ -503,7 +503,7 @@ void StatViewRocket::SetIdValue(const std::string& id, short value)
     stringstream rml;
     
     rml << value;
-    element->SetInnerRML(rml.str().c_str());
+    Rocket::SetInnerRML(element, rml.str());
   }
 }
 
@@ -512,7 +512,7 @@ void StatViewRocket::SetIdValue(const std::string& id, const std::string& value)
   Core::Element* element = root->GetElementById(id.c_str());
   
   if (element)
-    element->SetInnerRML(value.c_str());
+    Rocket::SetInnerRML(element, value);
 }
 
 void StatViewRocket::SetExperience(unsigned int xp, unsigned short lvl, unsigned int next_level)
@@ -528,7 +528,7 @@ void StatViewRocket::SetExperience(unsigned int xp, unsigned short lvl, unsigned
       rml << "<p class='current-level-label'>Level: <span id='level'>" << lvl << "</span></p>";
       rml << "<p class='current-xp-label'>Experience: <span id='current-xp'>" << xp << "</span></p>\n";
       rml << "<p class='next-level-label'>Next level: <span id='next-level'>" << next_level << "</span></p>\n";
-      element->SetInnerRML(rml.str().c_str());
+      Rocket::ParseInnerRML(element, rml.str().c_str());
     }
   }
 }
@@ -599,8 +599,8 @@ void StatViewRocket::SetTraits(list<string> traits)
       create_rml  << "<div class='text-trait' id='trait-" << underscore(trait) << "' " << details << " >" << i18n::T(trait) << "</div></div>";
       display_rml << "<div class='text-trait' id='display-trait-" << underscore(trait) << "' " << details << '>' << i18n::T(trait) << "</div>";
     });
-    if (create_element)  create_element->SetInnerRML(create_rml.str().c_str());
-    if (display_element) display_element->SetInnerRML(display_rml.str().c_str());
+    if (create_element)  Rocket::ParseInnerRML(create_element, create_rml.str().c_str());
+    if (display_element) Rocket::ParseInnerRML(display_element, display_rml.str().c_str());
 
     _traits.clear();
     for_each(traits.begin(), traits.end(), [this](const string trait)
@@ -656,7 +656,7 @@ void StatViewRocket::SetCategoryFields(const std::string& category, const std::v
           rml << "</div>\n\n";
         }
       }
-      element->SetInnerRML(rml.str().c_str());
+      Rocket::ParseInnerRML(element, rml.str().c_str());
     }
   }
 }
@@ -689,7 +689,7 @@ void StatViewRocket::SetPerks(list<string> perks)
 
       rml << "- <span " << details_data << '>' << perk << "</span><br />" << endl;
     });
-    panel_perks->SetInnerRML(rml.str().c_str());
+    Rocket::ParseInnerRML(panel_perks, rml.str().c_str());
   }
 }
 
@@ -784,7 +784,7 @@ void StatViewRocket::PerksDialog::SetAvailablePerks(list<string> perks)
       {
         rml << "- <button id='perk-picker-" << underscore(perk) << "' data-perk='" << underscore(perk) << "'>" << perk << "</button><br />" << endl;
       });
-      element->SetInnerRML(rml.str().c_str());
+      Rocket::ParseInnerRML(element, rml.str().c_str());
       for_each(perks.begin(), perks.end(), [this, element](const string& perk)
       {
         string         id          = "perk-picker-" + underscore(perk);
@@ -812,6 +812,6 @@ void StatViewRocket::PerksDialog::SetPerkDescription(const string& icon, const s
     Core::Element* element = root->GetElementById("perks-description");
     
     if (element)
-      element->SetInnerRML(description.c_str());
+      Rocket::ParseInnerRML(element, description.c_str());
   }
 }
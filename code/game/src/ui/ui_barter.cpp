@@ -44,34 +44,50 @@ UiBarter::UiBarter(WindowFramework* window, Rocket::Core::Context* context, Obje
   }
 }
 
-void UiBarter::UpdateInterfaceSide(Rocket::Core::Element* e, Inventory::Content& content, StatController* stats_self, StatController* stats_other)
+void UiBarter::UpdateInterfaceSide(Rocket::Core::Element* e, Inventory& content, StatController* stats_self, StatController* stats_other)
 {
   int                          total = 0;
   stringstream                 str;
 
   total = GetStackValue(content, stats_self, stats_other);
   str << total << ' ' << i18n::T("caps");
-  e->SetInnerRML(str.str().c_str());
+  Rocket::ParseInnerRML(e, str.str().c_str());
 }
 
-int  UiBarter::GetStackValue(Inventory::Content& content, StatController* stats_self, StatController* stats_other)
+/*
+ * Items sharing the definition of their template have the same value: it is only evaluated once per stack.
+ */
+int  UiBarter::GetStackValue(Inventory& content, StatController* stats_self, StatController* stats_other)
 {
-  Inventory::Content::iterator it    = content.begin();
-  Inventory::Content::iterator end   = content.end();
-  int                          total = 0;
+  Inventory::Stacks::const_iterator it    = content.GetStacks().begin();
+  Inventory::Stacks::const_iterator end   = content.GetStacks().end();
+  int                               total = 0;
 
-  for (; it != end ; ++it)
+  if (!stats_self || !stats_other)
+    return (content.GetContent().size() * 5);
   {
-    if (stats_self && stats_other)
+    Data data_self  = stats_self->Model().GetAll();
+    Data data_other = stats_other->Model().GetAll();
+
+    for (; it != end ; ++it)
     {
-      InventoryObject& object     = *(*it);
-      Data             data_self  = stats_self->Model().GetAll();
-      Data             data_other = stats_other->Model().GetAll();
+      const Inventory::Stack& stack        = it->second;
+      int                     shared_value = -1;
 
-      total += stats_self->Model().Action("barter_value", "ooo", &object, &data_self, &data_other);
+      for (auto item = stack.items.begin() ; item != stack.items.end() ; ++item)
+      {
+        InventoryObject& object = ***item;
+
+        if (object.IsUnique())
+          total += stats_self->Model().Action("barter_value", "ooo", &object, &data_self, &data_other);
+        else
+        {
+          if (shared_value < 0)
+            shared_value = stats_self->Model().Action("barter_value", "ooo", &object, &data_self, &data_other);
+          total += shared_value;
+        }
+      }
     }
-    else
-      total += 5;
   }
   return (total);
 }
@@ -82,9 +98,9 @@ void UiBarter::UpdateInterface(void)
   Rocket::Core::Element* value_other  = root->GetElementById("value-other");
 
   if (value_player)
-    UpdateInterfaceSide(value_player, _stack_player.GetContent(), _stats_player, _stats_other);
+    UpdateInterfaceSide(value_player, _stack_player, _stats_player, _stats_other);
   if (value_other)
-    UpdateInterfaceSide(value_other,  _stack_other.GetContent(),  _stats_other,  _stats_player);  
+    UpdateInterfaceSide(value_other,  _stack_other,  _stats_other,  _stats_player);  
 }
 
 UiBarter::~UiBarter()
@@ -161,8 +177,8 @@ void UiBarter::SwapObjects(InventoryObject* object)
 void UiBarter::MakeDeal(Rocket::Core::Event& event)
 {
   cout << "Make deal" << endl;
-  int  total_player = GetStackValue(_stack_player.GetContent(), _stats_player, _stats_other);
-  int  total_other  = GetStackValue(_stack_other.GetContent(),  _stats_other,  _stats_player);
+  int  total_player = GetStackValue(_stack_player, _stats_player, _stats_other);
+  int  total_other  = GetStackValue(_stack_other,  _stats_other,  _stats_player);
   int  success;
 
   if (_stats_player && _stats_other)
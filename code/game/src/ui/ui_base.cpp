@@ -1,5 +1,6 @@
 #include "ui/rocket_extension.hpp"
 #include "mousecursor.hpp"
+#include "profiler.hpp"
 
 using namespace std;
 using namespace Rocket;
@@ -18,6 +19,46 @@ namespace Rocket
       std::for_each(elements.begin(), elements.end(), lambda);
     }
   }
+
+  unsigned int RmlStats::parsed_this_frame = 0;
+  unsigned int RmlStats::parsed_last_frame = 0;
+
+  void RmlStats::EndFrame(void)
+  {
+    parsed_last_frame = parsed_this_frame;
+    parsed_this_frame = 0;
+#ifdef PROFILER_ENABLED
+    static PStatCollector collector("UI:RML parses");
+
+    collector.set_level(parsed_last_frame);
+#endif
+  }
+
+  bool SetInnerRML(Rocket::Core::Element* element, const std::string& rml)
+  {
+    if (!(SetAttribute(element, "data-rml", rml)))
+      return (false);
+    element->SetInnerRML(rml.c_str());
+    RmlStats::Parsed();
+    return (true);
+  }
+
+  void ParseInnerRML(Rocket::Core::Element* element, const Rocket::Core::String& rml)
+  {
+    element->RemoveAttribute("data-rml");
+    element->SetInnerRML(rml);
+    RmlStats::Parsed();
+  }
+
+  bool SetAttribute(Rocket::Core::Element* element, const std::string& name, const std::string& value)
+  {
+    Rocket::Core::Variant* current = element->GetAttribute(name.c_str());
+
+    if (current && current->Get<Rocket::Core::String>() == value.c_str())
+      return (false);
+    element->SetAttribute(name.c_str(), Rocket::Core::String(value.c_str()));
+    return (true);
+  }
 }
 
 UiBase::UiBase(WindowFramework* window, Rocket::Core::Context* context) : window(window), root(0), context(context)
@@ -94,7 +135,7 @@ void UiBase::RecursiveTranslate(Core::Element* root)
     {
       string key = attr->Get<Core::String>().CString();
 
-      child->SetInnerRML(i18n::T(key).c_str());
+      Rocket::ParseInnerRML(child, i18n::T(key));
     }
     else
       RecursiveTranslate(child);
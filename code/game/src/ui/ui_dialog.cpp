@@ -32,7 +32,7 @@ void UiDialog::SetMessage(const string& message)
     Rocket::Core::Element* container = root->GetElementById("message-container");
 
     container->SetAttribute("i18n", Rocket::Core::String(message.c_str()));
-    container->SetInnerRML(i18n::T(message).c_str());
+    Rocket::ParseInnerRML(container, i18n::T(message).c_str());
   }
 }
 
@@ -53,7 +53,7 @@ void UiDialog::AddChoice(const string& name, std::function<void (Rocket::Core::E
     rml_stream << rml.CString();
     rml_stream << "<button id='" << id_stream.str() << "' class='universal_button' i18n='" << name << "'>";
     rml_stream << i18n::T(name) << "</button>";
-    _button_container->SetInnerRML(rml_stream.str().c_str());
+    Rocket::ParseInnerRML(_button_container, rml_stream.str().c_str());
     _buttons.push_back(Button(id_stream.str()));
     _buttons.rbegin()->listener.EventReceived.Connect(callback);
     _buttons.rbegin()->listener.EventReceived.Connect(*this, &UiDialog::PickedChoice);
@@ -71,6 +71,6 @@ void UiEquipMode::AddOption(unsigned char mode, const std::string& name)
     rml << i18n::T(name);
     rml << "</button><br />";
     root_choices->GetInnerRML(rml_);
-    root_choices->SetInnerRML(rml_ + rml.str().c_str());
+    Rocket::ParseInnerRML(root_choices, rml_ + rml.str().c_str());
   }
 }
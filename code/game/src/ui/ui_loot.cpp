@@ -76,13 +76,7 @@ bool UiLoot::CanSwap(InventoryObject* object)
 
 void UiLoot::SwapObjects(InventoryObject* object)
 {
-  bool fromLooted = false;
-
-  std::for_each(_looted.GetContent().begin(), _looted.GetContent().end(), [&fromLooted, object](InventoryObject* ptr)
-  {
-    if (object == ptr)
-      fromLooted = true;
-  });
+  bool fromLooted = _looted.IncludesObject(object);
 
   string     object_name = object->GetName();
   Inventory& looted      = (fromLooted ? _looted : _looter);
@@ -130,16 +124,14 @@ void UiLoot::RocketTakeAllClicked(Rocket::Core::Event&)
     InventoryObject* object = *it;
     bool             hidden = (*object)["hidden"] == "1";
 
+    ++it; // DelObject only invalidates the iterator to the removed object
     if (!hidden && _looter.CanCarry(object))
     {
       if (!(CanSwap(object)))
         return ;
       _looter.AddObject(object);
       _looted.DelObject(object);
-      it = _looted.GetContent().begin();
     }
-    else
-      ++it;
   }
   _viewController.Update();
 }
\ No newline at end of file
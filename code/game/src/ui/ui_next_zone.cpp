@@ -23,7 +23,7 @@ UiNextZone::UiNextZone(WindowFramework* window, Rocket::Core::Context* context,
     }
     rml << "<button id='cancel' class='button_menu'>Stay here</button>";
     eContainer->GetInnerRML(lastRml);
-    eContainer->SetInnerRML(lastRml + rml.str().c_str());
+    Rocket::ParseInnerRML(eContainer, lastRml + rml.str().c_str());
 
     {
       ToggleEventListener(true, "cancel", "click", CancelSelected);
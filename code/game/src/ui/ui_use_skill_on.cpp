@@ -58,7 +58,7 @@ void UiUseSkillOn::SetSkillList(const map<string, short>& skill_list)
   {
     stream << "<div class='item'><button id='pick-skill-" << skill.first << "' class='long_button skill-button' data-skill='" << skill.first << "'>" << skill.first << "</button><span id='pick-skill-" << skill.first << "-points' class='points skill-points'>" << skill.second << "</span></div>";
   });
-  list->SetInnerRML(stream.str().c_str());
+  Rocket::ParseInnerRML(list, stream.str().c_str());
   for_each(skill_list.begin(), skill_list.end(), [this](pair<string,short> skill)
   {
     string id = "pick-skill-" + skill.first;
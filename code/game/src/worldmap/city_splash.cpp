@@ -35,7 +35,7 @@ CitySplash::CitySplash(Data data, WindowFramework* window, Rocket::Core::Context
         stream << "</div>";
       }
     });
-    zoneroot->SetInnerRML(stream.str().c_str());
+    Rocket::ParseInnerRML(zoneroot, stream.str().c_str());
     for_each(entry_zones.begin(), entry_zones.end(), [this, zoneroot](Data zone)
     {
       if (zone == '1')
@@ -6,6 +6,7 @@
 #include "ui/loading_screen.hpp"
 #include "scheduled_task.hpp"
 #include "loading_exception.hpp"
+#include <panda3d/texturePool.h>
 
 using namespace std;
 using namespace Rocket;
@@ -14,6 +15,14 @@ bool RocketFactoryInstanceElementText(Core::Element* elem, Core::String innerRml
 
 WorldMap* WorldMap::CurrentWorldMap = 0;
 
+/*
+ * Fog of war: one byte per tile (0 unexplored, 1 explored, 2 visited), displayed by a texture with one texel
+ * per tile stretched over the map. The texture is registered in the TexturePool under the path libRocket
+ * resolves 'worldmap-fog.png' to, so the worldmap document uses it instead of looking for a file.
+ */
+static const char*         fog_texture_path = "data/worldmap-fog.png";
+static const unsigned char fog_alpha[]      = { 255, 125, 0 };
+
 WorldMap::~WorldMap()
 {
   _timeManager.ClearTasks(TASK_LVL_WORLDMAP);
@@ -22,14 +31,17 @@ WorldMap::~WorldMap()
   ToggleEventListener(false, "button-character", "click", ButtonCharacter);
   ToggleEventListener(false, "button-pipbuck",   "click", ButtonPipbuck);
   ToggleEventListener(false, "button-menu",      "click", ButtonMenu);
-  for_each(_cases.begin(), _cases.end(), [this](Core::Element* tile)
-  { tile->RemoveEventListener("click", &MapClickedEvent); });
+  {
+    Core::Element* map_element = root->GetElementById("pworldmap");
+
+    if (map_element)
+      map_element->RemoveEventListener("click", &MapClickedEvent);
+  }
   _cursor->RemoveEventListener("click", &PartyCursorClicked);
   
   for_each(_cities.begin(), _cities.end(), [this](const City& city)
   {
     ToggleEventListener(false, "city-"      + city.name, "click", CityButtonClicked);
-    ToggleEventListener(false, "city-halo-" + city.name, "click", MapClickedEvent);
   });
   
   Destroy();
@@ -39,6 +51,8 @@ WorldMap::~WorldMap()
     delete _cityTree;
   if (_city_splash)
     delete _city_splash;
+  if (_fog_texture)
+    TexturePool::release_texture(_fog_texture);
   CurrentWorldMap = 0;
   root->Close();
   root->RemoveReference();
@@ -47,7 +61,21 @@ WorldMap::~WorldMap()
 
 void WorldMap::Save(const string& savepath)
 {
-  DataTree::Writers::JSON(_mapTree, "saves/map.json");
+  DataTree::Writers::JSON(GetMapData(), "saves/map.json");
+}
+
+/*
+ * The fog is stored in the map data as a string with one digit per tile.
+ */
+Data WorldMap::GetMapData(void) const
+{
+  Data   map(_mapTree);
+  string grid(_fog.size(), '0');
+
+  for (unsigned int i = 0 ; i < _fog.size() ; ++i)
+    grid[i] = '0' + _fog[i];
+  map["fog"] = grid;
+  return (map);
 }
 
 WorldMap::WorldMap(WindowFramework* window, GameUi* gameUi, DataEngine& de, TimeManager& tm) : UiBase(window, gameUi->GetContext()),
@@ -172,7 +200,7 @@ void WorldMap::AddEntryZoneToCity(const string& city_name, const string& zone)
 
 void WorldMap::SaveMapStatus(void) const
 {
-  DataTree::Writers::JSON(_mapTree, _mapTree->GetSourceFile());
+  DataTree::Writers::JSON(GetMapData(), _mapTree->GetSourceFile());
 }
 
 void WorldMap::AddCityToList(Data cityData)
@@ -222,8 +250,7 @@ void WorldMap::AddCityToList(Data cityData)
     rml << "<img src='worldmap-city.png' style='width:" << radius << "px;height:" << radius << "px;' />";
     rml << "</div>";
 
-    if ((RocketFactoryInstanceElementText(elem, Core::String(rml.str().c_str()))))
-      ToggleEventListener(true, elem_id.str(), "click", MapClickedEvent);
+    RocketFactoryInstanceElementText(elem, Core::String(rml.str().c_str()));
   }
 }
 
@@ -238,19 +265,19 @@ void WorldMap::UpdateClock(void)
   {
     stringstream str;
     str << current_time.GetYear();
-    elem_year->SetInnerRML(str.str().c_str());
+    Rocket::SetInnerRML(elem_year, str.str());
   }
   if (elem_month)
   {
     stringstream str;
     str << current_time.GetMonth();
-    elem_month->SetInnerRML(str.str().c_str());
+    Rocket::SetInnerRML(elem_month, str.str());
   }
   if (elem_day)
   {
     stringstream str;
     str << current_time.GetDay();
-    elem_day->SetInnerRML(str.str().c_str());
+    Rocket::SetInnerRML(elem_day, str.str());
   }
 }
 
@@ -357,7 +384,7 @@ void WorldMap::PartyClicked(Rocket::Core::Event&)
     int x, y;
 
     GetCurrentCase(x, y);
-    RequestRandomEncounter.Emit(x, y, Dices::Throw(100) >= 85);
+    RequestRandomEncounter.Emit(x, y, Dices::Throw(100, Dices::Encounters) >= 85);
   }
 }
 
@@ -432,15 +459,6 @@ void WorldMap::UpdatePartyCursor(float elapsedTime)
 
 }
 
-Core::Element* WorldMap::GetCaseAt(int x, int y) const
-{
-  unsigned int it = y * _size_x + x;
-
-  if (_cases.size() > it)
-    return (_cases[it]);
-  return (0);
-}
-
 void WorldMap::GetCurrentCase(int& x, int& y) const
 {
   x = _current_pos_x / _tsize_x;
@@ -449,37 +467,68 @@ void WorldMap::GetCurrentCase(int& x, int& y) const
 
 Data WorldMap::GetCaseData(int x, int y) const
 {
-  int            it       = (y * _size_x) + x;
+  unsigned int it = (y * _size_x) + x;
 
+  if (x >= 0 && y >= 0 && x < _size_x && it < _tiles.size())
+    return (_tiles[it]);
   return (Data(_mapTree)["tiles"][it]);
 }
 
-void WorldMap::SetCaseVisibility(int x, int y, char visibility) const
+void WorldMap::SetCaseVisibility(int x, int y, char visibility)
 {
-  //int            it       = (y * _size_x) + x;
-  Core::Element* element  = GetCaseAt(x, y);
-  Data           dataCase = GetCaseData(x, y);
-  stringstream   stream;
+  unsigned int it = (y * _size_x) + x;
 
-  if (!element) return ;
-  if ((int)dataCase["visibility"] >= visibility)
+  if (x < 0 || y < 0 || x >= _size_x || it >= _fog.size() || _fog[it] >= visibility)
     return ;
-  switch ((int)visibility)
+  _fog[it] = visibility;
+  UpdateFogTexel(x, y);
+}
+
+/*
+ * Maps saved before the fog grid existed have a visibility value in each tile.
+ */
+void WorldMap::LoadFog(Data map)
+{
+  string grid = map["fog"].Value();
+
+  _fog.assign(_size_x * _size_y, 0);
+  for (unsigned int i = 0 ; i < _fog.size() ; ++i)
+  {
+    if (grid.size() == _fog.size())
+      _fog[i] = grid[i] - '0';
+    else if (i < _tiles.size())
+      _fog[i] = (int)_tiles[i]["visibility"];
+    _fog[i] = MIN(_fog[i], 2);
+  }
+  for_each(_tiles.begin(), _tiles.end(), [](Data tile) { tile["visibility"].Remove(); });
+
+  _fog_texture = new Texture("worldmap-fog");
+  _fog_texture->setup_2d_texture(_size_x, _size_y, Texture::T_unsigned_byte, Texture::F_rgba);
+  _fog_texture->set_magfilter(Texture::FT_nearest);
+  _fog_texture->set_minfilter(Texture::FT_nearest);
+  _fog_texture->set_filename(fog_texture_path);
+  _fog_texture->set_fullpath(fog_texture_path);
+  {
+    PTA_uchar image = _fog_texture->modify_ram_image();
+
+    memset(image.p(), 0, image.size());
+  }
+  for (int y = 0 ; y < _size_y ; ++y)
+  {
+    for (int x = 0 ; x < _size_x ; ++x)
+      UpdateFogTexel(x, y);
+  }
+  TexturePool::add_texture(_fog_texture);
+}
+
+void WorldMap::UpdateFogTexel(int x, int y)
+{
+  if (_fog_texture)
   {
-    case 0:
-      stream << "<div style='background: rgba(0, 0, 0, 255); width: " << _tsize_x << "px; height: " << _tsize_y << ";'></div>";
-      element->SetInnerRML(stream.str().c_str());
-      dataCase["visibility"] = 0;
-      break ;
-    case 1:
-      stream << "<div style='background: rgba(0, 0, 0, 125); width: " << _tsize_x << "px; height: " << _tsize_y << ";'></div>";
-      element->SetInnerRML(stream.str().c_str());
-      dataCase["visibility"] = 1;
-      break ;
-    case 2:
-      element->SetInnerRML("");
-      dataCase["visibility"] = 2;
-      break ;
+    PTA_uchar    image = _fog_texture->modify_ram_image();
+    unsigned int texel = ((_size_y - 1 - y) * _size_x + x) * 4; // Panda's images are stored bottom to top
+
+    image[texel + 3] = fog_alpha[_fog[y * _size_x + x]];
   }
 }
 
@@ -514,14 +563,18 @@ void WorldMap::MapTileGenerator(Data map)
   int               size_y  = map["size_y"];
   int               tsize_x = map["tile_size_x"];
   int               tsize_y = map["tile_size_y"];
-  int               pos_x   = 0;
-  int               pos_y   = 0;
 
   _size_x  = size_x;
   _size_y  = size_y;
   _tsize_x = tsize_x;
   _tsize_y = tsize_y;
 
+  // Data::operator[](unsigned int) walks the children list: tiles are indexed once.
+  _tiles.clear();
+  _tiles.reserve(size_x * size_y);
+  for_each(tiles.begin(), tiles.end(), [this](Data tile) { _tiles.push_back(tile); });
+  LoadFog(map);
+
   {
     //
     // Generate RCSS and RML for the Tilemap
@@ -534,28 +587,9 @@ void WorldMap::MapTileGenerator(Data map)
     rcss << "  width:  " << (size_x * tsize_x) << "px;\n";
     rcss << "  height: " << (size_y * tsize_y) << "px;\n";
     rcss << "}\n\n";
-    
-    for_each(tiles.begin(), tiles.end(), [this, &rml, &rcss, &pos_x, &pos_y, size_x, size_y, tsize_x, tsize_y](Data tile)
-    {
-      rml  << "<div id='tile" << pos_x << "-" << pos_y << "' class='tile' style='position: absolute;";
-      rml  << "top: "  << (pos_y * tsize_y) << "px; ";
-      rml  << "left: " << (pos_x * tsize_x) << "px; ";
-      rml  << "height: " << tsize_y << "px; width: " << tsize_x << "px;";
-      rml  << "' data-pos-x='" << pos_x << "' data-pos-y='" << pos_y << "'>";
-      
-      if (tile["visibility"].Value() == "0")
-	rml << "<div style='background: rgba(0, 0, 0, 255); width: " << tsize_x << "px; height: " << tsize_y << ";'></div>";
-      if (tile["visibility"].Value() == "1")
-	rml << "<div style='background: rgba(0, 0, 0, 125); width: " << tsize_x << "px; height: " << tsize_y << ";'></div>";
-
-      rml  << "</div>\n";
-
-      if (++pos_x >= size_x)
-      {
-	++pos_y;
-	pos_x = 0;
-      }
-    });
+
+    rml  << "<img id='worldmap-fog' src='worldmap-fog.png' style='position: absolute; top: 0px; left: 0px; ";
+    rml  << "width: " << (size_x * tsize_x) << "px; height: " << (size_y * tsize_y) << "px;' />\n";
 
     //
     // Load the worldmap rml template, replace the #{RML} and #{RCSS} bits with generated RML/RCSS,
@@ -601,9 +635,8 @@ void WorldMap::MapTileGenerator(Data map)
       }
 
       //
-      // Load the temporary file and link every click event from every tile
+      // Load the temporary file and link the click events on the map
       // to the RocketListener MapClickedEvent.
-      // While adding every case Element to the Case array.
       //
       LoadingScreen::AppendText("Loading compiled worldmap");
       root = context->LoadDocument("data/worldmap.rml");
@@ -619,25 +652,9 @@ void WorldMap::MapTileGenerator(Data map)
     streamSizeY << (_size_y * _tsize_y);
     mapElem->SetProperty("width",  streamSizeX.str().c_str());
     mapElem->SetProperty("height", streamSizeY.str().c_str());
-    mapElem->SetInnerRML(rml.str().c_str());
-    for (pos_x = 0, pos_y = 0 ; pos_x < size_x && pos_y < size_y ;)
-    {
-      Rocket::Core::Element* tileElem;
-      stringstream           idElem;
-
-      idElem << "tile" << pos_x << "-" << pos_y;
-      tileElem = root->GetElementById(idElem.str().c_str());
-      if (tileElem)
-      {
-	tileElem->AddEventListener("click", &MapClickedEvent);
-        _cases.push_back(tileElem);
-      }
-      if (++pos_x >= size_x)
-      {
-	++pos_y;
-	pos_x = 0;
-      }
-    }
+    Rocket::ParseInnerRML(mapElem, rml.str().c_str());
+    // Clicks on the fog or on city halos bubble up to the map
+    mapElem->AddEventListener("click", &MapClickedEvent);
     unlink("data/worldmap.rml");
   }
   LoadingScreen::AppendText("Worldmap loaded.");
@@ -661,7 +678,7 @@ void WorldMap::Task::CheckIfEncounter(void)
 {
   string which_city;
 
-  if (!(worldmap->IsPartyInCity(which_city)) && Dices::Throw(100) < 3)
+  if (!(worldmap->IsPartyInCity(which_city)) && Dices::Throw(100, Dices::Encounters) < 3)
   {
     int x, y;
 
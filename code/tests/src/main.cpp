@@ -12,6 +12,16 @@ void TestsTimeManager(UnitTest&);
 void TestsSync(UnitTest&);
 void TestsData(UnitTest&);
 void TestsPathfinding(UnitTest&);
+void TestsJobSystem(UnitTest&);
+void TestsArchive(UnitTest&);
+void TestsDeltaSave(UnitTest&);
+void TestsWorldSections(UnitTest&);
+void TestsSpatialGrid(UnitTest&);
+void TestsDices(UnitTest&);
+void TestsProfiler(UnitTest&);
+void TestsLogger(UnitTest&);
+void TestsDynamicBitset(UnitTest&);
+void TestsCharacterRanges(UnitTest&);
 
 list<function<void (UnitTest&)> > TestInitializers;
 
@@ -22,12 +32,22 @@ int main(void)
   TestInitializers.push_back(&TestsString);
   TestInitializers.push_back(&TestsDirectory);
   TestInitializers.push_back(&TestsSerializer);
+  TestInitializers.push_back(&TestsArchive);
+  TestInitializers.push_back(&TestsDeltaSave);
+  TestInitializers.push_back(&TestsWorldSections);
   TestInitializers.push_back(&TestsJSON);
   TestInitializers.push_back(&TestsData);
   TestInitializers.push_back(&TestsSync);
+  TestInitializers.push_back(&TestsJobSystem);
   TestInitializers.push_back(&TestsTimeManager);
   TestInitializers.push_back(&TestsStatistics);
   TestInitializers.push_back(&TestsPathfinding);
+  TestInitializers.push_back(&TestsSpatialGrid);
+  TestInitializers.push_back(&TestsDices);
+  TestInitializers.push_back(&TestsProfiler);
+  TestInitializers.push_back(&TestsLogger);
+  TestInitializers.push_back(&TestsDynamicBitset);
+  TestInitializers.push_back(&TestsCharacterRanges);
 
   for_each(TestInitializers.begin(), TestInitializers.end(), [&tester](function<void (UnitTest& tester)> callback) { callback(tester); });
 
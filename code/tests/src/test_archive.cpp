@@ -0,0 +1,217 @@
+#include "test.hpp"
+#include "my_zlib.hpp"
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+static string MakeContent(unsigned int size, unsigned int seed)
+{
+  string content(size, 0);
+
+  for (unsigned int i = 0 ; i < size ; ++i)
+    content[i] = (char)((i * 31 + seed) % 97);
+  return (content);
+}
+
+static string ExtractToString(Utils::Archive& archive, const string& name)
+{
+  const Utils::Archive::Entry* entry = archive.Find(name);
+  stringstream                 stream;
+
+  if (!entry)
+    return ("<missing>");
+  archive.Extract(*entry, stream);
+  return (stream.str());
+}
+
+// Fails the first read without reaching the end of the stream
+struct FailingBuffer : public streambuf
+{
+  int_type underflow(void) { throw runtime_error("read error"); }
+};
+
+void TestsArchive(UnitTest& tester)
+{
+  tester.AddTest("Archive", "Entries larger than the buffers", []() -> string
+  {
+    const string    content = MakeContent(Utils::Archive::buffer_size * 3 + 17, 1);
+    Utils::Archive  archive;
+    string          to_ret;
+
+    {
+      stringstream input(content);
+
+      archive.Create("test_archive.bin");
+      archive.Add("level.blob", input);
+      archive.Commit();
+      archive.Close();
+    }
+    if (!(Utils::Archive::IsArchive("test_archive.bin")) || !(archive.Open("test_archive.bin")))
+      to_ret = "Couldn't reopen the archive";
+    else if (ExtractToString(archive, "level.blob") != content)
+      to_ret = "Extracted data differs from the original";
+    archive.Close();
+    remove("test_archive.bin");
+    return (to_ret);
+  });
+
+  tester.AddTest("Archive", "Random access", []() -> string
+  {
+    Utils::Archive archive;
+    string         to_ret;
+
+    archive.Create("test_archive.bin");
+    for (unsigned int i = 0 ; i < 5 ; ++i)
+    {
+      stringstream input(MakeContent(1000 + i, i));
+      stringstream name;
+
+      name << "entry-" << i;
+      archive.Add(name.str(), input);
+    }
+    archive.Commit();
+    archive.Close();
+    archive.Open("test_archive.bin");
+    if (archive.GetEntries().size() != 5)
+      to_ret = "Table of contents doesn't list every entry";
+    else if (ExtractToString(archive, "entry-3") != MakeContent(1003, 3) || ExtractToString(archive, "entry-0") != MakeContent(1000, 0))
+      to_ret = "Entries extracted out of order don't match";
+    archive.Close();
+    remove("test_archive.bin");
+    return (to_ret);
+  });
+
+  tester.AddTest("Archive", "Replacing an entry, then compacting", []() -> string
+  {
+    Utils::Archive archive;
+    string         to_ret;
+
+    {
+      stringstream first(MakeContent(5000, 1)), second(MakeContent(200, 2));
+
+      archive.Create("test_archive.bin");
+      archive.Add("a", first);
+      archive.Add("b", second);
+      archive.Commit();
+      archive.Close();
+    }
+    {
+      stringstream replacement(MakeContent(3000, 3));
+
+      archive.Open("test_archive.bin");
+      archive.Add("a", replacement);
+      archive.Commit();
+      archive.Close();
+    }
+    archive.Open("test_archive.bin");
+    if (archive.DeadSpace() == 0)
+      to_ret = "Replaced data wasn't accounted as dead space";
+    else if (ExtractToString(archive, "a") != MakeContent(3000, 3) || ExtractToString(archive, "b") != MakeContent(200, 2))
+      to_ret = "Replacing an entry broke the archive";
+    archive.Close();
+    if (to_ret == "")
+    {
+      Utils::Archive::Compact("test_archive.bin");
+      archive.Open("test_archive.bin");
+      if (archive.DeadSpace() != 0)
+        to_ret = "Compact didn't reclaim the dead space";
+      else if (ExtractToString(archive, "a") != MakeContent(3000, 3) || ExtractToString(archive, "b") != MakeContent(200, 2))
+        to_ret = "Compact broke the archive";
+      archive.Close();
+    }
+    remove("test_archive.bin");
+    return (to_ret);
+  });
+
+  tester.AddTest("Archive", "An interrupted update leaves the last commit", []() -> string
+  {
+    Utils::Archive archive;
+    string         to_ret;
+
+    {
+      stringstream first(MakeContent(Utils::Archive::buffer_size + 100, 1));
+
+      archive.Create("test_archive.bin");
+      archive.Add("a", first);
+      archive.Commit();
+      archive.Close();
+    }
+    {
+      stringstream replacement(MakeContent(Utils::Archive::buffer_size * 2, 2)), added(MakeContent(100, 3));
+
+      archive.Open("test_archive.bin");
+      archive.Add("a", replacement);
+      archive.Add("b", added);
+      archive.Close(); // Without a Commit
+    }
+    if (!(archive.Open("test_archive.bin")))
+      to_ret = "Couldn't reopen the archive";
+    else if (archive.GetEntries().size() != 1 || ExtractToString(archive, "a") != MakeContent(Utils::Archive::buffer_size + 100, 1))
+      to_ret = "The last commit was damaged";
+    else
+    {
+      stringstream added(MakeContent(100, 3));
+
+      archive.Add("b", added);
+      archive.Commit();
+      archive.Close();
+      archive.Open("test_archive.bin");
+      if (ExtractToString(archive, "b") != MakeContent(100, 3) || ExtractToString(archive, "a") != MakeContent(Utils::Archive::buffer_size + 100, 1))
+        to_ret = "Couldn't update the archive after an interrupted update";
+    }
+    archive.Close();
+    remove("test_archive.bin");
+    return (to_ret);
+  });
+
+  tester.AddTest("Archive", "Several commits in one session", []() -> string
+  {
+    Utils::Archive archive;
+    string         to_ret;
+
+    {
+      stringstream first(MakeContent(Utils::Archive::buffer_size + 100, 1)), second(MakeContent(10, 2)), third(MakeContent(1, 3));
+
+      archive.Create("test_archive.bin");
+      archive.Add("a", first);
+      archive.Commit();
+      archive.Add("b", second);
+      archive.Commit();
+      archive.Add("c", third); // Shorter than the table of contents committed before it
+      archive.Close();         // Without a Commit
+    }
+    if (!(archive.Open("test_archive.bin")))
+      to_ret = "Couldn't reopen the archive";
+    else if (archive.GetEntries().size() != 2)
+      to_ret = "The last commit wasn't the one read";
+    else if (ExtractToString(archive, "a") != MakeContent(Utils::Archive::buffer_size + 100, 1) || ExtractToString(archive, "b") != MakeContent(10, 2))
+      to_ret = "Entries were overwritten by a later commit";
+    else if (archive.DeadSpace() == 0)
+      to_ret = "The first table of contents isn't counted as dead space";
+    archive.Close();
+    remove("test_archive.bin");
+    return (to_ret);
+  });
+
+  tester.AddTest("Archive", "A read error is reported", []() -> string
+  {
+    Utils::Archive archive;
+    FailingBuffer  buffer;
+    istream        input(&buffer);
+    string         to_ret = "Adding from a failing stream didn't throw";
+
+    archive.Create("test_archive.bin");
+    try
+    {
+      archive.Add("a", input);
+    }
+    catch (const Utils::Archive::Exception&)
+    {
+      to_ret = "";
+    }
+    archive.Close();
+    remove("test_archive.bin");
+    return (to_ret);
+  });
+}
@@ -0,0 +1,45 @@
+#include "test.hpp"
+#include "level/character_ranges.hpp"
+
+using namespace std;
+
+static ObjectCharacter* FakeCharacter(unsigned int id)
+{
+  return (reinterpret_cast<ObjectCharacter*>(id * 16 + 16));
+}
+
+void TestsCharacterRanges(UnitTest& tester)
+{
+  tester.AddTest("CharacterRanges", "Lists the other characters closer than the radius", []() -> string
+  {
+    CharacterRanges                ranges;
+    CharacterRanges::CharacterList list;
+
+    ranges.Add(FakeCharacter(0), 0,  0, 10);
+    ranges.Add(FakeCharacter(1), 6,  8, 30);
+    ranges.Add(FakeCharacter(2), 0, 25, 5);
+    ranges.Compute();
+    if (!(ranges.Get(FakeCharacter(0), list)) || list.size() != 0)
+      return ("A character at the exact radius is in range");
+    if (!(ranges.Get(FakeCharacter(1), list)) || list.size() != 2 || list[0] != FakeCharacter(0) || list[1] != FakeCharacter(2))
+      return ("Wrong characters in range");
+    if (ranges.Get(FakeCharacter(3), list))
+      return ("Found ranges for an unknown character");
+    return ("");
+  });
+
+  tester.AddTest("CharacterRanges", "Ranges are unavailable until computed again", []() -> string
+  {
+    CharacterRanges                ranges;
+    CharacterRanges::CharacterList list;
+
+    ranges.Add(FakeCharacter(0), 0, 0, 10);
+    if (ranges.Get(FakeCharacter(0), list))
+      return ("Ranges available before being computed");
+    ranges.Compute();
+    ranges.Invalidate();
+    if (ranges.Get(FakeCharacter(0), list))
+      return ("Ranges available after being invalidated");
+    return ("");
+  });
+}
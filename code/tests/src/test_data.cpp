@@ -1,5 +1,6 @@
 #include "test.hpp"
 #include "datatree.hpp"
+#include "data_path.hpp"
 
 using namespace std;
 
@@ -75,5 +76,52 @@ void TestsData(UnitTest& tester)
       return ("Temporary branch wasn't removed from its parent when it went out of scope");
     return ("");
   });
+
+  tester.AddTest("Data", "Paths resolve like subscripts", []() -> string
+  {
+    DataTree tree;
+    Data     data(&tree);
+    DataPath path("Special/PER");
+    DataPath missing("Special/Missing");
+
+    data["Special"]["STR"] = 5;
+    data["Special"]["PER"] = 7;
+    if (path.GetKeys().size() != 2 || !(path.From(data) == 7) || !(path.From(data) == 7))
+      return ("Special/PER wasn't resolved");
+    if (missing.From(data).NotNil() || tree.children.front()->children.size() != 2)
+      return ("Resolving a missing path changed the tree");
+    data["Special"]["PER"] = 3;
+    if (!(path.From(data) == 3))
+      return ("Didn't see the new value");
+    return ("");
+  });
+
+  tester.AddTest("Data", "Paths notice changes to the tree", []() -> string
+  {
+    DataTree tree;
+    Data     data(&tree);
+    DataPath path("Skills/Steal");
+
+    if (path.From(data).NotNil())
+      return ("Resolved a path missing from the tree");
+    data["Skills"]["Steal"] = 10;
+    if (!(path.From(data) == 10))
+      return ("Missed a branch added after the first lookup");
+    data["Skills"].CutBranch();
+    if (path.From(data).NotNil())
+      return ("Resolved a branch which was cut");
+    data["Skills"]["Steal"] = 20;
+    if (!(path.From(data) == 20))
+      return ("Missed a branch added again");
+    {
+      DataTree other;
+      Data     other_data(&other);
+
+      other_data["Skills"]["Steal"] = 30;
+      if (!(path.From(other_data) == 30) || !(path.From(data) == 20))
+        return ("Mixed up two trees");
+    }
+    return ("");
+  });
 }
 
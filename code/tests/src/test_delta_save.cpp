@@ -0,0 +1,160 @@
+#include "test.hpp"
+#include "level/delta_save.hpp"
+
+using namespace std;
+
+/*
+ * A fake level: world records are strings in a list, the way World serializes its dynamicObjects,
+ * instance records are single strings.
+ */
+struct FakeLevel
+{
+  vector<string>      world_names, instance_names;
+  map<string, string> world, instances;
+  char                state;
+  int                 combat;
+
+  string Serialize(void)
+  {
+    Utils::Packet packet;
+    list<string>  world_records;
+
+    for (auto it = world_names.begin() ; it != world_names.end() ; ++it)
+      world_records.push_back(world[*it]);
+    packet << 42 << world_records << 4.2f << state;
+    for (auto it = instance_names.begin() ; it != instance_names.end() ; ++it)
+      packet << instances[*it];
+    packet << combat;
+    return (string(packet.raw(), packet.size()));
+  }
+
+  void Record(DeltaSave& delta, bool everything)
+  {
+    Utils::Packet state_packet, combat_packet;
+
+    delta.SetOrder(world_names, instance_names);
+    for (auto it = world_names.begin() ; it != world_names.end() ; ++it)
+    {
+      Utils::Packet packet;
+
+      packet << world[*it];
+      if (everything || !(delta.HasRecord(DeltaSave::WorldRecord, *it)) || *it == "changed")
+        delta.SetRecord(DeltaSave::WorldRecord, *it, packet);
+    }
+    for (auto it = instance_names.begin() ; it != instance_names.end() ; ++it)
+    {
+      Utils::Packet packet;
+
+      packet << instances[*it];
+      if (everything || !(delta.HasRecord(DeltaSave::InstanceRecord, *it)) || *it == "changed")
+        delta.SetRecord(DeltaSave::InstanceRecord, *it, packet);
+    }
+    state_packet  << state;
+    combat_packet << combat;
+    delta.SetLevelState(state_packet, combat_packet);
+  }
+
+  string Snapshot(DeltaSave& delta)
+  {
+    Utils::Packet head, tail;
+
+    head << 42;
+    tail << 4.2f;
+    delta.BeginSnapshot();
+    Record(delta, true);
+    return (delta.WriteSnapshot(head, tail));
+  }
+};
+
+static FakeLevel MakeLevel(void)
+{
+  FakeLevel level;
+  string    names[] = { "door", "changed", "pony", "locker" };
+
+  for (unsigned int i = 0 ; i < 4 ; ++i)
+  {
+    level.world_names.push_back(names[i]);
+    level.instance_names.push_back(names[i]);
+    level.world[names[i]]     = names[i] + "-world";
+    level.instances[names[i]] = names[i] + "-instance";
+  }
+  level.state  = 1;
+  level.combat = 0;
+  return (level);
+}
+
+void TestsDeltaSave(UnitTest& tester)
+{
+  tester.AddTest("DeltaSave", "Snapshot matches a full serialization", []() -> string
+  {
+    FakeLevel level = MakeLevel();
+    DeltaSave delta;
+
+    if (level.Snapshot(delta) != level.Serialize())
+      return ("Snapshot differs from the serialized level");
+    return ("");
+  });
+
+  tester.AddTest("DeltaSave", "Snapshot and delta rebuild the level", []() -> string
+  {
+    FakeLevel level = MakeLevel();
+    DeltaSave delta, loaded;
+    string    snapshot, delta_data;
+
+    snapshot = level.Snapshot(delta);
+    level.world["changed"]     = "changed-world-with-a-longer-record";
+    level.instances["changed"] = "changed-instance-2";
+    level.world_names.erase(level.world_names.begin() + 2);
+    level.instance_names.erase(level.instance_names.begin());
+    level.world_names.push_back("dropped-item");
+    level.world["dropped-item"] = "dropped-item-world";
+    level.state  = 2;
+    level.combat = 3;
+    level.Record(delta, false);
+    delta_data = delta.WriteDelta();
+    if (!(loaded.Load(snapshot, delta_data)))
+      return ("Delta wasn't recognized as matching the snapshot");
+    if (loaded.Rebuild(snapshot) != level.Serialize())
+      return ("Rebuilt level differs from the serialized level");
+    return ("");
+  });
+
+  tester.AddTest("DeltaSave", "Delta of another snapshot is ignored", []() -> string
+  {
+    FakeLevel level = MakeLevel();
+    DeltaSave delta, loaded;
+    string    snapshot, delta_data;
+
+    snapshot   = level.Snapshot(delta);
+    delta_data = delta.WriteDelta();
+    snapshot[snapshot.size() - 1]++;
+    if (loaded.Load(snapshot, delta_data))
+      return ("Delta was accepted for a modified snapshot");
+    if (loaded.Rebuild(snapshot) != snapshot)
+      return ("Rebuild without a delta should return the snapshot");
+    return ("");
+  });
+
+  tester.AddTest("DeltaSave", "Changes to the head or tail need a new snapshot", []() -> string
+  {
+    FakeLevel     level = MakeLevel();
+    DeltaSave     delta, loaded;
+    Utils::Packet head, tail, changed_head;
+    string        snapshot;
+
+    head << 42;
+    tail << 4.2f;
+    changed_head << 43;
+    if (delta.MatchesSnapshot(head, tail))
+      return ("Matched a snapshot which wasn't written yet");
+    snapshot = level.Snapshot(delta);
+    if (!(delta.MatchesSnapshot(head, tail)))
+      return ("Head and tail didn't match their own snapshot");
+    if (delta.MatchesSnapshot(changed_head, tail))
+      return ("A changed head matched the snapshot");
+    level.Record(delta, false);
+    if (!(loaded.Load(snapshot, delta.WriteDelta())) || !(loaded.MatchesSnapshot(head, tail)))
+      return ("Head and tail didn't match a loaded snapshot");
+    return ("");
+  });
+}
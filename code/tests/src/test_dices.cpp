@@ -0,0 +1,83 @@
+#include "test.hpp"
+#include "dices.hpp"
+
+using namespace std;
+
+void TestsDices(UnitTest& tester)
+{
+  tester.AddTest("Dices", "Same seed, same numbers", []() -> string
+  {
+    RandomStream a(1234), b(1234), c(1235);
+    bool         differs = false;
+
+    for (unsigned int i = 0 ; i < 1000 ; ++i)
+    {
+      unsigned int value = a.Next();
+
+      if (value != b.Next())
+        return ("Streams with the same seed differ");
+      differs = differs || value != c.Next();
+    }
+    if (!differs)
+      return ("Streams with different seeds are the same");
+    return ("");
+  });
+
+  tester.AddTest("Dices", "Streams are independent", []() -> string
+  {
+    int expected[10];
+
+    Dices::Initialize(42);
+    for (unsigned int i = 0 ; i < 10 ; ++i)
+      expected[i] = Dices::Throw(100, Dices::Combat);
+    Dices::Initialize(42);
+    for (unsigned int i = 0 ; i < 10 ; ++i)
+    {
+      Dices::Throw(100, Dices::Encounters);
+      Dices::Random();
+      if (Dices::Throw(100, Dices::Combat) != expected[i])
+        return ("Drawing from a stream changed another one");
+    }
+    return ("");
+  });
+
+  tester.AddTest("Dices", "Throw range", []() -> string
+  {
+    RandomStream& stream = Dices::Get(Dices::Global);
+    bool          drawn[7] = { false };
+
+    for (unsigned int i = 0 ; i < 10000 ; ++i)
+    {
+      int value = Dices::Throw(6);
+
+      if (value < 1 || value > 6)
+        return ("Throw out of range");
+      drawn[value] = true;
+    }
+    for (unsigned int i = 1 ; i <= 6 ; ++i)
+    {
+      if (!drawn[i])
+        return ("A value was never drawn");
+    }
+    if (stream.Below(1) != 0 || Dices::Random() < 0)
+      return ("Unexpected value");
+    return ("");
+  });
+
+  tester.AddTest("Dices", "State round trip", []() -> string
+  {
+    RandomStream a(7), b;
+
+    a.Next();
+    if (!(b.SetState(a.GetState())))
+      return ("State wasn't restored");
+    for (unsigned int i = 0 ; i < 100 ; ++i)
+    {
+      if (a.Next() != b.Next())
+        return ("Restored stream differs");
+    }
+    if (b.SetState("0 0 0 0") || b.SetState("garbage"))
+      return ("Invalid state was accepted");
+    return ("");
+  });
+}
@@ -0,0 +1,38 @@
+#include "test.hpp"
+#include "dynamic_bitset.hpp"
+#include <vector>
+
+using namespace std;
+
+void TestsDynamicBitset(UnitTest& tester)
+{
+  tester.AddTest("DynamicBitset", "Set and test past the first word", []() -> string
+  {
+    DynamicBitset bitset;
+
+    bitset.Set(3);
+    bitset.Set(70);
+    bitset.Set(130);
+    bitset.Set(70, false);
+    if (!bitset.Test(3) || bitset.Test(70) || !bitset.Test(130) || bitset.Test(1000))
+      return ("Wrong bits set");
+    if (bitset.Count() != 2 || bitset.Size() != 192)
+      return ("Wrong count or size");
+    return ("");
+  });
+
+  tester.AddTest("DynamicBitset", "Iterates over set bits in order", []() -> string
+  {
+    DynamicBitset        bitset;
+    vector<unsigned int> bits;
+
+    bitset.Set(0);
+    bitset.Set(63);
+    bitset.Set(64);
+    bitset.Set(200);
+    bitset.ForEachSet([&bits](unsigned int bit) { bits.push_back(bit); });
+    if (bits.size() != 4 || bits[0] != 0 || bits[1] != 63 || bits[2] != 64 || bits[3] != 200)
+      return ("Wrong iteration");
+    return ("");
+  });
+}
@@ -0,0 +1,131 @@
+#include "test.hpp"
+#include "job_system.hpp"
+#include <stdexcept>
+#include <sstream>
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+using namespace std;
+
+void TestsJobSystem(UnitTest& tester)
+{
+  tester.AddTest("JobSystem", "Run every job", []() -> string
+  {
+    Sync::JobSystem  jobs(3);
+    Sync::JobGroup   group;
+    std::atomic<int> counter(0);
+
+    for (unsigned int i = 0 ; i < 1000 ; ++i)
+      jobs.Push(group, [&counter]() { counter.fetch_add(1); });
+    jobs.Wait(group);
+    if (counter.load() != 1000)
+      return ("Wait returned before every job was done");
+    return ("");
+  });
+
+  tester.AddTest("JobSystem", "Without workers", []() -> string
+  {
+    Sync::JobSystem jobs(0);
+    Sync::JobGroup  group;
+    int             counter = 0;
+
+    for (unsigned int i = 0 ; i < 10 ; ++i)
+      jobs.Push(group, [&counter]() { ++counter; });
+    jobs.Wait(group);
+    if (counter != 10)
+      return ("Jobs weren't run by the waiting thread");
+    return ("");
+  });
+
+  tester.AddTest("JobSystem", "Nested jobs", []() -> string
+  {
+    Sync::JobSystem  jobs(2);
+    Sync::JobGroup   group;
+    std::atomic<int> counter(0);
+
+    for (unsigned int i = 0 ; i < 8 ; ++i)
+    {
+      jobs.Push(group, [&jobs, &counter]()
+      {
+        Sync::JobGroup subgroup;
+
+        for (unsigned int ii = 0 ; ii < 8 ; ++ii)
+          jobs.Push(subgroup, [&counter]() { counter.fetch_add(1); });
+        jobs.Wait(subgroup);
+      });
+    }
+    jobs.Wait(group);
+    if (counter.load() != 64)
+      return ("Jobs pushed from a worker weren't all run");
+    return ("");
+  });
+
+  tester.AddTest("JobSystem", "Exceptions reach Wait", []() -> string
+  {
+    Sync::JobSystem  jobs(2);
+    Sync::JobGroup   group;
+    std::atomic<int> counter(0);
+
+    jobs.Push(group, []() { throw std::runtime_error("job failed"); });
+    for (unsigned int i = 0 ; i < 10 ; ++i)
+      jobs.Push(group, [&counter]() { counter.fetch_add(1); });
+    try
+    {
+      jobs.Wait(group);
+    }
+    catch (const std::runtime_error&)
+    {
+      if (counter.load() != 10)
+        return ("The other jobs of the group weren't completed");
+      return ("");
+    }
+    return ("The exception thrown by the job wasn't rethrown");
+  });
+
+  tester.AddTest("JobSystem", "ParallelFor", []() -> string
+  {
+    Sync::JobSystem   jobs(3);
+    std::vector<int>  values(1000, 0);
+
+    jobs.ParallelFor(0, values.size(), 64, [&values](unsigned int i) { values[i] += i; });
+    for (unsigned int i = 0 ; i < values.size() ; ++i)
+    {
+      if (values[i] != (int)i)
+        return ("An index was skipped or visited twice");
+    }
+    return ("");
+  });
+
+  // Micro-benchmark: compares a serial loop with ParallelFor on a CPU-bound workload.
+  tester.AddTest("JobSystem", "Benchmark ParallelFor", []() -> string
+  {
+    typedef std::chrono::high_resolution_clock Clock;
+    const unsigned int  count = 1 << 16;
+    Sync::JobSystem     jobs(Sync::JobSystem::DefaultWorkerCount());
+    std::vector<double> serial(count), parallel(count);
+    auto                workload = [](unsigned int i) -> double
+    {
+      double value = i;
+
+      for (unsigned int ii = 0 ; ii < 64 ; ++ii)
+        value = std::sqrt(value + ii);
+      return (value);
+    };
+
+    Clock::time_point start = Clock::now();
+    for (unsigned int i = 0 ; i < count ; ++i)
+      serial[i] = workload(i);
+    Clock::time_point middle = Clock::now();
+    jobs.ParallelFor(0, count, 1024, [&parallel, &workload](unsigned int i) { parallel[i] = workload(i); });
+    Clock::time_point end = Clock::now();
+
+    if (serial != parallel)
+      return ("ParallelFor didn't compute the same values as the serial loop");
+    cout << "    [JobSystem] " << jobs.WorkerCount() << " workers: serial "
+         << std::chrono::duration_cast<std::chrono::microseconds>(middle - start).count() << "us, parallel "
+         << std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count() << "us" << endl;
+    return ("");
+  });
+}
@@ -0,0 +1,100 @@
+#include "test.hpp"
+#include "logger.hpp"
+#include <vector>
+
+using namespace std;
+
+static vector<string> CaptureLines(function<void (void)> callback)
+{
+  vector<string> lines;
+
+  Logger::SetConsoleOutput(false);
+  Logger::SetLevel(Logger::Debug);
+  Logger::AddSink([&lines](Logger::Category, Logger::Severity, const string& text) { lines.push_back(text); });
+  callback();
+  Logger::Flush();
+  Logger::ClearSinks();
+  Logger::SetLevel(Logger::Info);
+  Logger::SetConsoleOutput(true);
+  return (lines);
+}
+
+void TestsLogger(UnitTest& tester)
+{
+  tester.AddTest("Logger", "Debug lines are filtered by default", []() -> string
+  {
+    if (Logger::IsEnabled(Logger::General, Logger::Debug) || !(Logger::IsEnabled(Logger::General, Logger::Info)))
+      return ("Categories don't start at the Info severity");
+    return ("");
+  });
+
+  tester.AddTest("Logger", "Arguments are captured and formatted", []() -> string
+  {
+    vector<string> lines = CaptureLines([]()
+    {
+      string name = "Littlepip";
+
+      LOG(General, Info) << "Character " << name << " has " << 42 << " hit points, " << 1.5f << " AP left, " << 7u << ' ' << true << endl;
+    });
+
+    if (lines.size() != 1)
+      return ("Expected one line");
+    if (lines.front() != "Character Littlepip has 42 hit points, 1.5 AP left, 7 1")
+      return ("Wrong format: " + lines.front());
+    return ("");
+  });
+
+  tester.AddTest("Logger", "Categories are filtered by severity", []() -> string
+  {
+    vector<string> lines = CaptureLines([]()
+    {
+      Logger::SetLevel(Logger::Ai, Logger::Warning);
+      LOG(Ai,     Debug)   << "filtered";
+      LOG(Ai,     Error)   << "ai";
+      LOG(Combat, Debug)   << "combat";
+      Logger::SetLevel(Logger::Ai, Logger::Debug);
+    });
+
+    if (lines.size() != 2 || lines[0] != "ai" || lines[1] != "combat")
+      return ("Filtering failed");
+    if (!(Logger::SetLevel("Ai", "Info")) || Logger::IsEnabled(Logger::Ai, Logger::Debug))
+      return ("Couldn't set a level by name");
+    Logger::SetLevel(Logger::Info);
+    if (Logger::SetLevel("Nowhere", "Info"))
+      return ("Accepted an unknown category");
+    return ("");
+  });
+
+  tester.AddTest("Logger", "Long lines are truncated", []() -> string
+  {
+    vector<string> lines = CaptureLines([]()
+    {
+      LOG(General, Info) << string(1000, 'a') << 42;
+    });
+
+    if (lines.size() != 1 || lines.front().size() > Logger::record_size + 5 || lines.front().substr(lines.front().size() - 5) != "[...]")
+      return ("Long line wasn't truncated");
+    return ("");
+  });
+
+  tester.AddTest("Logger", "Lines are written in order by the logger thread", []() -> string
+  {
+    vector<string> lines = CaptureLines([]()
+    {
+      Logger::Initialize();
+      for (int i = 0 ; i < 100 ; ++i)
+        LOG(General, Debug) << i;
+      Logger::Flush();
+      Logger::Finalize();
+    });
+
+    if (lines.size() + Logger::GetDroppedCount() != 100)
+      return ("Lines were lost");
+    for (unsigned int i = 1 ; i < lines.size() ; ++i)
+    {
+      if (atoi(lines[i].c_str()) <= atoi(lines[i - 1].c_str()))
+        return ("Lines aren't in order");
+    }
+    return ("");
+  });
+}
@@ -1,5 +1,7 @@
 #include "test.hpp"
 #include "observatory.hpp"
+#include <vector>
+#include <thread>
 
 void TestsSync(UnitTest& tester)
 {
@@ -76,6 +78,84 @@ void TestsSync(UnitTest& tester)
       return ("The queued calls didn't get called by ExecuteRecordedCalls");
     return ("");
   });
+
+  tester.AddTest("Sync", "Stale observer id", []() -> string
+  {
+    Sync::Signal<void> mysignal;
+    Sync::ObserverId   old_id, new_id;
+    bool               called = false;
+
+    old_id = mysignal.Connect([]() {});
+    mysignal.Disconnect(old_id);
+    new_id = mysignal.Connect([&called]() { called = true; });
+    mysignal.Disconnect(old_id);
+    mysignal.Emit();
+    if (old_id == new_id)
+      return ("A released observer id was handed out again");
+    if (!called)
+      return ("Disconnecting a stale id removed another observer");
+    return ("");
+  });
+
+  tester.AddTest("Sync", "Disconnect all during emit", []() -> string
+  {
+    Sync::Signal<void (int)> mysignal;
+    unsigned char            called = 0;
+
+    mysignal.Connect([&mysignal, &called](int) { called++; mysignal.DisconnectAll(); });
+    mysignal.Connect([&called](int) { called++; });
+    mysignal.Emit(42);
+    mysignal.Emit(42);
+    if (called != 1 || mysignal.ObserverCount() != 0)
+      return ("Observers disconnected during an emission were still called");
+    return ("");
+  });
+
+  tester.AddTest("Sync", "Recorded calls keep their order", []() -> string
+  {
+    Sync::Signal<void (int)> mysignal(false);
+    std::vector<int>         received;
+
+    mysignal.Connect([&received](int value) { received.push_back(value); });
+    // Overflows the recorded call pool on purpose
+    for (int i = 0 ; i < 200 ; ++i)
+      mysignal.Emit(i);
+    if (mysignal.RecordCallCount() != 200)
+      return ("Recorded calls were lost");
+    mysignal.ExecuteRecordedCalls();
+    for (int i = 0 ; i < 200 ; ++i)
+    {
+      if (received.size() <= (unsigned int)i || received[i] != i)
+        return ("Recorded calls weren't executed in the order they were emitted");
+    }
+    return ("");
+  });
+
+  tester.AddTest("Sync", "Recorded calls from several threads", []() -> string
+  {
+    Sync::Signal<void (int)> mysignal(false);
+    std::vector<std::thread> threads;
+    int                      total = 0;
+
+    mysignal.Connect([&total](int value) { total += value; });
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+      threads.push_back(std::thread([&mysignal]()
+      {
+        for (int ii = 0 ; ii < 1000 ; ++ii)
+          mysignal.Emit(1);
+      }));
+    }
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+      mysignal.ExecuteRecordedCalls();
+      threads[i].join();
+    }
+    mysignal.ExecuteRecordedCalls();
+    if (total != 4000)
+      return ("Some of the calls emitted from other threads were lost");
+    return ("");
+  });
 }
 
 
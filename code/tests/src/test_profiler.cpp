@@ -0,0 +1,72 @@
+#include "test.hpp"
+#include "profiler.hpp"
+#include <thread>
+
+using namespace std;
+
+static unsigned int CountZones(const string& trace, const string& name)
+{
+  const string pattern = "\"name\":\"" + name + '"';
+  unsigned int count   = 0;
+
+  for (size_t it = trace.find(pattern) ; it != string::npos ; it = trace.find(pattern, it + 1))
+    count++;
+  return (count);
+}
+
+void TestsProfiler(UnitTest& tester)
+{
+  tester.AddTest("Profiler", "Zones of every thread are exported", []() -> string
+  {
+    string trace;
+
+    Profiler::Clear();
+    Profiler::SetEnabled(true);
+    {
+      Profiler::Zone zone("Test:Main");
+    }
+    {
+      thread other([]()
+      {
+        for (unsigned int i = 0 ; i < 3 ; ++i)
+          Profiler::Zone zone(Profiler::Intern("Test:\"Worker\""));
+      });
+
+      other.join();
+    }
+    Profiler::SetEnabled(false);
+    trace = Profiler::ChromeTrace();
+    if (CountZones(trace, "Test:Main") != 1)
+      return ("Main thread zone wasn't exported");
+    if (CountZones(trace, "Test:\\\"Worker\\\"") != 3)
+      return ("Worker thread zones weren't exported");
+    return ("");
+  });
+
+  tester.AddTest("Profiler", "Ring buffer keeps the last zones", []() -> string
+  {
+    vector<Profiler::Event> events;
+
+    Profiler::Clear();
+    for (unsigned int i = 0 ; i < Profiler::buffer_size + 10 ; ++i)
+      Profiler::GetThreadBuffer().Push(i < Profiler::buffer_size ? "Test:Old" : "Test:New", i + 1, i + 2);
+    events = Profiler::GetThreadBuffer().Copy();
+    if (events.size() != Profiler::buffer_size - 1)
+      return ("Unexpected amount of events");
+    if (string(events.back().name) != "Test:New" || events.back().start != Profiler::buffer_size + 10)
+      return ("Last event is missing");
+    return ("");
+  });
+
+  tester.AddTest("Profiler", "Disabled profiler records nothing", []() -> string
+  {
+    Profiler::Clear();
+    Profiler::SetEnabled(false);
+    {
+      Profiler::Zone zone("Test:Disabled");
+    }
+    if (CountZones(Profiler::ChromeTrace(), "Test:Disabled") != 0)
+      return ("Zone was recorded while disabled");
+    return ("");
+  });
+}
@@ -0,0 +1,75 @@
+#include "test.hpp"
+#include "spatial_grid.hpp"
+#include <vector>
+#include <cstdlib>
+
+using namespace std;
+
+struct GridPoint
+{
+  float x, y, z;
+};
+
+static GridPoint* ClosestByScan(vector<GridPoint>& points, float x, float y, float z)
+{
+  GridPoint* best      = 0;
+  float      best_dist = 0;
+
+  for (auto it = points.begin() ; it != points.end() ; ++it)
+  {
+    float dist = (it->x - x) * (it->x - x) + (it->y - y) * (it->y - y) + (it->z - z) * (it->z - z);
+
+    if (!best || dist < best_dist)
+    {
+      best      = &(*it);
+      best_dist = dist;
+    }
+  }
+  return (best);
+}
+
+static float Distance(const GridPoint* point, float x, float y, float z)
+{
+  return ((point->x - x) * (point->x - x) + (point->y - y) * (point->y - y) + (point->z - z) * (point->z - z));
+}
+
+void TestsSpatialGrid(UnitTest& tester)
+{
+  tester.AddTest("SpatialGrid", "Empty grid", []() -> string
+  {
+    SpatialGrid<GridPoint> grid;
+
+    if (grid.GetClosest(0, 0, 0) != 0)
+      return ("An empty grid returned an entry");
+    return ("");
+  });
+
+  tester.AddTest("SpatialGrid", "Same result as a linear scan", []() -> string
+  {
+    SpatialGrid<GridPoint> grid(7.5f);
+    vector<GridPoint>      points;
+
+    srand(42);
+    for (unsigned int i = 0 ; i < 500 ; ++i)
+    {
+      GridPoint point = { (float)(rand() % 4000) / 10.f - 200.f, (float)(rand() % 4000) / 10.f - 200.f, (float)(rand() % 3) * 15.f };
+
+      points.push_back(point);
+    }
+    for (auto it = points.begin() ; it != points.end() ; ++it)
+      grid.Insert(&(*it), it->x, it->y, it->z);
+    for (unsigned int i = 0 ; i < 500 ; ++i)
+    {
+      float      x        = (float)(rand() % 6000) / 10.f - 300.f;
+      float      y        = (float)(rand() % 6000) / 10.f - 300.f;
+      float      z        = (float)(rand() % 40);
+      GridPoint* expected = ClosestByScan(points, x, y, z);
+      GridPoint* result   = grid.GetClosest(x, y, z);
+
+      // Entries at the same distance may be picked in a different order
+      if (!result || Distance(result, x, y, z) != Distance(expected, x, y, z))
+        return ("Grid didn't find the closest entry");
+    }
+    return ("");
+  });
+}
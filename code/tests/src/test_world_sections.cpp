@@ -0,0 +1,122 @@
+#include "test.hpp"
+#include "world/world_sections.hpp"
+
+using namespace std;
+
+static WorldSections::WaypointTable MakeWaypointTable(void)
+{
+  WorldSections::WaypointTable table;
+
+  for (unsigned int i = 0 ; i < 3 ; ++i)
+  {
+    WorldSections::WaypointRecord record;
+
+    record.id                    = i + 1;
+    record.x                     = i * 1.5f;
+    record.y                     = -2.f;
+    record.z                     = 0.25f;
+    record.floor                 = i;
+    record.floor_above           = i + 1;
+    record.suggested_floor_above = 0;
+    record.first_arc             = table.arcs.size();
+    record.arc_count             = i;
+    for (unsigned int ii = 0 ; ii < i ; ++ii)
+      table.arcs.push_back(ii + 1);
+    table.waypoints.push_back(record);
+  }
+  return (table);
+}
+
+void TestsWorldSections(UnitTest& tester)
+{
+  tester.AddTest("WorldSections", "Waypoint table round trip", []() -> string
+  {
+    WorldSections::WaypointTable table = MakeWaypointTable();
+    WorldSections::WaypointTable decoded;
+    string                       data  = table.Encode();
+
+    decoded.Decode(data.c_str(), data.size());
+    if (data.size() != 2 * 4 + 3 * WorldSections::record_size + 3 * 4)
+      return ("Unexpected encoded size");
+    if (decoded.waypoints.size() != 3 || decoded.arcs != table.arcs)
+      return ("Wrong waypoint or arc count");
+    for (unsigned int i = 0 ; i < 3 ; ++i)
+    {
+      const WorldSections::WaypointRecord& a = table.waypoints[i];
+      const WorldSections::WaypointRecord& b = decoded.waypoints[i];
+
+      if (a.id != b.id || a.x != b.x || a.y != b.y || a.z != b.z || a.floor != b.floor ||
+          a.floor_above != b.floor_above || a.first_arc != b.first_arc || a.arc_count != b.arc_count)
+        return ("Waypoint record differs after decoding");
+    }
+    return ("");
+  });
+
+  tester.AddTest("WorldSections", "Waypoint tables are little-endian", []() -> string
+  {
+    WorldSections::WaypointTable  table;
+    WorldSections::WaypointRecord record;
+    string                        data;
+    const char                    expected[] = { 1, 0, 0, 0, 1, 0, 0, 0, 0x04, 0x03, 0x02, 0x01, 0, 0, (char)0x80, 0x3f };
+
+    record.id                    = 0x01020304;
+    record.x                     = 1.f;
+    record.y                     = record.z = 0.f;
+    record.floor                 = record.floor_above = record.suggested_floor_above = 0;
+    record.first_arc             = 0;
+    record.arc_count             = 1;
+    table.waypoints.push_back(record);
+    table.arcs.push_back(0);
+    data = table.Encode();
+    if (data.compare(0, sizeof(expected), expected, sizeof(expected)) != 0)
+      return ("Counts, id or coordinates aren't stored in little-endian order");
+    return ("");
+  });
+
+  tester.AddTest("WorldSections", "Sections are read independently", []() -> string
+  {
+    WorldSections writer, reader;
+    Utils::Packet objects, zones;
+    string        name;
+    int           count;
+
+    objects << string("objects");
+    zones   << 42;
+    writer.Set(WorldSections::Waypoints, MakeWaypointTable().Encode());
+    writer.Set(WorldSections::Objects,   objects);
+    writer.Set(WorldSections::Zones,     zones);
+    reader.Read(writer.Write());
+    reader.GetPacket(WorldSections::Zones)   >> count;
+    reader.GetPacket(WorldSections::Objects) >> name;
+    if (count != 42 || name != "objects")
+      return ("Section content differs");
+    if (reader.Get(WorldSections::Waypoints).second != MakeWaypointTable().Encode().size())
+      return ("Wrong waypoint section size");
+    return ("");
+  });
+
+  tester.AddTest("WorldSections", "Corrupted blobs are rejected", []() -> string
+  {
+    WorldSections                writer, reader;
+    WorldSections::WaypointTable table = MakeWaypointTable();
+    string                       blob, waypoints;
+
+    writer.Set(WorldSections::Waypoints, table.Encode());
+    blob = writer.Write();
+    try
+    {
+      reader.Read(blob.substr(0, blob.size() - 1));
+      return ("Section out of bounds wasn't detected");
+    }
+    catch (const WorldSections::Exception&) {}
+    table.waypoints[2].arc_count = 5;
+    waypoints = table.Encode();
+    try
+    {
+      table.Decode(waypoints.c_str(), waypoints.size());
+      return ("Arcs out of range weren't detected");
+    }
+    catch (const WorldSections::Exception&) {}
+    return ("");
+  });
+}
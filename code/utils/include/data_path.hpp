@@ -0,0 +1,43 @@
+#ifndef  DATA_PATH_HPP
+# define DATA_PATH_HPP
+
+# include "datatree.hpp"
+# include <string>
+# include <vector>
+
+/*! \class DataPath
+ * \brief Path to a nested value, such as "Special/PER", parsed once and resolved from the branches found last time.
+ * Each branch counts the changes to its children: as long as none of the branches along the path changed, the
+ * cached branches are the ones the keys would resolve to, and resolving the path costs one comparison per key.
+ * The cache is kept for one base at a time: a path is best kept along with the Data it is read from.
+ * Missing paths resolve to a Nil Data, without adding any branch to the tree.
+ */
+class DataPath
+{
+public:
+  DataPath(void) {}
+  DataPath(const std::string& path);
+  DataPath(const DataPath& copy) : keys(copy.keys) {}
+
+  // Copies don't share the cache (Data's assignment would write the value of the base)
+  DataPath&                       operator=(const DataPath& copy) { keys = copy.keys; steps.clear(); return (*this); }
+
+  Data                            From(Data base);
+  const std::vector<std::string>& GetKeys(void) const { return (keys); }
+
+private:
+  struct Step
+  {
+    DataBranch*  branch;
+    unsigned int version;
+  };
+
+  bool                     IsCacheValid(void) const;
+  void                     Resolve(void);
+
+  std::vector<std::string> keys;
+  Data                     base;  // Keeps the first cached branch alive
+  std::vector<Step>        steps; // The base, then the branch of each key found
+};
+
+#endif
@@ -18,16 +18,21 @@ struct DataBranch
     father   = 0;
     nil      = true;
     root     = false;
+    version  = 0;
   }
 
   ~DataBranch();
 
+  /*! \brief Must be called whenever a child is added, removed, moved or renamed (see DataPath) */
+  void         ChildrenChanged(void) { ++version; }
+
   std::string  key;
   std::string  value;
   Children     children;
   DataBranch*  father;
   bool         nil, root;
   unsigned int pointers;
+  unsigned int version;
 };
 
 class DataTree;
@@ -37,6 +42,8 @@ class DataTree;
  */
 class Data
 {
+  friend class DataPath;
+
   Data(const std::string&, DataBranch*);
 public:
   typedef DataBranch::Children Children;
@@ -63,7 +70,15 @@ public:
   void         MoveUp(void);
   void         MoveDown(void);
 
-  void         SetKey(const std::string& newKey) { if (_data) _data->key = newKey; }
+  void         SetKey(const std::string& newKey)
+  {
+    if (_data)
+    {
+      _data->key = newKey;
+      if (_data->father)
+        _data->father->ChildrenChanged();
+    }
+  }
   /*! \brief Copy all branches from var's tree and duplicate them under this branch */
   void         Duplicate(Data var);
 
@@ -1,26 +1,139 @@
 #ifndef  DICES_HPP
 # define DICES_HPP
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <time.h>
+# include <cstdint>
+# include <cstdlib>
+# include <ctime>
+# include <string>
+# include <sstream>
 
+/*
+ * xoshiro128** generator. The state is seeded with splitmix64, so any seed (even 0) is valid.
+ */
+class RandomStream
+{
+public:
+  RandomStream(std::uint64_t seed = 0) { Seed(seed); }
+
+  void          Seed(std::uint64_t seed)
+  {
+    for (unsigned int i = 0 ; i < 4 ; i += 2)
+    {
+      std::uint64_t value = SplitMix(seed);
+
+      state[i]     = (std::uint32_t)value;
+      state[i + 1] = (std::uint32_t)(value >> 32);
+    }
+  }
+
+  std::uint32_t Next(void)
+  {
+    std::uint32_t result = Rotate(state[1] * 5, 7) * 9;
+    std::uint32_t t      = state[1] << 9;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3]  = Rotate(state[3], 11);
+    return (result);
+  }
+
+  // Between 0 and max - 1
+  unsigned int  Below(unsigned int max) { return ((unsigned int)(((std::uint64_t)Next() * max) >> 32)); }
+
+  // Saved with the game (see GameTask::SaveGame)
+  std::string   GetState(void) const
+  {
+    std::stringstream stream;
+
+    stream << state[0] << ' ' << state[1] << ' ' << state[2] << ' ' << state[3];
+    return (stream.str());
+  }
+
+  bool          SetState(const std::string& str)
+  {
+    std::stringstream stream(str);
+    std::uint32_t     values[4];
+
+    stream >> values[0] >> values[1] >> values[2] >> values[3];
+    if (stream.fail() || (values[0] | values[1] | values[2] | values[3]) == 0)
+      return (false);
+    for (unsigned int i = 0 ; i < 4 ; ++i)
+      state[i] = values[i];
+    return (true);
+  }
+
+private:
+  static std::uint32_t Rotate(std::uint32_t value, int bits) { return ((value << bits) | (value >> (32 - bits))); }
+
+  static std::uint64_t SplitMix(std::uint64_t& seed)
+  {
+    std::uint64_t value = (seed += 0x9E3779B97F4A7C15ull);
+
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return (value ^ (value >> 31));
+  }
+
+  std::uint32_t state[4];
+};
+
+/*
+ * Each subsystem draws from its own stream: drawing numbers for one of them doesn't change
+ * the results of the others, and subsystems running on different threads don't share a state.
+ * A stream must only be used from one thread at a time.
+ */
 struct Dices
 {
-  static void Initialize(void)
+  enum Stream
+  {
+    Global,
+    Combat,
+    Detection,
+    Encounters,
+    Ai,
+    Scripts,
+    StreamCount
+  };
+
+  static void          Initialize(std::uint64_t seed = std::time(0))
+  {
+    for (unsigned int i = 0 ; i < StreamCount ; ++i)
+      Get((Stream)i).Seed(seed + i * 0x632BE59BD9B4E019ull);
+  }
+
+  static RandomStream& Get(Stream stream)
+  {
+    static RandomStream streams[StreamCount];
+
+    return (streams[stream]);
+  }
+
+  static const char*   GetName(Stream stream)
   {
-    srand(time(0));
+    static const char* names[StreamCount] = { "global", "combat", "detection", "encounters", "ai", "scripts" };
+
+    return (names[stream]);
   }
-  
-  static int Throw(unsigned int max)
+
+  // Between 1 and max
+  static int           Throw(unsigned int max, Stream stream = Global)
+  {
+    return (Get(stream).Below(max) + 1);
+  }
+
+  static bool          Test(int successPercentage, Stream stream = Global)
   {
-    return ((rand() % max) + 1);
+    return (Throw(100, stream) <= successPercentage);
   }
 
-  static bool Test(int successPercentage)
+  // Positive values only, like rand()
+  static int           Random(void)
   {
-    return (Throw(100) <= successPercentage);
+    return ((int)(Get(Scripts).Next() >> 1));
   }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,75 @@
+#ifndef  DYNAMIC_BITSET_HPP
+# define DYNAMIC_BITSET_HPP
+
+# include <cstdint>
+# include <vector>
+
+/*
+ * Bitset growing as bits are set. Bits past the end read as unset.
+ */
+class DynamicBitset
+{
+public:
+  typedef std::uint64_t Word;
+  static const unsigned int word_bits = 64;
+
+  DynamicBitset(unsigned int size = 0) : words((size + word_bits - 1) / word_bits, 0) {}
+
+  unsigned int   Size(void) const { return (words.size() * word_bits); }
+  void           Resize(unsigned int size) { words.resize((size + word_bits - 1) / word_bits, 0); }
+  void           Clear(void) { words.assign(words.size(), 0); }
+
+  bool           Test(unsigned int bit) const
+  {
+    unsigned int index = bit / word_bits;
+
+    return (index < words.size() && ((words[index] >> (bit % word_bits)) & 1) != 0);
+  }
+
+  void           Set(unsigned int bit, bool value = true)
+  {
+    unsigned int index = bit / word_bits;
+
+    if (index >= words.size())
+    {
+      if (!value)
+        return ;
+      words.resize(index + 1, 0);
+    }
+    if (value)
+      words[index] |=  ((Word)1 << (bit % word_bits));
+    else
+      words[index] &= ~((Word)1 << (bit % word_bits));
+  }
+
+  unsigned int   Count(void) const
+  {
+    unsigned int count = 0;
+
+    for (auto it = words.begin() ; it != words.end() ; ++it)
+    {
+      for (Word word = *it ; word != 0 ; word &= word - 1)
+        ++count;
+    }
+    return (count);
+  }
+
+  // Calls functor with the index of each set bit, in increasing order
+  template<typename FUNCTOR>
+  void           ForEachSet(FUNCTOR functor) const
+  {
+    for (unsigned int i = 0 ; i < words.size() ; ++i)
+    {
+      for (unsigned int bit = 0 ; bit < word_bits && (words[i] >> bit) != 0 ; ++bit)
+      {
+        if ((words[i] >> bit) & 1)
+          functor(i * word_bits + bit);
+      }
+    }
+  }
+
+private:
+  std::vector<Word> words;
+};
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef  SYNC_JOB_SYSTEM_HPP
+# define SYNC_JOB_SYSTEM_HPP
+
+# include <atomic>
+# include <deque>
+# include <vector>
+# include <functional>
+# include <exception>
+# include "thread.hpp"
+# include "semaphore.hpp"
+
+namespace Sync
+{
+  class JobSystem;
+
+  /*
+   * Tracks a batch of jobs. JobSystem::Wait returns once every job pushed with the group is done.
+   * The first exception thrown by one of the jobs is rethrown by Wait.
+   */
+  class JobGroup
+  {
+    friend class JobSystem;
+  public:
+    JobGroup(void) : _pending(0), _has_exception(false) {}
+
+    bool               IsDone(void) const { return (_pending.load(std::memory_order_acquire) == 0); }
+
+  private:
+    JobGroup(const JobGroup&);
+
+    std::atomic<int>   _pending;
+    std::atomic<bool>  _has_exception;
+    std::exception_ptr _exception;
+  };
+
+  /*
+   * Work-stealing job system.
+   * Each worker owns a queue: it pops its own jobs from the back, and steals from the front of the
+   * other queues when it runs out. Threads which are not workers push into a shared queue, and help
+   * running jobs while they Wait on a group.
+   * With zero workers, every job is run by the thread calling Wait.
+   */
+  class JobSystem
+  {
+  public:
+    typedef std::function<void (void)> Job;
+
+    JobSystem(unsigned int worker_count);
+    ~JobSystem(void);
+
+    static JobSystem& Get(void);
+    static unsigned int DefaultWorkerCount(void);
+
+    unsigned int WorkerCount(void) const { return (_workers.size()); }
+    void         Push(JobGroup& group, Job job);
+    void         Wait(JobGroup& group);
+
+    template<typename FUNCTOR>
+    void         ParallelFor(unsigned int begin, unsigned int end, unsigned int grain, FUNCTOR functor)
+    {
+      JobGroup group;
+
+      if (grain == 0)
+        grain = 1;
+      for (unsigned int chunk = begin ; chunk < end ; chunk += grain)
+      {
+        unsigned int chunk_end = (chunk + grain < end ? chunk + grain : end);
+
+        Push(group, [chunk, chunk_end, &functor]()
+        {
+          for (unsigned int i = chunk ; i < chunk_end ; ++i)
+            functor(i);
+        });
+      }
+      Wait(group);
+    }
+
+  private:
+    struct Entry
+    {
+      Entry(void) : group(0) {}
+      Entry(JobGroup* group, Job job) : group(group), job(job) {}
+
+      JobGroup* group;
+      Job       job;
+    };
+
+    struct Queue
+    {
+      Semaphore         lock;
+      std::deque<Entry> entries;
+    };
+
+    class Worker : public MyThread
+    {
+    public:
+      Worker(JobSystem& system, unsigned int index) : system(system), index(index) {}
+
+    protected:
+      void         Run(void);
+
+    private:
+      JobSystem&   system;
+      unsigned int index;
+    };
+
+    JobSystem(const JobSystem&);
+
+    unsigned int       CurrentQueue(void) const;
+    bool               FindJob(unsigned int queue, Entry& entry);
+    bool               PopBack(unsigned int queue, Entry& entry);
+    bool               PopFront(unsigned int queue, Entry& entry);
+    void               Execute(Entry& entry);
+
+    std::vector<Worker*> _workers;
+    std::vector<Queue*>  _queues;
+    Semaphore            _wakeup;
+    std::atomic<bool>    _running;
+  };
+}
+
+#endif
@@ -0,0 +1,189 @@
+#ifndef  LOGGER_HPP
+# define LOGGER_HPP
+
+# include <atomic>
+# include <cstdint>
+# include <cstring>
+# include <functional>
+# include <ostream>
+# include <sstream>
+# include <string>
+
+/*
+ * Leveled logging.
+ * LOG(Ai, Debug) << "Character " << name << " is moving";
+ * Lines below LOG_MIN_SEVERITY are compiled out, lines below the runtime severity of their category
+ * cost a branch. The arguments of enabled lines are captured as binary values in a fixed size record,
+ * which is pushed in a lock-free queue: the formatting and the writing happen on the logger thread
+ * (see Logger::Initialize). Without the logger thread, records are written right away.
+ * Every category starts at the Info severity.
+ */
+# ifndef LOG_MIN_SEVERITY
+#  define LOG_MIN_SEVERITY 0
+# endif
+
+namespace Logger
+{
+  enum Severity
+  {
+    Debug,
+    Info,
+    Warning,
+    Error
+  };
+
+  enum Category
+  {
+    General,
+    Map,
+    Characters,
+    Ai,
+    Combat,
+    Pathfinding,
+    Interactions,
+    Scripts,
+    Console,
+    Saves,
+    CategoryCount
+  };
+
+  const unsigned int record_size  = 240;
+  const unsigned int queue_size   = 1024;
+
+  struct Record
+  {
+    enum Type
+    {
+      String,
+      Integer,
+      Unsigned,
+      Real,
+      Boolean
+    };
+
+    Category       category;
+    Severity       severity;
+    unsigned short size;
+    bool           truncated;
+    char           data[record_size]; // Each argument is a Type byte followed by its value
+  };
+
+  typedef std::function<void (Category, Severity, const std::string&)> Sink;
+
+  extern std::atomic<int> levels[CategoryCount];
+
+  inline bool  IsEnabled(Category category, Severity severity)
+  {
+    return (severity >= LOG_MIN_SEVERITY && severity >= levels[category].load(std::memory_order_relaxed));
+  }
+
+  void         SetLevel(Category category, Severity severity);
+  void         SetLevel(Severity severity);
+  bool         SetLevel(const std::string& category, const std::string& severity);
+  const char*  GetName(Category category);
+  const char*  GetName(Severity severity);
+  void         AddSink(Sink sink);
+  void         ClearSinks(void);
+  void         SetConsoleOutput(bool);
+  void         Submit(const Record& record);
+  std::string  Format(const Record& record);
+  void         Initialize(void);
+  void         Flush(void);
+  void         Finalize(void);
+  unsigned int GetDroppedCount(void);
+
+  /*
+   * Captures the arguments of one line: the record is submitted when the line goes out of scope.
+   * Arguments which aren't strings, numbers or booleans are formatted right away.
+   */
+  class Line
+  {
+  public:
+    Line(Category category, Severity severity)
+    {
+      record.category  = category;
+      record.severity  = severity;
+      record.size      = 0;
+      record.truncated = false;
+    }
+
+    ~Line() { Submit(record); }
+
+    Line& operator<<(const char* str)                        { Append(str, std::strlen(str));                    return (*this); }
+    Line& operator<<(const std::string& str)                 { Append(str.c_str(), str.size());                  return (*this); }
+    Line& operator<<(char c)                                 { Append(&c, 1);                                    return (*this); }
+    Line& operator<<(bool value)                             { Append(Record::Boolean, value);                   return (*this); }
+    Line& operator<<(int value)                              { Append(Record::Integer, (std::int64_t)value);     return (*this); }
+    Line& operator<<(long value)                             { Append(Record::Integer, (std::int64_t)value);     return (*this); }
+    Line& operator<<(long long value)                        { Append(Record::Integer, (std::int64_t)value);     return (*this); }
+    Line& operator<<(short value)                            { Append(Record::Integer, (std::int64_t)value);     return (*this); }
+    Line& operator<<(unsigned int value)                     { Append(Record::Unsigned, (std::uint64_t)value);   return (*this); }
+    Line& operator<<(unsigned long value)                    { Append(Record::Unsigned, (std::uint64_t)value);   return (*this); }
+    Line& operator<<(unsigned long long value)               { Append(Record::Unsigned, (std::uint64_t)value);   return (*this); }
+    Line& operator<<(unsigned short value)                   { Append(Record::Unsigned, (std::uint64_t)value);   return (*this); }
+    Line& operator<<(float value)                            { Append(Record::Real, (double)value);              return (*this); }
+    Line& operator<<(double value)                           { Append(Record::Real, value);                      return (*this); }
+    Line& operator<<(std::ostream& (*)(std::ostream&))       { return (*this); } // Records are lines already: endl is ignored
+
+    template<typename T>
+    Line& operator<<(const T& value)
+    {
+      std::stringstream stream;
+
+      stream << value;
+      return (*this << stream.str());
+    }
+
+  private:
+    template<typename T>
+    void  Append(Record::Type type, T value)
+    {
+      if (record.size + 1 + sizeof(T) > record_size)
+        record.truncated = true;
+      else
+      {
+        record.data[record.size] = (char)type;
+        std::memcpy(&record.data[record.size + 1], &value, sizeof(T));
+        record.size += 1 + sizeof(T);
+      }
+    }
+
+    void  Append(const char* str, std::size_t length)
+    {
+      unsigned short available = record_size - record.size;
+
+      if (available < 1 + sizeof(unsigned short))
+      {
+        record.truncated = true;
+        return ;
+      }
+      available -= 1 + sizeof(unsigned short);
+      if (length > available)
+      {
+        length           = available;
+        record.truncated = true;
+      }
+      {
+        unsigned short size = length;
+
+        record.data[record.size] = (char)Record::String;
+        std::memcpy(&record.data[record.size + 1], &size, sizeof(size));
+        std::memcpy(&record.data[record.size + 1 + sizeof(size)], str, length);
+        record.size += 1 + sizeof(size) + length;
+      }
+    }
+
+    Record record;
+  };
+
+  // Lets LOG be an expression, so that it can't steal the else of an enclosing if.
+  struct Voidify
+  {
+    void operator&(const Line&) {}
+  };
+}
+
+# define LOG(category, severity) \
+  !(Logger::IsEnabled(Logger::category, Logger::severity)) ? (void)0 : Logger::Voidify() & Logger::Line(Logger::category, Logger::severity)
+
+#endif
@@ -6,6 +6,8 @@
 # include <algorithm>
 # include <functional>
 # include <fstream>
+# include <vector>
+# include <cstdint>
 # include <serializer.hpp>
 # include <directory.hpp>
 
@@ -48,12 +50,91 @@ namespace Utils
     unsigned long buffer_length;
   };
   
+  /*
+   * Chunked archive: each entry is deflated on its own, and a table of contents at the end of the file
+   * tells where each entry lives. Entries are streamed through fixed-size buffers both ways, so memory
+   * usage doesn't depend on the size of the archive.
+   * Replacing an entry appends the new data and a new table of contents after the current one: the
+   * previous data and table of contents become dead space, which Compact reclaims. Nothing written before
+   * is overwritten, so an interrupted update leaves the archive as it was at its last Commit.
+   *
+   * Layout: [magic][version] [entry data...] [table of contents] [toc offset][toc size][magic]
+   */
+  class Archive
+  {
+  public:
+    struct Exception : public std::exception
+    {
+    public:
+      Exception(const std::string& message) : message("archive: " + message) {}
+      ~Exception() throw() {}
+
+      const char* what(void) const throw() { return (message.c_str()); }
+
+    private:
+      std::string message;
+    };
+
+    struct Entry
+    {
+      std::string   name;
+      std::uint64_t offset, compressed_size, size;
+      std::uint32_t crc;
+    };
+
+    typedef std::vector<Entry> Entries;
+
+    static const unsigned int buffer_size = 64 * 1024;
+
+    Archive(void) : data_end(0), dead_space(0), toc_space(0) {}
+
+    static bool    IsArchive(const std::string& path);
+
+    bool           Open(const std::string& path);
+    void           Create(const std::string& path);
+    void           Commit(void);
+    void           Close(void);
+
+    const Entries& GetEntries(void) const { return (entries); }
+    const Entry*   Find(const std::string& name) const;
+    std::uint64_t  DeadSpace(void) const { return (dead_space); }
+
+    void           AddFile(const std::string& name, const std::string& source_path);
+    void           Add(const std::string& name, std::istream& input);
+    bool           UpdateFile(const std::string& name, const std::string& source_path);
+    static bool    Matches(const Entry& entry, const std::string& source_path);
+    void           CopyEntry(Archive& source, const Entry& entry);
+    void           Extract(const Entry& entry, std::ostream& output);
+    bool           ExtractFile(const std::string& name, const std::string& target_path);
+
+    static void    Compact(const std::string& path);
+
+  private:
+    void           SetEntry(const Entry& entry);
+    bool           FindFooter(std::uint64_t file_size, std::uint64_t& toc_offset, std::uint32_t& toc_size);
+    void           ReadTableOfContents(void);
+
+    std::string    path;
+    std::fstream   file;
+    Entries        entries;
+    std::uint64_t  data_end;
+    std::uint64_t  dead_space;
+    std::uint64_t  toc_space;  // Size of the last committed table of contents and its footer
+  };
+
   class DirectoryCompressor
   {
     DirectoryCompressor() {}
   public:
-    static void Compress(const std::string& target, const std::string& path, std::function<bool (const std::string&)> selector = [](const std::string&) { return (true); });
-    static void Uncompress(const std::string& path, const std::string& target);
+    typedef std::function<bool (const std::string&)> Selector;
+
+    static void Compress(const std::string& target, const std::string& path, Selector selector = [](const std::string&) { return (true); });
+    static void Uncompress(const std::string& path, const std::string& target, Selector selector = [](const std::string&) { return (true); });
+    static void Update(const std::string& target, const std::string& path, const std::string& previous, Selector selector = [](const std::string&) { return (true); });
+
+  private:
+    static void UpdateInPlace(Archive& archive, const std::string& target, const std::string& path, Selector selector);
+    static void UncompressLegacy(const std::string& path, const std::string& target);
   };
 }
 
@@ -5,12 +5,15 @@
 
 # include <list>
 # include <queue>
+# include <vector>
+# include <atomic>
 # include <algorithm>
 # include <iostream>
 # include <functional>
 
 # include "semaphore.hpp"
 # include "serializer.hpp"
+# include "ring_buffer.hpp"
 
 # define S1P_TPL                class P1 = void
 # define S1P_TFUN               P1 (void)
@@ -92,8 +95,6 @@
     {                                                                   \
       virtual ~InterfaceObserver() {}                                   \
       virtual void operator()(PARAMS) = 0;                              \
-                                                                        \
-      ObserverId id;                                                    \
     };                                                                  \
                                                                         \
     template<typename ObserverClass>                                    \
@@ -124,7 +125,7 @@
         Function _function;                                             \
     };                                                                  \
                                                                         \
-    typedef std::list<InterfaceObserver*> Observers;                    \
+    typedef ObserverSet<InterfaceObserver> Observers;                   \
   public:                                                               \
     struct RecordedCall                                                 \
     {                                                                   \
@@ -137,159 +138,348 @@
                                                                         \
       void Unserialize(Utils::Packet& packet)                           \
       {                                                                 \
-        RECORD_UNSERI;                                        \
+        RECORD_UNSERI;                                                  \
       }                                                                 \
                                                                         \
       RECORD_ATTR                                                       \
     };                                                                  \
                                                                         \
-    typedef std::queue<RecordedCall*> RecordedCalls;                    \
+    typedef DeferredCalls<RecordedCall> RecordedCalls;                  \
                                                                         \
     Signal(bool direct = true) : _direct(direct)                        \
-    { _semaphore.SetDeadlockSafety(true); }                             \
-                                                                        \
-    ~Signal()                                                           \
     {                                                                   \
-      typename Observers::iterator it  = _observers.begin();            \
-      typename Observers::iterator end = _observers.end();              \
+      if (!direct)                                                      \
+        _recordedCalls.Reserve();                                       \
+    }                                                                   \
                                                                         \
-      for (; it != end ; ++it)                                          \
-        delete *it;                                                     \
+    void       SetDirect(bool set)                                      \
+    {                                                                   \
+      if (!set)                                                         \
+        _recordedCalls.Reserve();                                       \
+      _direct = set;                                                    \
     }                                                                   \
                                                                         \
-    void       SetDirect(bool set)  { _direct = set;    }               \
     bool       IsDirect(void) const { return (_direct); }               \
                                                                         \
     void       Emit(PARAMS)                                             \
     {                                                                   \
       if (_direct)                                                      \
-      {                                                                 \
-        _iterator = _observers.begin();                                 \
-        while (_iterator != _observers.end())                           \
-        {                                                               \
-          _iterator_updated_during_emit = false;                        \
-          (**_iterator)(VALUES);                                        \
-          if (_iterator_updated_during_emit == false)                   \
-            _iterator++;                                                \
-        }                                                               \
-      }                                                                 \
+        _observers.Emit([&](InterfaceObserver& observer) { observer(VALUES); }); \
       else                                                              \
-      {                                                                 \
-        Semaphore::Lock lock(_semaphore);                               \
-                                                                        \
-        _recordedCalls.push(new RecordedCall(VALUES));                  \
-      }                                                                 \
+        _recordedCalls.Push(RecordedCall(VALUES));                      \
     }                                                                   \
                                                                         \
     template<typename ObserverClass>                                    \
     ObserverId Connect(ObserverClass& observerInstance, typename Observer<ObserverClass>::Method method) \
     {                                                                   \
-      InterfaceObserver* observer = new Observer<ObserverClass>(observerInstance, method); \
-                                                                        \
-      return (AddObserver(observer));                                   \
+      return (_observers.Add(new Observer<ObserverClass>(observerInstance, method))); \
     }                                                                   \
                                                                         \
     ObserverId Connect(typename FunctionObserver::Function function)    \
     {                                                                   \
-      InterfaceObserver* observer = new FunctionObserver(function);     \
-                                                                        \
-      return (AddObserver(observer));                                   \
+      return (_observers.Add(new FunctionObserver(function)));          \
     }                                                                   \
                                                                         \
     void       Disconnect(ObserverId id)                                \
     {                                                                   \
-      typename Observers::iterator toDel = _observers.begin();          \
-      typename Observers::iterator end   = _observers.end();            \
-                                                                        \
-      for (; toDel != end ; ++toDel)                                    \
-      {                                                                 \
-        if (*toDel == id)                                               \
-        {                                                               \
-          InterfaceObserver* observer = *toDel;                         \
-                                                                        \
-          if (toDel == _iterator)                                       \
-          {                                                             \
-            _iterator_updated_during_emit = true;                       \
-            _iterator = _observers.erase(toDel);                        \
-          }                                                             \
-          else                                                          \
-            _observers.erase(toDel);                                    \
-          delete observer;                                              \
-          break ;                                                       \
-        }                                                               \
-      }                                                                 \
+      _observers.Remove(id);                                            \
     }                                                                   \
                                                                         \
     void       DisconnectAll(void)                                      \
     {                                                                   \
-      typename Observers::iterator toDel = _observers.begin();          \
-      typename Observers::iterator end   = _observers.end();            \
-                                                                        \
-      while (_observers.begin() != end)                                 \
-      {                                                                 \
-        delete *(_observers.begin());                                   \
-        _observers.erase(_observers.begin());                           \
-      }                                                                 \
-      _iterator = _observers.end();                                     \
+      _observers.Clear();                                               \
     }                                                                   \
                                                                         \
     inline int ObserverCount(void) const                                \
     {                                                                   \
-      return (_observers.size());                                       \
+      return (_observers.Count());                                      \
     }                                                                   \
                                                                         \
     void       ExecuteRecordedCalls(void)                               \
     {                                                                   \
-      Semaphore::Lock lock(_semaphore);                                 \
-                                                                        \
-      FuncExecuteRecordedCalls(_recordedCalls);                         \
-      FuncExecuteRecordedCalls(_pushedCalls);                           \
-    }                                                                   \
-                                                                        \
-    void       FuncExecuteRecordedCalls(RecordedCalls& calls)           \
-    {                                                                   \
-      while (calls.size())                                              \
+      _recordedCalls.Consume([this](RecordedCall& params)               \
       {                                                                 \
-        RecordedCall& params = *(calls.front());                        \
-                                                                        \
-        _iterator = _observers.begin();                                 \
-        while (_iterator != _observers.end())                           \
-        {                                                               \
-          _iterator_updated_during_emit = false;                        \
-          (**_iterator)(RECORD_VAL);                                    \
-          if (_iterator_updated_during_emit == false)                   \
-            _iterator++;                                                \
-        }                                                               \
-		delete &params;                                                 \
-        calls.pop();                                                    \
-      }                                                                 \
+        _observers.Emit([&params](InterfaceObserver& observer) { observer(RECORD_VAL); }); \
+      });                                                               \
     }                                                                   \
                                                                         \
-  private:                                                              \
-    ObserverId AddObserver(InterfaceObserver* observer)                 \
+    int        RecordCallCount(void) const                              \
     {                                                                   \
-      ObserverId id = observer;                                         \
-                                                                        \
-      _observers.push_back(observer);                                   \
-      return (id);                                                      \
+      return (_recordedCalls.Count());                                  \
     }                                                                   \
                                                                         \
-    typename Observers::iterator _iterator;                             \
-    bool                         _iterator_updated_during_emit;         \
+  private:                                                              \
     Observers                    _observers;                            \
     RecordedCalls                _recordedCalls;                        \
-    RecordedCalls                _backedupCalls;                        \
-    RecordedCalls                _pushedCalls;                          \
     bool                         _direct;                               \
-    Semaphore                    _semaphore;                            \
   };
 
 namespace Sync
 {
-  typedef void* ObserverId;
-  
+  /*
+   * Observer ids are made of a handle index (low 32 bits) and a generation (high 32 bits).
+   * The generation changes whenever a handle is released, so disconnecting with a stale id
+   * never removes another observer. 0 is never a valid id.
+   */
+  typedef unsigned long long ObserverId;
+
   class ObserverHandler;
-  
+
+  /*
+   * Contiguous array of observers, kept in connection order.
+   * Observers removed while an emission is running are only nulled out: the array is compacted
+   * and the observers deleted once the outermost emission returns.
+   */
+  template<typename OBSERVER>
+  class ObserverSet
+  {
+    struct Slot
+    {
+      Slot(OBSERVER* observer, unsigned int handle) : observer(observer), handle(handle) {}
+      OBSERVER*    observer;
+      unsigned int handle;
+    };
+
+    struct Handle
+    {
+      Handle(void) : generation(1), position(0) {}
+      unsigned int generation;
+      unsigned int position;
+    };
+
+  public:
+    ObserverSet(void) : _emit_depth(0), _count(0) {}
+    ObserverSet(const ObserverSet&) : _emit_depth(0), _count(0) {}
+    ObserverSet& operator=(const ObserverSet&) { return (*this); }
+
+    ~ObserverSet()
+    {
+      for (unsigned int i = 0 ; i < _slots.size() ; ++i)
+        delete _slots[i].observer;
+      for (unsigned int i = 0 ; i < _garbage.size() ; ++i)
+        delete _garbage[i];
+    }
+
+    ObserverId Add(OBSERVER* observer)
+    {
+      unsigned int handle;
+
+      if (_free_handles.size() > 0)
+      {
+        handle = _free_handles.back();
+        _free_handles.pop_back();
+      }
+      else
+      {
+        handle = _handles.size();
+        _handles.push_back(Handle());
+      }
+      _handles[handle].position = _slots.size();
+      _slots.push_back(Slot(observer, handle));
+      ++_count;
+      return (((ObserverId)_handles[handle].generation << 32) | handle);
+    }
+
+    bool       Remove(ObserverId id)
+    {
+      unsigned int handle     = (unsigned int)(id & 0xffffffff);
+      unsigned int generation = (unsigned int)(id >> 32);
+
+      if (handle >= _handles.size() || _handles[handle].generation != generation)
+        return (false);
+      Release(_handles[handle].position);
+      return (true);
+    }
+
+    void       Clear(void)
+    {
+      unsigned int i = _slots.size();
+
+      while (i-- > 0)
+      {
+        if (_slots[i].observer)
+          Release(i);
+      }
+    }
+
+    int        Count(void) const { return (_count); }
+
+    template<typename FUNCTOR>
+    void       Emit(FUNCTOR functor)
+    {
+      ++_emit_depth;
+      try
+      {
+        // Observers connected during the emission are called as well: the size is read at each iteration.
+        for (unsigned int i = 0 ; i < _slots.size() ; ++i)
+        {
+          OBSERVER* observer = _slots[i].observer;
+
+          if (observer)
+            functor(*observer);
+        }
+      }
+      catch (...)
+      {
+        EndEmit();
+        throw ;
+      }
+      EndEmit();
+    }
+
+  private:
+    void       EndEmit(void)
+    {
+      if (--_emit_depth == 0 && _garbage.size() > 0)
+        CollectGarbage();
+    }
+
+    void       Release(unsigned int position)
+    {
+      Slot&   slot   = _slots[position];
+      Handle& handle = _handles[slot.handle];
+
+      if (++handle.generation == 0)
+        handle.generation = 1;
+      _free_handles.push_back(slot.handle);
+      --_count;
+      if (_emit_depth > 0)
+      {
+        _garbage.push_back(slot.observer);
+        slot.observer = 0;
+      }
+      else
+      {
+        delete slot.observer;
+        _slots.erase(_slots.begin() + position);
+        for (unsigned int i = position ; i < _slots.size() ; ++i)
+          _handles[_slots[i].handle].position = i;
+      }
+    }
+
+    void       CollectGarbage(void)
+    {
+      unsigned int position = 0;
+
+      for (unsigned int i = 0 ; i < _slots.size() ; ++i)
+      {
+        if (_slots[i].observer)
+        {
+          _slots[position] = _slots[i];
+          _handles[_slots[position].handle].position = position;
+          ++position;
+        }
+      }
+      _slots.erase(_slots.begin() + position, _slots.end());
+      for (unsigned int i = 0 ; i < _garbage.size() ; ++i)
+        delete _garbage[i];
+      _garbage.clear();
+    }
+
+    std::vector<Slot>         _slots;
+    std::vector<Handle>       _handles;
+    std::vector<unsigned int> _free_handles;
+    std::vector<OBSERVER*>    _garbage;
+    unsigned int              _emit_depth;
+    int                       _count;
+  };
+
+  /*
+   * Queue of calls recorded by non-direct signals, which may be emitted from any thread.
+   * Calls are stored in a lock-free ring buffer allocated once per signal. When the ring is full,
+   * calls go to a locked overflow queue until the consumer drains it, so that no call is lost and
+   * the emission order is preserved.
+   * The ring is allocated by the first Reserve or Push: the pointer is published with release semantics,
+   * and a thread finding it null takes the lock and checks again before allocating it.
+   */
+  template<typename CALL>
+  class DeferredCalls
+  {
+  public:
+    static const std::size_t PoolSize = 64;
+
+    DeferredCalls(void) : _ring(0), _overflowing(false), _count(0) { _semaphore.SetDeadlockSafety(true); }
+    DeferredCalls(const DeferredCalls&) : _ring(0), _overflowing(false), _count(0) { _semaphore.SetDeadlockSafety(true); }
+    DeferredCalls& operator=(const DeferredCalls&) { return (*this); }
+
+    ~DeferredCalls()
+    {
+      delete _ring.load();
+    }
+
+    void Reserve(void)
+    {
+      GetRing();
+    }
+
+    void Push(const CALL& call)
+    {
+      RingBuffer<CALL>* ring = GetRing();
+
+      ++_count;
+      if (!(_overflowing.load(std::memory_order_acquire)) && ring->TryPush(call))
+        return ;
+      {
+        Semaphore::Lock lock(_semaphore);
+
+        _overflowing.store(true, std::memory_order_release);
+        _overflow.push(call);
+      }
+    }
+
+    template<typename FUNCTOR>
+    void Consume(FUNCTOR functor)
+    {
+      RingBuffer<CALL>* ring = _ring.load(std::memory_order_acquire);
+
+      if (ring)
+      {
+        while (ring->TryConsume([this, &functor](CALL& call) { --_count; functor(call); }));
+      }
+      if (_overflowing.load(std::memory_order_acquire))
+      {
+        Semaphore::Lock lock(_semaphore);
+
+        while (_overflow.size() > 0)
+        {
+          CALL call = _overflow.front();
+
+          _overflow.pop();
+          --_count;
+          functor(call);
+        }
+        _overflowing.store(false, std::memory_order_release);
+      }
+    }
+
+    int  Count(void) const { return (_count.load()); }
+
+  private:
+    RingBuffer<CALL>* GetRing(void)
+    {
+      RingBuffer<CALL>* ring = _ring.load(std::memory_order_acquire);
+
+      if (!ring)
+      {
+        Semaphore::Lock lock(_semaphore);
+
+        ring = _ring.load(std::memory_order_relaxed);
+        if (!ring)
+        {
+          ring = new RingBuffer<CALL>(PoolSize);
+          _ring.store(ring, std::memory_order_release);
+        }
+      }
+      return (ring);
+    }
+
+    std::atomic<RingBuffer<CALL>*> _ring;
+    std::queue<CALL>               _overflow;
+    std::atomic<bool>              _overflowing;
+    std::atomic<int>               _count;
+    Semaphore                      _semaphore;
+  };
+
   class ISignal
   {
   public:
@@ -323,8 +513,6 @@ namespace Sync
     {
       virtual ~InterfaceObserver() {}
       virtual void operator()() = 0;
-
-      ObserverId id;
     };
 
     class FunctionObserver : public InterfaceObserver
@@ -358,7 +546,7 @@ namespace Sync
       Method         _method;
     };
 
-    typedef std::list<InterfaceObserver*> Observers;
+    typedef ObserverSet<InterfaceObserver> Observers;
   public:
     struct RecordedCall
     {
@@ -366,177 +554,105 @@ namespace Sync
       void Unserialize(Utils::Packet& packet) {}
       bool byte;
     };
-    typedef std::queue<RecordedCall> RecordedCalls;
 
-    Signal(bool direct = true) : _direct(direct)
-    { _semaphore.SetDeadlockSafety(true); }
+    // Parameterless calls carry no data: recording one is a counter increment.
+    Signal(bool direct = true) : _direct(direct), _recordedCalls(0), _backedupCalls(0), _pushedCalls(0)
+    {}
 
-    ~Signal()
-    {
-      typename Observers::iterator it  = _observers.begin();
-      typename Observers::iterator end = _observers.end();
+    Signal(const Signal& copy) : _direct(copy._direct), _recordedCalls(0), _backedupCalls(0), _pushedCalls(0)
+    {}
+
+    Signal& operator=(const Signal&) { return (*this); }
 
-      for (; it != end ; ++it)
-        delete *it;
-    }
-    
     void       SetDirect(bool set)  { _direct = set;    }
     bool       IsDirect(void) const { return (_direct); }
 
     void       Emit()
     {
       if (_direct)
-      {
-        _iterator = _observers.begin();
-        while (_iterator != _observers.end())
-        {
-          _iterator_updated_during_emit = false;
-          (**_iterator)();
-          if (_iterator_updated_during_emit == false)
-            _iterator++;
-        }
-      }
+        _observers.Emit([](InterfaceObserver& observer) { observer(); });
       else
-        _recordedCalls.push(RecordedCall());
+        ++_recordedCalls;
     }
 
     template<class ObserverClass>
     ObserverId Connect(ObserverClass& observerInstance, typename Observer<ObserverClass>::Method method)
     {
-      InterfaceObserver* observer = new Observer<ObserverClass>(observerInstance, method);
-
-      return (AddObserver(observer));
+      return (_observers.Add(new Observer<ObserverClass>(observerInstance, method)));
     }
 
     ObserverId Connect(typename FunctionObserver::Function function)
     {
-      InterfaceObserver* observer = new FunctionObserver(function);
-
-      return (AddObserver(observer));
+      return (_observers.Add(new FunctionObserver(function)));
     }
 
     void       Disconnect(ObserverId id)
     {
-      typename Observers::iterator toDel = _observers.begin();
-      typename Observers::iterator end   = _observers.end();
-
-      for (; toDel != end ; ++toDel)
-      {
-        if (*toDel == id)
-        {
-          InterfaceObserver* observer = *toDel;
-
-          if (toDel == _iterator)
-          {
-            _iterator_updated_during_emit = true;
-            _iterator = _observers.erase(toDel);
-          }
-          else
-            _observers.erase(toDel);
-          delete observer;
-          break ;
-        }
-      }
+      _observers.Remove(id);
     }
 
     void       DisconnectAll(void)
     {
-      typename Observers::iterator toDel = _observers.begin();
-      typename Observers::iterator end   = _observers.end();
-
-      while (_observers.begin() != end)
-      {
-        delete *(_observers.begin());
-        _observers.erase(_observers.begin());
-      }
-      _iterator = _observers.end();
+      _observers.Clear();
     }
 
     inline int ObserverCount(void) const
     {
-      return (_observers.size());
+      return (_observers.Count());
     }
-    
+
     void       ExecuteRecordedCalls(void)
     {
-      Semaphore::Lock lock(_semaphore);
-
       FuncExecuteRecordedCalls(_recordedCalls);
       FuncExecuteRecordedCalls(_pushedCalls);
     }
 
-    void       FuncExecuteRecordedCalls(RecordedCalls& calls)
+    void       FuncExecuteRecordedCalls(std::atomic<int>& calls)
     {
-      while (calls.size())
-      {
-        _iterator = _observers.begin();
-        while (_iterator != _observers.end())
-        {
-          _iterator_updated_during_emit = false;
-          (**_iterator)();
-          if (_iterator_updated_during_emit == false)
-            _iterator++;
-        }
-        calls.pop();
-      }
+      for (int count = calls.exchange(0) ; count > 0 ; --count)
+        _observers.Emit([](InterfaceObserver& observer) { observer(); });
     }
 
     void       PushRecordCall(Utils::Packet& packet)
     {
-      Semaphore::Lock lock(_semaphore);
-      RecordedCall    params;
+      RecordedCall params;
 
       params.Unserialize(packet);
-      _pushedCalls.push(params);
+      ++_pushedCalls;
     }
-    
+
     bool       FetchRecordCall(Utils::Packet& packet)
     {
-      Semaphore::Lock lock(_semaphore);
-      RecordedCall&   params = _recordedCalls.front();
+      RecordedCall params;
 
       params.Serialize(packet);
-      _recordedCalls.pop();
-      return (_recordedCalls.size() > 0);
+      return (--_recordedCalls > 0);
     }
-    
+
     int        RecordCallCount(void)
     {
-      Semaphore::Lock lock(_semaphore);
-      return (_recordedCalls.size());
+      return (_recordedCalls.load());
     }
 
     int        PushedCallCount(void)
     {
-      Semaphore::Lock lock(_semaphore);
-      return (_pushedCalls.size());
+      return (_pushedCalls.load());
     }
 
     void       BackupRecordedCalls(bool on_off)
     {
       if (on_off)
-        _backedupCalls = _recordedCalls;
+        _backedupCalls.store(_recordedCalls.load());
       else
-        _recordedCalls = _backedupCalls;
+        _recordedCalls.store(_backedupCalls.load());
     }
 
   private:
-    ObserverId AddObserver(InterfaceObserver* observer)
-    {
-      ObserverId id = observer;
-
-      _observers.push_back(observer);
-      return (id);
-    }
-
-    typename Observers::iterator _iterator;
-    bool                         _iterator_updated_during_emit;
     Observers                    _observers;
-    RecordedCalls                _recordedCalls;
-    RecordedCalls                _backedupCalls;
-    RecordedCalls                _pushedCalls;
     bool                         _direct;
-    Semaphore                    _semaphore;
+    std::atomic<int>             _recordedCalls;
+    std::atomic<int>             _backedupCalls;
+    std::atomic<int>             _pushedCalls;
   };
  
   //DECL_SIGNAL(S1P_TPL, S1P_TFUN, S1P_PARAMS, S1P_VALUES, S1P_RECORD_CON, S1P_RECORD_ATTR, S1P_RECORD_VAL, S1P_RECORD_SERI, S1P_RECORD_UNSERI) 
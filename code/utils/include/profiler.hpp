@@ -0,0 +1,97 @@
+#ifndef  PROFILER_HPP
+# define PROFILER_HPP
+
+# include <atomic>
+# include <cstdint>
+# include <string>
+# include <vector>
+
+/*
+ * Scoped zones profiler.
+ * PROFILE_ZONE("Level:Frame") records the time spent until the end of the enclosing scope. Each thread
+ * records in a ring buffer of its own, keeping its last Profiler::buffer_size zones: recording never
+ * locks nor allocates. The recorded zones can be exported in the Chrome trace format (chrome://tracing).
+ * Zones are also forwarded to PStats, which ignores them unless a PStats server is connected.
+ * The macros are compiled out unless PROFILER_ENABLED is defined (the PROFILER CMake option), and zones
+ * are only recorded once the profiler is enabled with SetEnabled(true).
+ */
+namespace Profiler
+{
+  const unsigned int buffer_size = 16384;
+
+  struct Event
+  {
+    const char*   name; // Zone names must outlive the profiler: use string literals or Intern
+    std::uint64_t start, end; // microseconds
+  };
+
+  class ThreadBuffer
+  {
+  public:
+    ThreadBuffer(unsigned int thread_id) : thread_id(thread_id), count(0), first(0), events(buffer_size) {}
+
+    void               Push(const char* name, std::uint64_t start, std::uint64_t end)
+    {
+      unsigned int index = count.load(std::memory_order_relaxed);
+      Event&       event = events[index % buffer_size];
+
+      event.name  = name;
+      event.start = start;
+      event.end   = end;
+      count.store(index + 1, std::memory_order_release);
+    }
+
+    // The recorded events, oldest first. Events recorded during the copy may be missing or overwrite the oldest ones.
+    std::vector<Event> Copy(void) const;
+    void               Clear(void)             { first.store(count.load(std::memory_order_acquire), std::memory_order_relaxed); }
+    unsigned int       GetThreadId(void) const { return (thread_id); }
+
+  private:
+    unsigned int              thread_id;
+    std::atomic<unsigned int> count;
+    std::atomic<unsigned int> first;
+    std::vector<Event>        events;
+  };
+
+  std::uint64_t Now(void);
+  ThreadBuffer& GetThreadBuffer(void);
+  const char*   Intern(const std::string& name);
+  void          SetEnabled(bool);
+  bool          IsEnabled(void);
+  void          Clear(void);
+  bool          ExportChromeTrace(const std::string& path);
+  std::string   ChromeTrace(void);
+
+  class Zone
+  {
+  public:
+    Zone(const char* name) : name(name), start(IsEnabled() ? Now() : 0) {}
+    ~Zone()
+    {
+      if (start != 0)
+        GetThreadBuffer().Push(name, start, Now());
+    }
+
+  private:
+    const char*   name;
+    std::uint64_t start;
+  };
+}
+
+# ifdef PROFILER_ENABLED
+#  include <panda3d/pStatCollector.h>
+#  include <panda3d/pStatTimer.h>
+#  define PROFILER_CONCAT_(a, b) a##b
+#  define PROFILER_CONCAT(a, b)  PROFILER_CONCAT_(a, b)
+#  define PROFILE_ZONE(name) \
+  static PStatCollector PROFILER_CONCAT(profiler_collector_, __LINE__)(name); \
+  PStatTimer            PROFILER_CONCAT(profiler_timer_, __LINE__)(PROFILER_CONCAT(profiler_collector_, __LINE__)); \
+  Profiler::Zone        PROFILER_CONCAT(profiler_zone_, __LINE__)(name)
+// For names known at runtime (see Profiler::Intern): these aren't forwarded to PStats.
+#  define PROFILE_DYNAMIC_ZONE(name) Profiler::Zone PROFILER_CONCAT(profiler_zone_, __LINE__)(name)
+# else
+#  define PROFILE_ZONE(name)
+#  define PROFILE_DYNAMIC_ZONE(name)
+# endif
+
+#endif
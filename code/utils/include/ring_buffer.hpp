@@ -0,0 +1,142 @@
+#ifndef  SYNC_RING_BUFFER_HPP
+# define SYNC_RING_BUFFER_HPP
+
+# include <atomic>
+# include <cstddef>
+# include <new>
+# include <type_traits>
+
+namespace Sync
+{
+  /*
+   * Bounded lock-free queue (Dmitry Vyukov's sequenced cells).
+   * Any amount of threads may push and pop concurrently. Values are constructed in place in
+   * storage allocated once with the buffer: pushing and popping never allocates.
+   * The capacity is rounded up to a power of two.
+   */
+  template<typename T>
+  class RingBuffer
+  {
+    struct Cell
+    {
+      std::atomic<std::size_t>                                                    sequence;
+      typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage;
+    };
+
+    struct Release
+    {
+      Release(Cell& cell, T& value, std::size_t sequence) : cell(cell), value(value), sequence(sequence) {}
+      ~Release()
+      {
+        value.~T();
+        cell.sequence.store(sequence, std::memory_order_release);
+      }
+
+      Cell&       cell;
+      T&          value;
+      std::size_t sequence;
+    };
+
+  public:
+    RingBuffer(std::size_t capacity = 64) : _enqueue_position(0), _dequeue_position(0)
+    {
+      std::size_t size = 2;
+
+      while (size < capacity)
+        size <<= 1;
+      _mask  = size - 1;
+      _cells = new Cell[size];
+      for (std::size_t i = 0 ; i < size ; ++i)
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ~RingBuffer()
+    {
+      while (TryConsume([](T&) {}));
+      delete[] _cells;
+    }
+
+    std::size_t Capacity(void) const { return (_mask + 1); }
+
+    bool        TryPush(const T& value)
+    {
+      Cell*       cell;
+      std::size_t position = _enqueue_position.load(std::memory_order_relaxed);
+
+      for (;;)
+      {
+        std::size_t    sequence;
+        std::ptrdiff_t diff;
+
+        cell     = &_cells[position & _mask];
+        sequence = cell->sequence.load(std::memory_order_acquire);
+        diff     = (std::ptrdiff_t)sequence - (std::ptrdiff_t)position;
+        if (diff == 0)
+        {
+          if (_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            break ;
+        }
+        else if (diff < 0)
+          return (false);
+        else
+          position = _enqueue_position.load(std::memory_order_relaxed);
+      }
+      new (&cell->storage) T(value);
+      cell->sequence.store(position + 1, std::memory_order_release);
+      return (true);
+    }
+
+    // Calls functor on the oldest value, then destroys it. The cell is released even if functor throws.
+    template<typename FUNCTOR>
+    bool        TryConsume(FUNCTOR functor)
+    {
+      Cell*       cell;
+      std::size_t position = _dequeue_position.load(std::memory_order_relaxed);
+
+      for (;;)
+      {
+        std::size_t    sequence;
+        std::ptrdiff_t diff;
+
+        cell     = &_cells[position & _mask];
+        sequence = cell->sequence.load(std::memory_order_acquire);
+        diff     = (std::ptrdiff_t)sequence - (std::ptrdiff_t)(position + 1);
+        if (diff == 0)
+        {
+          if (_dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            break ;
+        }
+        else if (diff < 0)
+          return (false);
+        else
+          position = _dequeue_position.load(std::memory_order_relaxed);
+      }
+      {
+        T&      value = *reinterpret_cast<T*>(&cell->storage);
+        Release release(*cell, value, position + _mask + 1);
+
+        functor(value);
+      }
+      return (true);
+    }
+
+    bool        TryPop(T& out)
+    {
+      return (TryConsume([&out](T& value) { out = value; }));
+    }
+
+  private:
+    RingBuffer(const RingBuffer&);
+    RingBuffer& operator=(const RingBuffer&);
+
+    Cell*                    _cells;
+    std::size_t              _mask;
+    char                     _pad0[64];
+    std::atomic<std::size_t> _enqueue_position;
+    char                     _pad1[64];
+    std::atomic<std::size_t> _dequeue_position;
+    char                     _pad2[64];
+  };
+}
+
+#endif
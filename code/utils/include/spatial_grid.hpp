@@ -0,0 +1,119 @@
+#ifndef  SPATIAL_GRID_HPP
+# define SPATIAL_GRID_HPP
+
+# include <unordered_map>
+# include <vector>
+# include <algorithm>
+# include <cstdlib>
+# include <cmath>
+# include <cstdint>
+
+/*
+ * Uniform grid over the XY plane, indexing entries that don't move (such as waypoints).
+ * GetClosest is exact: it visits the rings of cells around the queried position, and stops
+ * as soon as no cell left can hold an entry closer than the best one found.
+ */
+template<typename T>
+class SpatialGrid
+{
+  struct Entry
+  {
+    T*    item;
+    float x, y, z;
+  };
+
+  typedef std::vector<Entry>                      Cell;
+  typedef std::unordered_map<std::uint64_t, Cell> Cells;
+
+public:
+  SpatialGrid(float cell_size = 10.f) : cell_size(cell_size), count(0) {}
+
+  void         Clear(void)               { cells.clear(); count = 0; }
+  unsigned int Size(void)          const { return (count);          }
+  float        GetCellSize(void)   const { return (cell_size);      }
+
+  // Only applies to the entries inserted afterwards: call it on an empty grid.
+  void         SetCellSize(float size)   { cell_size = size;        }
+
+  void         Insert(T* item, float x, float y, float z)
+  {
+    int   cell_x = CellCoord(x);
+    int   cell_y = CellCoord(y);
+    Entry entry  = { item, x, y, z };
+
+    if (count == 0)
+    {
+      min_x = max_x = cell_x;
+      min_y = max_y = cell_y;
+    }
+    min_x = std::min(min_x, cell_x); max_x = std::max(max_x, cell_x);
+    min_y = std::min(min_y, cell_y); max_y = std::max(max_y, cell_y);
+    cells[Key(cell_x, cell_y)].push_back(entry);
+    count++;
+  }
+
+  T*           GetClosest(float x, float y, float z) const
+  {
+    int   cell_x    = CellCoord(x);
+    int   cell_y    = CellCoord(y);
+    int   max_ring  = std::max(std::max(std::abs(cell_x - min_x), std::abs(max_x - cell_x)),
+                               std::max(std::abs(cell_y - min_y), std::abs(max_y - cell_y)));
+    T*    best      = 0;
+    float best_dist = 0;
+
+    if (count == 0)
+      return (0);
+    for (int ring = 0 ; ring <= max_ring ; ++ring)
+    {
+      // Entries in this ring are at least (ring - 1) cells away from the queried position
+      float ring_dist = (ring - 1) * cell_size;
+
+      if (best && ring_dist > 0 && ring_dist * ring_dist > best_dist)
+        break ;
+      for (int i = -ring ; i <= ring ; ++i)
+      {
+        VisitCell(cell_x + i, cell_y - ring, x, y, z, best, best_dist);
+        if (ring > 0)
+          VisitCell(cell_x + i, cell_y + ring, x, y, z, best, best_dist);
+      }
+      for (int i = -ring + 1 ; i <= ring - 1 ; ++i)
+      {
+        VisitCell(cell_x - ring, cell_y + i, x, y, z, best, best_dist);
+        VisitCell(cell_x + ring, cell_y + i, x, y, z, best, best_dist);
+      }
+    }
+    return (best);
+  }
+
+private:
+  int                  CellCoord(float value) const { return ((int)std::floor(value / cell_size)); }
+  static std::uint64_t Key(int x, int y)            { return (((std::uint64_t)(std::uint32_t)x << 32) | (std::uint32_t)y); }
+
+  void                 VisitCell(int cell_x, int cell_y, float x, float y, float z, T*& best, float& best_dist) const
+  {
+    typename Cells::const_iterator cell = cells.find(Key(cell_x, cell_y));
+
+    if (cell == cells.end())
+      return ;
+    for (auto it = cell->second.begin() ; it != cell->second.end() ; ++it)
+    {
+      float dist_x = it->x - x;
+      float dist_y = it->y - y;
+      float dist_z = it->z - z;
+      float dist   = dist_x * dist_x + dist_y * dist_y + dist_z * dist_z;
+
+      if (!best || dist < best_dist)
+      {
+        best      = it->item;
+        best_dist = dist;
+      }
+    }
+  }
+
+  float        cell_size;
+  unsigned int count;
+  int          min_x, max_x, min_y, max_y;
+  Cells        cells;
+};
+
+#endif
@@ -44,6 +44,7 @@ void Data::MoveUp()
     }
     entries.insert(previous, _data);
     entries.erase(it);
+    _data->father->ChildrenChanged();
   }
 }
 
@@ -64,6 +65,7 @@ void Data::MoveDown()
     }
     entries.insert(++next, _data);
     entries.erase(it);
+    _data->father->ChildrenChanged();
   }
 }
 
@@ -94,7 +96,10 @@ Data::Data(const std::string& key, DataBranch* father)
   _data->pointers = 1;
   _data->nil      = true;
   if (father)
+  {
     father->children.push_back(_data);
+    father->ChildrenChanged();
+  }
 }
 
 Data::Data(const Data& copy) : _data(copy._data)
@@ -121,6 +126,7 @@ void Data::PushBack(Data d)
     DataBranch* parent = _data;
 
     _data->children.push_back(d._data);
+    _data->ChildrenChanged();
     d._data->father = _data;
     d._data->nil    = false;
     while (parent)
@@ -215,6 +221,7 @@ void        Data::Duplicate(Data var)
 
       tmp->father = _data;
       _data->children.push_back(tmp);
+      _data->ChildrenChanged();
       Data(tmp).Duplicate(child);
     }
   }
@@ -253,6 +260,7 @@ void Data::CutBranch(void)
     if ((*it)->pointers == 0)
       delete (*it);
     it = _data->children.erase(it);
+    _data->ChildrenChanged();
   }
   Remove();
 }
@@ -273,6 +281,7 @@ DataBranch::~DataBranch()
       if ((*it) == this)
       {
 	father->children.erase(it);
+	father->ChildrenChanged();
 	break ;
       }
     }
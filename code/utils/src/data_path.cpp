@@ -0,0 +1,72 @@
+#include "data_path.hpp"
+#include <algorithm>
+
+using namespace std;
+
+DataPath::DataPath(const string& path)
+{
+  string::size_type begin = 0;
+
+  while (begin <= path.size())
+  {
+    string::size_type end = path.find('/', begin);
+
+    if (end == string::npos)
+      end = path.size();
+    if (end > begin)
+      keys.push_back(path.substr(begin, end - begin));
+    begin = end + 1;
+  }
+}
+
+Data DataPath::From(Data from)
+{
+  if (from._data == 0)
+    return (Data());
+  if (from._data != base._data)
+  {
+    swap(base._data, from._data); // from now releases the previous base
+    steps.clear();
+  }
+  if (!(IsCacheValid()))
+    Resolve();
+  if (steps.size() == keys.size() + 1)
+    return (Data(steps.back().branch));
+  return (Data());
+}
+
+// Steps are checked from the base: a branch is only looked at once its father is known to still hold it
+bool DataPath::IsCacheValid(void) const
+{
+  if (steps.empty())
+    return (false);
+  for (auto it = steps.begin() ; it != steps.end() ; ++it)
+  {
+    if (it->branch->version != it->version)
+      return (false);
+  }
+  return (true);
+}
+
+// Same lookup as Data::operator[], without creating the missing branches
+void DataPath::Resolve(void)
+{
+  DataBranch* branch = base._data;
+  Step        step;
+
+  steps.clear();
+  step.branch  = branch;
+  step.version = branch->version;
+  steps.push_back(step);
+  for (auto key = keys.begin() ; key != keys.end() ; ++key)
+  {
+    auto child = find_if(branch->children.begin(), branch->children.end(), [&key](DataBranch* child) { return (child->key == *key); });
+
+    if (child == branch->children.end())
+      break ;
+    branch       = *child;
+    step.branch  = branch;
+    step.version = branch->version;
+    steps.push_back(step);
+  }
+}
@@ -0,0 +1,164 @@
+#include "job_system.hpp"
+#include <thread>
+
+using namespace Sync;
+using namespace std;
+
+namespace
+{
+  // Identifies the worker running on the current thread, so that Push and Wait use its own queue.
+  thread_local JobSystem*   current_system = 0;
+  thread_local unsigned int current_queue  = 0;
+}
+
+unsigned int JobSystem::DefaultWorkerCount(void)
+{
+  unsigned int hardware = thread::hardware_concurrency();
+
+  return (hardware > 1 ? hardware - 1 : 0);
+}
+
+JobSystem& JobSystem::Get(void)
+{
+  static JobSystem system(DefaultWorkerCount());
+
+  return (system);
+}
+
+JobSystem::JobSystem(unsigned int worker_count) : _wakeup(0, worker_count > 0 ? worker_count : 1), _running(true)
+{
+  // Queue 0 receives the jobs pushed from threads which aren't workers.
+  for (unsigned int i = 0 ; i <= worker_count ; ++i)
+    _queues.push_back(new Queue);
+  for (unsigned int i = 0 ; i < worker_count ; ++i)
+    _workers.push_back(new Worker(*this, i + 1));
+  for (unsigned int i = 0 ; i < worker_count ; ++i)
+    _workers[i]->Launch();
+}
+
+JobSystem::~JobSystem(void)
+{
+  _running.store(false);
+  for (unsigned int i = 0 ; i < _workers.size() ; ++i)
+    _wakeup.Post();
+  for (unsigned int i = 0 ; i < _workers.size() ; ++i)
+  {
+    _workers[i]->Join();
+    delete _workers[i];
+  }
+  for (unsigned int i = 0 ; i < _queues.size() ; ++i)
+    delete _queues[i];
+}
+
+unsigned int JobSystem::CurrentQueue(void) const
+{
+  return (current_system == this ? current_queue : 0);
+}
+
+void JobSystem::Push(JobGroup& group, Job job)
+{
+  Queue& queue = *_queues[CurrentQueue()];
+
+  group._pending.fetch_add(1, memory_order_relaxed);
+  {
+    Semaphore::Lock lock(queue.lock);
+
+    queue.entries.push_back(Entry(&group, job));
+  }
+  _wakeup.Post();
+}
+
+void JobSystem::Wait(JobGroup& group)
+{
+  unsigned int queue = CurrentQueue();
+
+  while (!(group.IsDone()))
+  {
+    Entry entry;
+
+    if (FindJob(queue, entry))
+      Execute(entry);
+    else
+      this_thread::yield();
+  }
+  if (group._has_exception.load(memory_order_acquire))
+  {
+    exception_ptr exception = group._exception;
+
+    group._exception = exception_ptr();
+    group._has_exception.store(false);
+    rethrow_exception(exception);
+  }
+}
+
+bool JobSystem::PopBack(unsigned int index, Entry& entry)
+{
+  Queue&          queue = *_queues[index];
+  Semaphore::Lock lock(queue.lock);
+
+  if (queue.entries.empty())
+    return (false);
+  entry = queue.entries.back();
+  queue.entries.pop_back();
+  return (true);
+}
+
+bool JobSystem::PopFront(unsigned int index, Entry& entry)
+{
+  Queue&          queue = *_queues[index];
+  Semaphore::Lock lock(queue.lock);
+
+  if (queue.entries.empty())
+    return (false);
+  entry = queue.entries.front();
+  queue.entries.pop_front();
+  return (true);
+}
+
+bool JobSystem::FindJob(unsigned int queue, Entry& entry)
+{
+  if (PopBack(queue, entry))
+    return (true);
+  for (unsigned int i = 1 ; i < _queues.size() ; ++i)
+  {
+    if (PopFront((queue + i) % _queues.size(), entry))
+      return (true);
+  }
+  return (false);
+}
+
+void JobSystem::Execute(Entry& entry)
+{
+  JobGroup& group = *entry.group;
+
+  try
+  {
+    entry.job();
+  }
+  catch (...)
+  {
+    bool expected = false;
+
+    if (group._has_exception.compare_exchange_strong(expected, true))
+      group._exception = current_exception();
+  }
+  entry.job = Job();
+  group._pending.fetch_sub(1, memory_order_release);
+}
+
+void JobSystem::Worker::Run(void)
+{
+  current_system = &system;
+  current_queue  = index;
+  for (;;)
+  {
+    Entry entry;
+
+    if (system.FindJob(index, entry))
+      system.Execute(entry);
+    else if (system._running.load())
+      system._wakeup.Wait();
+    else
+      break ;
+  }
+}
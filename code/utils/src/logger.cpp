@@ -0,0 +1,242 @@
+#include "logger.hpp"
+#include "ring_buffer.hpp"
+#include "thread.hpp"
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace Logger
+{
+  atomic<int> levels[CategoryCount] = { {Info}, {Info}, {Info}, {Info}, {Info}, {Info}, {Info}, {Info}, {Info}, {Info} };
+
+  static const char*  category_names[CategoryCount] = { "General", "Map", "Characters", "Ai", "Combat", "Pathfinding", "Interactions", "Scripts", "Console", "Saves" };
+  static const char*  severity_names[]              = { "Debug", "Info", "Warning", "Error" };
+  static mutex        sinks_mutex;
+  static vector<Sink> sinks;
+  static atomic<bool> running(false);
+  static atomic<bool> console_output(true);
+  static atomic<unsigned int> submitted(0), written(0), dropped(0);
+
+  static Sync::RingBuffer<Record>& GetQueue(void)
+  {
+    static Sync::RingBuffer<Record> queue(queue_size);
+
+    return (queue);
+  }
+
+  /*
+   * Formats and writes the queued records until Finalize is called.
+   */
+  class Writer : public Sync::MyThread
+  {
+  protected:
+    void Run(void);
+  };
+
+  static Writer writer;
+
+  static void Write(const Record& record)
+  {
+    string            text = Format(record);
+    lock_guard<mutex> lock(sinks_mutex);
+
+    if (console_output.load(memory_order_relaxed))
+      (record.severity >= Warning ? cerr : cout) << '[' << GetName(record.severity) << "][" << GetName(record.category) << "] " << text << '\n';
+    for (auto it = sinks.begin() ; it != sinks.end() ; ++it)
+      (*it)(record.category, record.severity, text);
+  }
+
+  static bool WriteNext(void)
+  {
+    if (GetQueue().TryConsume([](Record& record) { Write(record); }))
+    {
+      written.fetch_add(1, memory_order_release);
+      return (true);
+    }
+    return (false);
+  }
+
+  void Writer::Run(void)
+  {
+    while (running.load(memory_order_acquire))
+    {
+      if (!(WriteNext()))
+      {
+        cout.flush();
+        this_thread::sleep_for(chrono::milliseconds(2));
+      }
+    }
+    while (WriteNext());
+    cout.flush();
+  }
+
+  void Submit(const Record& record)
+  {
+    if (!(running.load(memory_order_acquire)))
+      Write(record);
+    else if (GetQueue().TryPush(record))
+      submitted.fetch_add(1, memory_order_release);
+    else
+      dropped.fetch_add(1, memory_order_relaxed); // Never blocks the caller: lines are lost when the logger thread falls behind
+  }
+
+  string Format(const Record& record)
+  {
+    stringstream   stream;
+    unsigned short position = 0;
+
+    while (position < record.size)
+    {
+      const char* value = &record.data[position + 1];
+
+      switch ((Record::Type)record.data[position])
+      {
+        case Record::String:
+        {
+          unsigned short length;
+
+          memcpy(&length, value, sizeof(length));
+          stream.write(value + sizeof(length), length);
+          position += 1 + sizeof(length) + length;
+          break ;
+        }
+        case Record::Integer:
+        {
+          int64_t integer;
+
+          memcpy(&integer, value, sizeof(integer));
+          stream << integer;
+          position += 1 + sizeof(integer);
+          break ;
+        }
+        case Record::Unsigned:
+        {
+          uint64_t integer;
+
+          memcpy(&integer, value, sizeof(integer));
+          stream << integer;
+          position += 1 + sizeof(integer);
+          break ;
+        }
+        case Record::Real:
+        {
+          double real;
+
+          memcpy(&real, value, sizeof(real));
+          stream << real;
+          position += 1 + sizeof(real);
+          break ;
+        }
+        case Record::Boolean:
+        {
+          bool boolean;
+
+          memcpy(&boolean, value, sizeof(boolean));
+          stream << boolean;
+          position += 1 + sizeof(boolean);
+          break ;
+        }
+      }
+    }
+    if (record.truncated)
+      stream << "[...]";
+    return (stream.str());
+  }
+
+  void SetLevel(Category category, Severity severity)
+  {
+    levels[category].store(severity, memory_order_relaxed);
+  }
+
+  void SetLevel(Severity severity)
+  {
+    for (unsigned int i = 0 ; i < CategoryCount ; ++i)
+      SetLevel((Category)i, severity);
+  }
+
+  // Names are the ones returned by GetName. An empty category sets every category.
+  bool SetLevel(const string& category, const string& severity)
+  {
+    for (unsigned int i = 0 ; i <= Error ; ++i)
+    {
+      if (severity == severity_names[i])
+      {
+        if (category == "")
+        {
+          SetLevel((Severity)i);
+          return (true);
+        }
+        for (unsigned int ii = 0 ; ii < CategoryCount ; ++ii)
+        {
+          if (category == category_names[ii])
+          {
+            SetLevel((Category)ii, (Severity)i);
+            return (true);
+          }
+        }
+      }
+    }
+    return (false);
+  }
+
+  const char* GetName(Category category)
+  {
+    return (category_names[category]);
+  }
+
+  const char* GetName(Severity severity)
+  {
+    return (severity_names[severity]);
+  }
+
+  void AddSink(Sink sink)
+  {
+    lock_guard<mutex> lock(sinks_mutex);
+
+    sinks.push_back(sink);
+  }
+
+  void ClearSinks(void)
+  {
+    lock_guard<mutex> lock(sinks_mutex);
+
+    sinks.clear();
+  }
+
+  // Sinks are still called when the standard outputs are disabled
+  void SetConsoleOutput(bool set)
+  {
+    console_output.store(set, memory_order_relaxed);
+  }
+
+  void Initialize(void)
+  {
+    if (!(running.exchange(true)))
+      writer.Launch();
+  }
+
+  // Waits until the lines logged so far are written
+  void Flush(void)
+  {
+    unsigned int target = submitted.load(memory_order_acquire);
+
+    while (running.load(memory_order_acquire) && (int)(written.load(memory_order_acquire) - target) < 0)
+      this_thread::yield();
+    cout.flush();
+  }
+
+  void Finalize(void)
+  {
+    if (running.exchange(false))
+      writer.Join();
+  }
+
+  unsigned int GetDroppedCount(void)
+  {
+    return (dropped.load(memory_order_relaxed));
+  }
+}
@@ -1,5 +1,6 @@
 #include "globals.hpp"
 #include "my_zlib.hpp"
+#include <sstream>
 
 using namespace std;
 
@@ -67,62 +68,533 @@ void          Utils::zlib::Decompress(const char* _buffer, unsigned long length)
   buffer[buffer_length] = 0;
 }
 
+/*
+ * Archive
+ */
+namespace
+{
+  const char         archive_magic[4]  = { 'F', 'E', 'A', 'R' };
+  const std::uint32_t archive_version   = 1;
+  const std::uint64_t archive_header    = sizeof(archive_magic) + sizeof(std::uint32_t);
+  const std::uint64_t archive_footer    = sizeof(std::uint64_t) + sizeof(std::uint32_t) + sizeof(archive_magic);
+
+  // Integers are stored little-endian, whatever the platform.
+  template<typename T>
+  void WriteInteger(std::ostream& stream, T value)
+  {
+    char bytes[sizeof(T)];
+
+    for (unsigned int i = 0 ; i < sizeof(T) ; ++i)
+      bytes[i] = (value >> (i * 8)) & 0xff;
+    stream.write(bytes, sizeof(T));
+  }
+
+  template<typename T>
+  T    ReadInteger(std::istream& stream)
+  {
+    unsigned char bytes[sizeof(T)];
+    T             value = 0;
+
+    stream.read(reinterpret_cast<char*>(bytes), sizeof(T));
+    for (unsigned int i = 0 ; i < sizeof(T) ; ++i)
+      value |= static_cast<T>(bytes[i]) << (i * 8);
+    return (value);
+  }
+
+  bool ReadMagic(std::istream& stream)
+  {
+    char magic[sizeof(archive_magic)];
+
+    stream.read(magic, sizeof(magic));
+    return (stream.good() && std::equal(magic, magic + sizeof(magic), archive_magic));
+  }
+}
+
+bool Utils::Archive::IsArchive(const std::string& path)
+{
+  std::ifstream input(path.c_str(), std::ios::binary);
+
+  return (input.is_open() && ReadMagic(input));
+}
+
+bool Utils::Archive::Open(const std::string& path)
+{
+  Close();
+  this->path = path;
+  file.open(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+  if (!(file.is_open()))
+    return (false);
+  if (!(ReadMagic(file)) || ReadInteger<std::uint32_t>(file) != archive_version)
+  {
+    Close();
+    return (false);
+  }
+  ReadTableOfContents();
+  return (true);
+}
+
+/*
+ * The footer of the last complete Commit. It is at the end of the file, unless a later update was interrupted:
+ * the file then ends with the data of that update, and the footer is searched backward.
+ */
+bool Utils::Archive::FindFooter(std::uint64_t file_size, std::uint64_t& toc_offset, std::uint32_t& toc_size)
+{
+  std::vector<char> buffer(buffer_size + archive_footer);
+  std::uint64_t     end = file_size;
+
+  while (end >= archive_header + archive_footer)
+  {
+    std::uint64_t begin = std::max<std::uint64_t>(end > buffer_size + archive_footer ? end - buffer_size - archive_footer : 0, archive_header);
+    std::size_t   size  = end - begin;
+
+    file.clear();
+    file.seekg(begin);
+    file.read(&buffer[0], size);
+    if (!file.good())
+      return (false);
+    for (std::size_t footer = size - archive_footer + 1 ; footer-- > 0 ;)
+    {
+      if (std::equal(archive_magic, archive_magic + sizeof(archive_magic), &buffer[footer + archive_footer - sizeof(archive_magic)]))
+      {
+        std::stringstream stream(std::string(&buffer[footer], archive_footer));
+
+        toc_offset = ReadInteger<std::uint64_t>(stream);
+        toc_size   = ReadInteger<std::uint32_t>(stream);
+        if (toc_offset >= archive_header && toc_offset + toc_size == begin + footer)
+          return (true);
+      }
+    }
+    if (begin == archive_header)
+      break ;
+    end = begin + archive_footer - 1; // Footers overlapping both chunks are found in the next one
+  }
+  return (false);
+}
+
+void Utils::Archive::ReadTableOfContents(void)
+{
+  std::uint64_t file_size, toc_offset, live_space = 0;
+  std::uint32_t toc_size, count;
+
+  file.seekg(0, std::ios::end);
+  file_size = file.tellg();
+  if (!(FindFooter(file_size, toc_offset, toc_size)))
+    throw Exception("corrupted table of contents in '" + path + '\'');
+  file.clear();
+  file.seekg(toc_offset);
+  count = ReadInteger<std::uint32_t>(file);
+  entries.clear();
+  entries.reserve(count);
+  for (unsigned int i = 0 ; i < count ; ++i)
+  {
+    Entry         entry;
+    std::uint32_t name_size = ReadInteger<std::uint32_t>(file);
+
+    if (!file.good() || name_size > toc_size)
+      throw Exception("corrupted table of contents in '" + path + '\'');
+    entry.name.resize(name_size);
+    file.read(&entry.name[0], name_size);
+    entry.offset          = ReadInteger<std::uint64_t>(file);
+    entry.compressed_size = ReadInteger<std::uint64_t>(file);
+    entry.size            = ReadInteger<std::uint64_t>(file);
+    entry.crc             = ReadInteger<std::uint32_t>(file);
+    live_space           += entry.compressed_size;
+    entries.push_back(entry);
+  }
+  if (!file.good())
+    throw Exception("corrupted table of contents in '" + path + '\'');
+  // New data goes after the current table of contents, which stays valid until the next Commit is complete
+  data_end   = file_size;
+  toc_space  = toc_size + archive_footer;
+  dead_space = file_size - archive_header - live_space - toc_space;
+}
+
+void Utils::Archive::Create(const std::string& path)
+{
+  Close();
+  this->path = path;
+  {
+    std::ofstream create(path.c_str(), std::ios::binary | std::ios::trunc);
+
+    if (!(create.is_open()))
+      throw Exception("cannot create '" + path + '\'');
+    create.write(archive_magic, sizeof(archive_magic));
+    WriteInteger<std::uint32_t>(create, archive_version);
+  }
+  file.open(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+  if (!(file.is_open()))
+    throw Exception("cannot open '" + path + '\'');
+  data_end = archive_header;
+}
+
+void Utils::Archive::Commit(void)
+{
+  std::uint64_t toc_size = sizeof(std::uint32_t);
+
+  file.clear();
+  file.seekp(data_end);
+  WriteInteger<std::uint32_t>(file, entries.size());
+  for (auto it = entries.begin() ; it != entries.end() ; ++it)
+  {
+    WriteInteger<std::uint32_t>(file, it->name.size());
+    file.write(it->name.data(), it->name.size());
+    WriteInteger<std::uint64_t>(file, it->offset);
+    WriteInteger<std::uint64_t>(file, it->compressed_size);
+    WriteInteger<std::uint64_t>(file, it->size);
+    WriteInteger<std::uint32_t>(file, it->crc);
+    toc_size += sizeof(std::uint32_t) * 2 + sizeof(std::uint64_t) * 3 + it->name.size();
+  }
+  WriteInteger<std::uint64_t>(file, data_end);
+  WriteInteger<std::uint32_t>(file, toc_size);
+  file.write(archive_magic, sizeof(archive_magic));
+  file.flush();
+  if (!file.good())
+    throw Exception("failed to write to '" + path + '\'');
+  // Like after Open, the next entries and Commit go after this table of contents, which becomes dead space then
+  dead_space += toc_space;
+  toc_space   = toc_size + archive_footer;
+  data_end   += toc_space;
+}
+
+void Utils::Archive::Close(void)
+{
+  if (file.is_open())
+    file.close();
+  file.clear();
+  entries.clear();
+  data_end   = 0;
+  dead_space = 0;
+  toc_space  = 0;
+}
+
+const Utils::Archive::Entry* Utils::Archive::Find(const std::string& name) const
+{
+  auto it = std::find_if(entries.begin(), entries.end(), [&name](const Entry& entry) { return (entry.name == name); });
+
+  return (it != entries.end() ? &(*it) : 0);
+}
+
+void Utils::Archive::SetEntry(const Entry& entry)
+{
+  auto it = std::find_if(entries.begin(), entries.end(), [&entry](const Entry& current) { return (current.name == entry.name); });
+
+  if (it != entries.end())
+  {
+    dead_space += it->compressed_size;
+    *it = entry;
+  }
+  else
+    entries.push_back(entry);
+}
+
+void Utils::Archive::AddFile(const std::string& name, const std::string& source_path)
+{
+  std::ifstream input(source_path.c_str(), std::ios::binary);
+
+  if (!(input.is_open()))
+    throw Exception("cannot read '" + source_path + '\'');
+  Add(name, input);
+}
+
+void Utils::Archive::Add(const std::string& name, std::istream& input)
+{
+  std::vector<Bytef> in(buffer_size), out(buffer_size);
+  z_stream           stream;
+  Entry              entry;
+  int                flush;
+
+  entry.name            = name;
+  entry.offset          = data_end;
+  entry.compressed_size = 0;
+  entry.size            = 0;
+  entry.crc             = crc32(0, Z_NULL, 0);
+  stream.zalloc         = Z_NULL;
+  stream.zfree          = Z_NULL;
+  stream.opaque         = Z_NULL;
+  if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK)
+    throw zlib::MemoryError();
+  file.clear();
+  file.seekp(data_end);
+  do
+  {
+    input.read(reinterpret_cast<char*>(&in[0]), buffer_size);
+    if (input.fail() && !(input.eof())) // a short read sets failbit along with eofbit: anything else is an error
+    {
+      deflateEnd(&stream);
+      throw Exception("failed to read the source of '" + name + '\'');
+    }
+    stream.avail_in = input.gcount();
+    stream.next_in  = &in[0];
+    flush           = input.eof() ? Z_FINISH : Z_NO_FLUSH;
+    entry.size     += stream.avail_in;
+    entry.crc       = crc32(entry.crc, &in[0], stream.avail_in);
+    do
+    {
+      std::size_t produced;
+
+      stream.avail_out = buffer_size;
+      stream.next_out  = &out[0];
+      deflate(&stream, flush);
+      produced = buffer_size - stream.avail_out;
+      file.write(reinterpret_cast<const char*>(&out[0]), produced);
+      entry.compressed_size += produced;
+    } while (stream.avail_out == 0);
+  } while (flush != Z_FINISH);
+  deflateEnd(&stream);
+  if (!file.good())
+    throw Exception("failed to write to '" + path + '\'');
+  data_end += entry.compressed_size;
+  SetEntry(entry);
+}
+
+bool Utils::Archive::Matches(const Entry& entry, const std::string& source_path)
+{
+  std::ifstream      input;
+  std::vector<Bytef> buffer(buffer_size);
+  std::uint32_t      crc = crc32(0, Z_NULL, 0);
+
+  if (entry.size != Filesystem::FileSize(source_path))
+    return (false);
+  input.open(source_path.c_str(), std::ios::binary);
+  while (input.good())
+  {
+    input.read(reinterpret_cast<char*>(&buffer[0]), buffer_size);
+    crc = crc32(crc, &buffer[0], input.gcount());
+  }
+  return (crc == entry.crc);
+}
+
+bool Utils::Archive::UpdateFile(const std::string& name, const std::string& source_path)
+{
+  const Entry* entry = Find(name);
+
+  if (entry && Matches(*entry, source_path))
+    return (false);
+  AddFile(name, source_path);
+  return (true);
+}
+
+void Utils::Archive::CopyEntry(Archive& source, const Entry& entry)
+{
+  std::vector<char> buffer(buffer_size);
+  std::uint64_t     remaining = entry.compressed_size;
+  Entry             copy      = entry;
+
+  source.file.clear();
+  source.file.seekg(entry.offset);
+  file.clear();
+  file.seekp(data_end);
+  while (remaining > 0)
+  {
+    std::size_t chunk = std::min<std::uint64_t>(remaining, buffer_size);
+
+    source.file.read(&buffer[0], chunk);
+    file.write(&buffer[0], chunk);
+    remaining -= chunk;
+  }
+  if (!source.file.good() || !file.good())
+    throw Exception("failed to copy '" + entry.name + "' from '" + source.path + "' to '" + path + '\'');
+  copy.offset = data_end;
+  data_end   += copy.compressed_size;
+  SetEntry(copy);
+}
+
+void Utils::Archive::Extract(const Entry& entry, std::ostream& output)
+{
+  std::vector<Bytef> in(buffer_size), out(buffer_size);
+  std::uint64_t      remaining = entry.compressed_size;
+  std::uint64_t      size      = 0;
+  std::uint32_t      crc       = crc32(0, Z_NULL, 0);
+  z_stream           stream;
+  int                result    = Z_OK;
+
+  stream.zalloc   = Z_NULL;
+  stream.zfree    = Z_NULL;
+  stream.opaque   = Z_NULL;
+  stream.avail_in = 0;
+  stream.next_in  = Z_NULL;
+  if (inflateInit(&stream) != Z_OK)
+    throw zlib::MemoryError();
+  file.clear();
+  file.seekg(entry.offset);
+  while (result != Z_STREAM_END && remaining > 0)
+  {
+    std::size_t chunk = std::min<std::uint64_t>(remaining, buffer_size);
+
+    file.read(reinterpret_cast<char*>(&in[0]), chunk);
+    remaining      -= chunk;
+    stream.avail_in = chunk;
+    stream.next_in  = &in[0];
+    do
+    {
+      std::size_t produced;
+
+      stream.avail_out = buffer_size;
+      stream.next_out  = &out[0];
+      result           = inflate(&stream, Z_NO_FLUSH);
+      if (result == Z_NEED_DICT || result == Z_DATA_ERROR || result == Z_MEM_ERROR)
+      {
+        inflateEnd(&stream);
+        throw zlib::DataError();
+      }
+      produced = buffer_size - stream.avail_out;
+      crc      = crc32(crc, &out[0], produced);
+      size    += produced;
+      output.write(reinterpret_cast<const char*>(&out[0]), produced);
+    } while (stream.avail_out == 0);
+  }
+  inflateEnd(&stream);
+  if (result != Z_STREAM_END || size != entry.size || crc != entry.crc)
+    throw Exception("entry '" + entry.name + "' of '" + path + "' is corrupted");
+}
+
+bool Utils::Archive::ExtractFile(const std::string& name, const std::string& target_path)
+{
+  const Entry*  entry = Find(name);
+  std::ofstream output;
+
+  if (!entry)
+    return (false);
+  output.open(target_path.c_str(), std::ios::binary);
+  if (!(output.is_open()))
+    throw Exception("cannot write '" + target_path + '\'');
+  Extract(*entry, output);
+  return (true);
+}
+
+void Utils::Archive::Compact(const std::string& path)
+{
+  Archive source, target;
+
+  if (!(source.Open(path)) || source.DeadSpace() == 0)
+    return ;
+  target.Create(path + ".tmp");
+  for (auto it = source.entries.begin() ; it != source.entries.end() ; ++it)
+    target.CopyEntry(source, *it);
+  target.Commit();
+  target.Close();
+  source.Close();
+#ifdef _WIN32
+  remove(path.c_str());
+#endif
+  if (rename((path + ".tmp").c_str(), path.c_str()) != 0)
+    throw Exception("cannot replace '" + path + '\'');
+}
+
 /*
  * Directory Compressor
  */
-void Utils::DirectoryCompressor::Compress(const std::string& target, const std::string& path, std::function<bool (const std::string&)> selector)
+void Utils::DirectoryCompressor::Compress(const std::string& target, const std::string& path, Selector selector)
 {
-  std::ofstream file_output;
-  Directory     directory;
-  Utils::Packet output;
-  unsigned int  file_count = 0;
+  Archive   archive;
+  Directory directory;
 
-  file_output.open(target, std::ios::binary);
+  archive.Create(target);
   directory.OpenDir(path);
-  // Header
-  std::for_each(directory.GetEntries().begin(), directory.GetEntries().end(), [&file_count, selector](Dirent entry)
+  std::for_each(directory.GetEntries().begin(), directory.GetEntries().end(), [&archive, path, selector](Dirent entry)
   {
     if (entry.d_type == DT_REG && selector(entry.d_name))
-      file_count++;
+      archive.AddFile(entry.d_name, path + '/' + entry.d_name);
   });
-  output << file_count;
-  // Files
-  std::for_each(directory.GetEntries().begin(), directory.GetEntries().end(), [&output, path, selector](Dirent entry)
+  archive.Commit();
+}
+
+/*
+ * Saving over the previous archive appends the files which changed to it (see Archive). Otherwise, a new
+ * archive is built next to target, then renamed over it: files which didn't change since the previous archive
+ * are copied without being recompressed. Either way, an interrupted save never damages the previous one, and
+ * entries of the previous archive which aren't in the directory anymore are kept.
+ */
+void Utils::DirectoryCompressor::Update(const std::string& target, const std::string& path, const std::string& previous_path, Selector selector)
+{
+  const std::string temporary = target + ".tmp";
+  Archive           archive, previous;
+  Directory         directory;
+  bool              has_previous;
+
+  if (previous_path == target && archive.Open(target))
+  {
+    UpdateInPlace(archive, target, path, selector);
+    return ;
+  }
+  has_previous = previous_path != "" && previous.Open(previous_path);
+  archive.Create(temporary);
+  directory.OpenDir(path);
+  std::for_each(directory.GetEntries().begin(), directory.GetEntries().end(), [&](Dirent entry)
   {
     if (entry.d_type == DT_REG && selector(entry.d_name))
     {
-      std::ifstream  input;
-      std::streampos begin, end, size;
-      char*          raw;
-
-      input.open(path + '/' + entry.d_name, std::ios::binary);
-      begin       = input.tellg();
-      input.seekg(0, std::ios::end);
-      end         = input.tellg();
-      input.seekg(0, std::ios::beg);
-      size        = end - begin;
-      raw         = new char[(int)size + 1];
-      input.read(raw, size);
-      input.close();
-      raw[size]   = 0;
-      {
-        const std::string data(raw, size);
-        const std::string d_name = entry.d_name;
+      const std::string     file_path = path + '/' + entry.d_name;
+      const Archive::Entry* old_entry = has_previous ? previous.Find(entry.d_name) : 0;
 
-        output << d_name << data;
-      }
+      if (old_entry && Archive::Matches(*old_entry, file_path))
+        archive.CopyEntry(previous, *old_entry);
+      else
+        archive.AddFile(entry.d_name, file_path);
     }
   });
-  // Compressing with zlib
+  if (has_previous)
+  {
+    std::for_each(previous.GetEntries().begin(), previous.GetEntries().end(), [&](const Archive::Entry& entry)
+    {
+      if (!(archive.Find(entry.name)))
+        archive.CopyEntry(previous, entry);
+    });
+  }
+  archive.Commit();
+  archive.Close();
+  previous.Close();
+#ifdef _WIN32
+  remove(target.c_str());
+#endif
+  if (rename(temporary.c_str(), target.c_str()) != 0)
+    throw Archive::Exception("cannot replace '" + target + '\'');
+}
+
+// Compacts the archive once the replaced data takes more room than the live data
+void Utils::DirectoryCompressor::UpdateInPlace(Archive& archive, const std::string& target, const std::string& path, Selector selector)
+{
+  Directory     directory;
+  bool          changed    = false;
+  std::uint64_t live_space = 0;
+
+  directory.OpenDir(path);
+  std::for_each(directory.GetEntries().begin(), directory.GetEntries().end(), [&](Dirent entry)
+  {
+    if (entry.d_type == DT_REG && selector(entry.d_name))
+      changed = archive.UpdateFile(entry.d_name, path + '/' + entry.d_name) || changed;
+  });
+  if (changed)
+    archive.Commit();
+  std::for_each(archive.GetEntries().begin(), archive.GetEntries().end(), [&live_space](const Archive::Entry& entry)
   {
-    Utils::zlib compressor('c', output.raw(), output.size());
+    live_space += entry.compressed_size;
+  });
+  if (archive.DeadSpace() > live_space)
+  {
+    archive.Close();
+    Archive::Compact(target);
+  }
+}
 
-    file_output.write(compressor.GetData(), compressor.GetSize());
-    file_output.close();
+void Utils::DirectoryCompressor::Uncompress(const std::string& path, const std::string& target, Selector selector)
+{
+  Archive archive;
+
+  if (!(archive.Open(path)))
+  {
+    // Saves made before chunked archives were introduced
+    UncompressLegacy(path, target);
+    return ;
   }
+  std::for_each(archive.GetEntries().begin(), archive.GetEntries().end(), [&archive, target, selector](const Archive::Entry& entry)
+  {
+    if (selector(entry.name))
+      archive.ExtractFile(entry.name, target + '/' + entry.name);
+  });
 }
 
-void Utils::DirectoryCompressor::Uncompress(const std::string& path, const std::string& target)
+void Utils::DirectoryCompressor::UncompressLegacy(const std::string& path, const std::string& target)
 {
   std::ifstream input;
   
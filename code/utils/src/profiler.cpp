@@ -0,0 +1,134 @@
+#include "profiler.hpp"
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+using namespace std;
+
+namespace Profiler
+{
+  static atomic<bool>                           enabled(false);
+  static const chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+  static mutex                                  registry_mutex;
+  static vector<unique_ptr<ThreadBuffer> >      buffers;
+  static set<string>                            interned_names;
+
+  // Never 0: Zone uses it to know whether it is recording
+  uint64_t Now(void)
+  {
+    return (chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - epoch).count() + 1);
+  }
+
+  /*
+   * Buffers are registered the first time a thread records a zone, and kept until the program ends:
+   * the zones of threads that are done can still be exported.
+   */
+  ThreadBuffer& GetThreadBuffer(void)
+  {
+    thread_local ThreadBuffer* buffer = 0;
+
+    if (buffer == 0)
+    {
+      lock_guard<mutex> lock(registry_mutex);
+
+      buffers.push_back(unique_ptr<ThreadBuffer>(new ThreadBuffer(buffers.size())));
+      buffer = buffers.back().get();
+    }
+    return (*buffer);
+  }
+
+  const char* Intern(const string& name)
+  {
+    lock_guard<mutex> lock(registry_mutex);
+
+    return (interned_names.insert(name).first->c_str());
+  }
+
+  void SetEnabled(bool set)
+  {
+    enabled.store(set, memory_order_relaxed);
+  }
+
+  bool IsEnabled(void)
+  {
+    return (enabled.load(memory_order_relaxed));
+  }
+
+  vector<Event> ThreadBuffer::Copy(void) const
+  {
+    unsigned int  end   = count.load(std::memory_order_acquire);
+    unsigned int  begin = first.load(std::memory_order_relaxed);
+    vector<Event> copy;
+
+    if (end - begin > buffer_size)
+      begin = end - buffer_size;
+    for (unsigned int i = begin ; i != end ; ++i)
+      copy.push_back(events[i % buffer_size]);
+    {
+      // Cells written in the meantime (or being written, when the buffer is full) may have been copied halfway: they are dropped
+      unsigned int overwritten = count.load(std::memory_order_acquire) - end + (end - begin == buffer_size ? 1 : 0);
+
+      copy.erase(copy.begin(), copy.begin() + (overwritten < copy.size() ? overwritten : copy.size()));
+    }
+    return (copy);
+  }
+
+  /*
+   * Only forgets the zones recorded so far: threads still record in the same buffers.
+   */
+  void Clear(void)
+  {
+    lock_guard<mutex> lock(registry_mutex);
+
+    for (auto it = buffers.begin() ; it != buffers.end() ; ++it)
+      (*it)->Clear();
+  }
+
+  static void WriteEscaped(ostream& stream, const char* str)
+  {
+    for (; *str ; ++str)
+    {
+      if (*str == '"' || *str == '\\')
+        stream << '\\';
+      stream << *str;
+    }
+  }
+
+  string ChromeTrace(void)
+  {
+    stringstream      stream;
+    bool              first = true;
+    lock_guard<mutex> lock(registry_mutex);
+
+    stream << "{\"traceEvents\":[";
+    for (auto buffer = buffers.begin() ; buffer != buffers.end() ; ++buffer)
+    {
+      vector<Event> events    = (*buffer)->Copy();
+      unsigned int  thread_id = (*buffer)->GetThreadId();
+
+      for (auto event = events.begin() ; event != events.end() ; ++event)
+      {
+        stream << (first ? "" : ",") << "\n{\"name\":\"";
+        WriteEscaped(stream, event->name);
+        stream << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread_id;
+        stream << ",\"ts\":" << event->start << ",\"dur\":" << (event->end - event->start) << '}';
+        first = false;
+      }
+    }
+    stream << "\n]}\n";
+    return (stream.str());
+  }
+
+  bool ExportChromeTrace(const string& path)
+  {
+    ofstream file(path.c_str());
+
+    if (!(file.is_open()))
+      return (false);
+    file << ChromeTrace();
+    return (file.good());
+  }
+}
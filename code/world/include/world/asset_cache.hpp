@@ -0,0 +1,66 @@
+#ifndef  WORLD_ASSET_CACHE_HPP
+# define WORLD_ASSET_CACHE_HPP
+
+# include "globals.hpp"
+# include <panda3d/pandaFramework.h>
+# include <panda3d/texture.h>
+# include <string>
+# include <map>
+
+/*
+ * Models and textures loaded by MapObjects, kept across levels.
+ * An asset is in use as long as something else than the cache references it: the cache relies on
+ * Panda's reference counts instead of keeping its own. Unused assets are only evicted by Trim,
+ * least recently used first, once the cache uses more memory than its budget.
+ * Main thread only.
+ */
+class AssetCache
+{
+  struct Entry
+  {
+    Entry(void) : memory(0), last_used(0) {}
+
+    NodePath      model;
+    PT(Texture)   texture;
+    size_t        memory;
+    unsigned int  last_used;
+  };
+
+  typedef std::map<std::string, Entry> Entries;
+public:
+  struct Stats
+  {
+    Stats(void) : loads(0), hits(0), evictions(0) {}
+
+    unsigned int loads, hits, evictions;
+  };
+
+  static AssetCache& Get(void);
+
+  NodePath           InstanceModel(const std::string& path, NodePath parent);
+  NodePath           CopyModel(const std::string& path);
+  PT(Texture)        LoadTexture(const std::string& path);
+  bool               PreloadModel(const std::string& path) { return (RequireModel(path) != 0); }
+
+  void               SetBudget(size_t bytes) { budget = bytes; }
+  size_t             GetBudget(void)   const { return (budget); }
+  size_t             GetMemory(void)   const { return (memory); }
+  const Stats&       GetStats(void)    const { return (stats);  }
+  void               Trim(void);
+  void               Clear(void);
+
+private:
+  AssetCache(void);
+
+  Entry*             RequireModel(const std::string& path);
+  static size_t      EstimateMemory(NodePath model);
+  bool               IsInUse(const Entry&) const;
+  void               Evict(Entries::iterator);
+
+  Entries            models, textures;
+  size_t             budget, memory;
+  unsigned int       tick;
+  Stats              stats;
+};
+
+#endif
@@ -51,6 +51,7 @@ struct MapObject : public Utils::Serializable
   void          InitializeTree(World* world);
   void          InitializeCollideMask();
   virtual int   GetObjectCollideMask() const { return (ColMask::Object); }
+  virtual bool  CanShareModel(void)  const { return (true); }
   void          SetLight(WorldLight* light, bool is_active);
   
   bool          IsCuttable(void) const;
@@ -14,9 +14,10 @@
 # include <panda3d/collisionTraverser.h>
 
 # include <algorithm>
+# include <unordered_map>
 # include "serializer.hpp"
 
-# include "divide_and_conquer.hpp"
+# include "spatial_grid.hpp"
 
 # include "is_game_editor.h"
 
@@ -30,6 +31,12 @@
 #  define TEXT_ROOT  "textures/"
 # endif
 
+// Revision 17: sectioned blobs (see WorldSections)
+// Revision 18: saved characters list their enemy factions instead of a 32 bits mask (see ObjectCharacter::Serialize)
+# define CURRENT_BLOB_REVISION 18
+
+extern unsigned int blob_revision; // Revision of the blob being unserialized, defined in world.cpp
+
 // Following c functions are implemented in level/world/misc.cpp
 LPoint3  NodePathSize(NodePath np);
 void     SetCollideMaskOnSingleNodepath(NodePath np, unsigned short collide_mask);
@@ -45,6 +52,7 @@ LPoint3f operator*(LPoint3f,LPoint3f);
 #include "world/light.hpp"
 #include "world/particle_object.hpp"
 #include "world/zone.hpp"
+#include "world/world_sections.hpp"
 
 struct World
 {
@@ -61,6 +69,18 @@ struct World
     typedef std::list<Zone>           Zones;
     typedef std::vector<NodePath>     Floors;
 
+    // Reverse lookup from the PandaNode owning an object to the object itself.
+    typedef std::unordered_map<PandaNode*, Waypoint*>      WaypointNodeIndex;
+    typedef std::unordered_map<PandaNode*, MapObject*>     MapObjectNodeIndex;
+    typedef std::unordered_map<PandaNode*, DynamicObject*> DynamicObjectNodeIndex;
+
+    // Lookup by name. When several objects share a name, the index resolves to the one
+    // the former linear scans would have found first.
+    typedef std::unordered_map<std::string, MapObject*>     MapObjectNameIndex;
+    typedef std::unordered_map<std::string, DynamicObject*> DynamicObjectNameIndex;
+    typedef std::unordered_map<std::string, WorldLight*>    LightNameIndex;
+    typedef std::unordered_map<std::string, Zone*>          ZoneNameIndex;
+
     WindowFramework* window;
 
     NodePath         floors_node;
@@ -122,42 +142,68 @@ struct World
     }
 
     template<class OBJTYPE>
-    OBJTYPE*       GetObjectFromName(const std::string& name, std::list<OBJTYPE>& list)
+    OBJTYPE*       GetObjectFromName(const std::string& name, const std::unordered_map<std::string, OBJTYPE*>& index) const
     {
-        typename std::list<OBJTYPE>::iterator it  = list.begin();
-        typename std::list<OBJTYPE>::iterator end = list.end();
+      typename std::unordered_map<std::string, OBJTYPE*>::const_iterator it = index.find(name);
 
-        for (; it != end ; ++it)
-        {
-          if ((*it).nodePath.get_name() == name)
-            return (&(*it));
-        }
-        return (0);
+      return (it != index.end() ? it->second : 0);
     }
 
-    template<class OBJTYPE>
-    OBJTYPE*       GetObjectFromNodePath(NodePath path, std::list<OBJTYPE>& list, const std::string& parent = "")
+    /*
+     * When object was the one indexed under name, the entry moves to the first other object of
+     * the list bearing the same name: the one a rebuild of the index would have picked.
+     */
+    template<class OBJTYPE, class LIST>
+    void           UnregisterName(const std::string& name, OBJTYPE* object, std::unordered_map<std::string, OBJTYPE*>& index, LIST& list)
     {
-      typename std::list<OBJTYPE>::iterator it  = list.begin();
-      typename std::list<OBJTYPE>::iterator end = list.end();
+      typename std::unordered_map<std::string, OBJTYPE*>::iterator it = index.find(name);
 
-      if (path.is_empty())
-        return (0);
-      for (; it != end ; ++it)
+      if (it != index.end() && it->second == object)
       {
-        if (parent == "" || parent == it->parent)
+        index.erase(it);
+        for (typename LIST::iterator candidate = list.begin() ; candidate != list.end() ; ++candidate)
         {
-          if ((!(*it).nodePath.is_empty() && (*it).nodePath.is_ancestor_of(path)))
+          if (&(*candidate) != object && HasName(*candidate, name))
           {
-            OBJTYPE* children = GetObjectFromNodePath(path, list, it->nodePath.get_name());
-
-            return (children ? children : &(*it));
+            index.insert(typename std::unordered_map<std::string, OBJTYPE*>::value_type(name, &(*candidate)));
+            break ;
           }
         }
       }
+    }
+
+    static bool    HasName(const MapObject& object, const std::string& name) { return (!(object.nodePath.is_empty()) && object.nodePath.get_name() == name); }
+    static bool    HasName(const WorldLight& light, const std::string& name) { return (light.name == name); }
+    static bool    HasName(const Zone& zone, const std::string& name)        { return (zone.name == name); }
+
+    /*
+     * Walks up from path to the closest ancestor registered in the index: since the
+     * walk starts from the bottom, nested objects are found before their parents.
+     */
+    template<class OBJTYPE>
+    OBJTYPE*       GetObjectFromNodePath(NodePath path, const std::unordered_map<PandaNode*, OBJTYPE*>& index) const
+    {
+      for (; !(path.is_empty()) ; path = path.get_parent())
+      {
+        typename std::unordered_map<PandaNode*, OBJTYPE*>::const_iterator it = index.find(path.node());
+
+        if (it != index.end())
+          return (it->second);
+      }
       return (0);
     }
 
+    void           RegisterWaypoint(Waypoint&);
+    void           RegisterMapObject(MapObject&);
+    void           RegisterDynamicObject(DynamicObject&);
+    void           UnregisterWaypoint(Waypoint&);
+    void           UnregisterMapObject(MapObject&);
+    void           UnregisterDynamicObject(DynamicObject&);
+    void           RegisterLight(WorldLight&);
+    void           UnregisterLight(WorldLight&);
+    void           RebuildWaypointNodeIndex(void);
+    void           RebuildNameIndexes(void);
+
     void           ObjectChangeFloor(MapObject&, unsigned char floor, unsigned short type);
 
     MapObject*     GetObjectFromName(const std::string& name);
@@ -180,6 +226,9 @@ struct World
     void           DynamicObjectSetWaypoint(DynamicObject&, Waypoint&);
     void           DynamicObjectChangeFloor(DynamicObject&, unsigned char floor);
 
+    void           RenameObject(MapObject* object, const std::string& name);
+    void           RenameLight(WorldLight* light, const std::string& name);
+
     void           ReparentObject(MapObject* object, MapObject*     new_parent);
     void           ReparentObject(MapObject* object, const std::string& name);
 
@@ -201,6 +250,10 @@ struct World
 
     void           UnSerialize(Utils::Packet& packet);
     void           Serialize(Utils::Packet& packet, std::function<void (const std::string&, float)> progress_callback = [](const std::string&, float){});
+    // Serialize is SerializeHead, then the dynamicObjects list, then SerializeTail.
+    // Levels use the halves to record each DynamicObject separately (see DeltaSave).
+    void           SerializeHead(Utils::Packet& packet, ProgressCallback progress_callback = [](const std::string&, float){});
+    void           SerializeTail(Utils::Packet& packet, ProgressCallback progress_callback = [](const std::string&, float){});
 
     void           UpdateMapTree(void);
     void           CompileWaypointsFloorAbove(void);
@@ -210,7 +263,24 @@ struct World
     NodePath       debug_pathfinding;
     NodePath       model_sphere;
 
-    DivideAndConquer::Graph<Waypoint, LPoint3f> waypoint_graph;
+    void           IndexWaypoints(void);
+
+    SpatialGrid<Waypoint> waypoint_grid;
+
+private:
+    void           UnSerializeTagged(Utils::Packet& packet);   // revision 16 and older
+    void           UnSerializeSections(Utils::Packet& packet);
+    void           UnSerializeWaypoints(const WorldSections::WaypointTable&);
+    void           PreloadAssets(Utils::Packet& packet);
+    std::string    SerializeSections(ProgressCallback progress_callback);
+
+    WaypointNodeIndex      waypoint_node_index;
+    MapObjectNodeIndex     map_object_node_index;
+    DynamicObjectNodeIndex dynamic_object_node_index;
+    MapObjectNameIndex     map_object_name_index;
+    DynamicObjectNameIndex dynamic_object_name_index;
+    LightNameIndex         light_name_index;
+    ZoneNameIndex          zone_name_index;
 };
 
 #endif // WORLD_H
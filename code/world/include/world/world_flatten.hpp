@@ -3,95 +3,54 @@
 
 # include "globals.hpp"
 # include "world/world.h"
-# include "world/flatten_map.hpp"
+# include <map>
 # include <list>
 
+/*
+ * Offline flattening of the static MapObjects (see --compile-flatten).
+ * Objects are grouped by floor, texture and the lights enlightening them; each group is merged into a few
+ * GeomNodes and written to a BAM side file next to the map blob.
+ * At runtime, baked objects keep their nodes (picking, floors, waypoints and colliders still use them):
+ * only their render node is stashed, and the merged geometry is drawn instead.
+ * Objects whose render node is needed at runtime are never baked: cuttable walls, objects with a MODEL collider
+ * (CheckCollisionOnModel traverses their geometry), colored or transparent objects.
+ */
 struct WorldFlattener
 {
-  struct ZoneGroup
-  {
-    LPoint3f              size;
-    std::list<MapObject*> objects;
-  };
-  
-  struct TextureGroup
-  {
-    TextureGroup(const std::string& texture) : texture(texture) {}
-    bool operator==(const std::string& comp) const { return (texture == comp); }
-    
-    std::string           texture;
-    std::list<MapObject*> objects;
-    std::list<ZoneGroup>  zone_groups;
-  };
-  
-  struct BranchGroup
-  {
-    BranchGroup(void) {}
-    BranchGroup(std::string root) : root(root) {}
-    bool operator==(std::string comp) const { return (root == comp); }
-
-    std::string             root;
-    std::list<MapObject*>   objects;
-    std::list<TextureGroup> texture_groups;
-  };
-  
-  struct WallGroup : public BranchGroup
-  {
-    WallGroup(unsigned char floor) : floor(floor) {}
-    bool operator==(unsigned char comp) const { return (floor == comp); }
-    
-    unsigned char           floor;
-  };
-
-public:
   WorldFlattener(World& world);
 
-  void Flatten(void);
+  NodePath            Flatten(void);
 
-private:
-  void MakeFloorGroups(void);
+  static bool         CanFlatten(const MapObject&);
+  static std::string  SideFilePath(const std::string& blob_path);
+  static unsigned int SourceChecksum(World& world);
+  static unsigned int Load(World& world, const std::string& blob_path);
+  static unsigned int Apply(World& world, NodePath flattened);
 
-  template<typename T>
-  void MakeTextureGroups(std::list<T>& groups)
+private:
+  struct GroupKey
   {
-    auto it  = groups.begin();
-    auto end = groups.end();
-
-    for (; it != end ; ++it)
+    bool operator<(const GroupKey& other) const
     {
-      MakeTextureGroups(*it);
-      MakeZoneGroups(*it);
+      if (floor != other.floor)
+        return (floor < other.floor);
+      if (texture != other.texture)
+        return (texture < other.texture);
+      return (lights < other.lights);
     }
-  }
-  
-  void MakeTextureGroups(BranchGroup&);
-  void MakeZoneGroups(BranchGroup&);
-  void MakeZoneGroups(TextureGroup&);
-  void FindChildForObject(BranchGroup&, MapObject*);
-  
-  std::pair<MapObject*, MapObject*> SmallestCombination(const std::list<MapObject*>&);
-  float                             GetCombinedArea(MapObject*, MapObject*);
-  void                              FlattenObjects(MapObject*, MapObject*);
-  
-  template<typename T, typename P>
-  static T&   RequireGroup(std::list<T>& array, P key)
-  {
-    auto it = std::find(array.rbegin(), array.rend(), key);
 
-    if (it == array.rend())
-    {
-      array.push_back(T(key));
-      it = array.rbegin();
-    }
-    return (*it);
-  }
+    unsigned char floor;
+    std::string   texture;
+    std::string   lights;
+  };
 
-  World&                  world;
-  FlattenMap              flatten_map;
-  std::list<BranchGroup>  floor_groups;
-  std::list<TextureGroup> texture_groups;
-  std::list<WallGroup>    wall_groups;
-};
+  typedef std::pair<unsigned int, MapObject*>       Member; // Index in World::objects, object
+  typedef std::map<GroupKey, std::list<Member> >    Groups;
 
+  void                MakeGroups(Groups&);
+  std::string         GetLights(const MapObject&) const;
+
+  World&              world;
+};
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,79 @@
+#ifndef  WORLD_SECTIONS_HPP
+# define WORLD_SECTIONS_HPP
+
+# include "serializer.hpp"
+# include <string>
+# include <vector>
+# include <stdexcept>
+
+/*
+ * Map blobs from revision 17 on store the static parts of the World as independent sections,
+ * behind a table giving the offset and size of each of them: a section can be decoded without
+ * going through the ones before it, and several sections can be decoded at the same time.
+ * Most sections hold a regular Utils::Packet. Waypoints and arcs, which make the bulk of large maps,
+ * are stored as fixed-layout arrays instead of tagged values. The section table and the waypoint
+ * section are little-endian, whatever the byte order of the host.
+ * Dynamic objects aren't in a section: they follow it as a regular Packet array, which is where
+ * level saves splice them (see DeltaSave).
+ */
+class WorldSections
+{
+public:
+  enum Section
+  {
+    Waypoints       = 0,
+    Assets          = 1, // models and textures used by the objects, preloaded while the waypoints are decoded
+    Objects         = 2,
+    Lights          = 3,
+    ParticleObjects = 4,
+    Zones           = 5,
+    Sunlight        = 6,
+    SectionCount
+  };
+
+  struct Exception : public std::runtime_error
+  {
+    Exception(const std::string& message) : std::runtime_error("map sections: " + message) {}
+  };
+
+  struct WaypointRecord
+  {
+    unsigned int  id;
+    float         x, y, z;
+    unsigned char floor, floor_above, suggested_floor_above;
+    unsigned int  first_arc, arc_count; // arcs are stored in WaypointTable::arcs
+  };
+
+  struct WaypointTable
+  {
+    std::vector<WaypointRecord> waypoints;
+    std::vector<unsigned int>   arcs; // ids of the destination waypoints
+
+    std::string Encode(void) const;
+    void        Decode(const char* data, size_t size);
+  };
+
+  typedef std::pair<const char*, size_t> Bytes;
+
+  WorldSections(void);
+
+  void          Set(Section, const std::string& bytes);
+  void          Set(Section, const Utils::Packet&);
+  std::string   Write(void) const;
+  void          Read(const std::string& blob);
+
+  bool          Has(Section section) const { return (sections[section].first != 0); }
+  Bytes         Get(Section) const;
+  Utils::Packet GetPacket(Section) const;
+
+  static const unsigned int record_size = 4 * sizeof(std::uint32_t) + 3 * sizeof(float);
+
+private:
+  WorldSections(const WorldSections&); // sections point into data
+
+  std::string   data;
+  Bytes         sections[SectionCount];
+  std::string   pending[SectionCount];
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include "world/asset_cache.hpp"
+#include "world/colmask.hpp"
+#include "logger.hpp"
+#include <panda3d/loader.h>
+#include <panda3d/texturePool.h>
+#include <panda3d/geomNode.h>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+AssetCache& AssetCache::Get(void)
+{
+  static AssetCache cache;
+
+  return (cache);
+}
+
+AssetCache::AssetCache(void) : budget(256 * 1024 * 1024), memory(0), tick(0)
+{
+}
+
+AssetCache::Entry* AssetCache::RequireModel(const string& path)
+{
+  auto it = models.find(path);
+
+  if (it == models.end())
+  {
+    LoaderOptions options(LoaderOptions::LF_search | LoaderOptions::LF_report_errors | LoaderOptions::LF_no_ram_cache);
+    PT(PandaNode) node = Loader::get_global_ptr()->load_sync(Filename(path), options);
+    Entry         entry;
+
+    if (node.is_null())
+      return (0);
+    entry.model  = NodePath(node);
+    entry.model.set_collide_mask(CollideMask(ColMask::Render)); // Set once: instances share the GeomNodes
+    entry.memory = EstimateMemory(entry.model);
+    memory      += entry.memory;
+    stats.loads++;
+    it = models.insert(Entries::value_type(path, entry)).first;
+  }
+  else
+    stats.hits++;
+  it->second.last_used = ++tick;
+  return (&it->second);
+}
+
+/*
+ * The model is shared by every instance: state changes must be made on the parent, not on the returned NodePath.
+ */
+NodePath AssetCache::InstanceModel(const string& path, NodePath parent)
+{
+  Entry* entry = RequireModel(path);
+
+  if (!entry)
+    return (NodePath());
+  return (entry->model.instance_to(parent));
+}
+
+/*
+ * For models which get modified after loading (animated characters, doors...)
+ */
+NodePath AssetCache::CopyModel(const string& path)
+{
+  Entry* entry = RequireModel(path);
+
+  if (!entry)
+    return (NodePath());
+  return (NodePath(entry->model.node()->copy_subgraph()));
+}
+
+PT(Texture) AssetCache::LoadTexture(const string& path)
+{
+  auto it = textures.find(path);
+
+  if (it == textures.end())
+  {
+    Entry entry;
+
+    entry.texture = TexturePool::load_texture(path);
+    if (entry.texture.is_null())
+      return (0);
+    // The cache decides when the texture gets released
+    TexturePool::release_texture(entry.texture);
+    entry.memory  = entry.texture->estimate_texture_memory();
+    memory       += entry.memory;
+    stats.loads++;
+    it = textures.insert(Entries::value_type(path, entry)).first;
+  }
+  else
+    stats.hits++;
+  it->second.last_used = ++tick;
+  return (it->second.texture);
+}
+
+size_t AssetCache::EstimateMemory(NodePath model)
+{
+  NodePathCollection geom_nodes = model.find_all_matches("**/+GeomNode");
+  size_t             size       = 0;
+
+  for (int i = 0 ; i < geom_nodes.get_num_paths() ; ++i)
+  {
+    GeomNode* node = DCAST(GeomNode, geom_nodes.get_path(i).node());
+
+    for (int ii = 0 ; ii < node->get_num_geoms() ; ++ii)
+    {
+      CPT(Geom) geom = node->get_geom(ii);
+
+      size += geom->get_vertex_data()->get_num_bytes();
+      for (int iii = 0 ; iii < geom->get_num_primitives() ; ++iii)
+        size += geom->get_primitive(iii)->get_num_bytes();
+    }
+  }
+  return (size);
+}
+
+bool AssetCache::IsInUse(const Entry& entry) const
+{
+  if (!(entry.model.is_empty()))
+    return (entry.model.node()->get_num_parents() > 0); // one parent per instance
+  return (entry.texture->get_ref_count() > 1);
+}
+
+void AssetCache::Evict(Entries::iterator it)
+{
+  memory -= it->second.memory;
+  stats.evictions++;
+  if (!(it->second.model.is_empty()))
+    models.erase(it);
+  else
+    textures.erase(it);
+}
+
+/*
+ * Called between levels, once the previous level is gone and before the next one gets loaded.
+ */
+void AssetCache::Trim(void)
+{
+  vector<Entries::iterator> unused;
+
+  for (auto it = models.begin() ; it != models.end() ; ++it)
+  {
+    if (!(IsInUse(it->second)))
+      unused.push_back(it);
+  }
+  for (auto it = textures.begin() ; it != textures.end() ; ++it)
+  {
+    if (!(IsInUse(it->second)))
+      unused.push_back(it);
+  }
+  sort(unused.begin(), unused.end(), [](Entries::iterator a, Entries::iterator b) { return (a->second.last_used < b->second.last_used); });
+  for (auto it = unused.begin() ; it != unused.end() && memory > budget ; ++it)
+    Evict(*it);
+  LOG(Map, Debug) << "Asset cache: " << stats.loads << " loads, " << stats.hits << " hits, " << stats.evictions << " evictions, "
+                  << (memory / 1024) << "KB used out of " << (budget / 1024) << "KB";
+}
+
+void AssetCache::Clear(void)
+{
+  stats.evictions += models.size() + textures.size();
+  models.clear();
+  textures.clear();
+  memory = 0;
+}
@@ -2,6 +2,7 @@
 #include "world/map_object.hpp"
 #include "world/waypoint.hpp"
 #include "world/light.hpp"
+#include "world/asset_cache.hpp"
 #include "serializer.hpp"
 #ifdef GAME_EDITOR
 # include "qpandaapplication.h"
@@ -103,25 +104,35 @@ void MapObject::SetName(const std::string& name)
     nodePath.set_name(name);
 }
 
+/*
+ * Objects which can share their model get an instance of the cached model under their own render node:
+ * the state (texture, color) is set on that node, never on the shared geometry.
+ * The others get their own copy. Either way, the geometry collides as ColMask::Render, as set by the cache.
+ */
 void MapObject::SetModel(const std::string& model)
 {
-#ifdef GAME_EDITOR
-  PandaFramework& panda_framework = QPandaApplication::Framework();
-#else
-  PandaFramework& panda_framework = *framework;
-#endif
-
   if (!(render.is_empty()))
     render.remove_node();
   strModel = model;
-  render   = panda_framework.get_window(0)->load_model(panda_framework.get_models(), MODEL_ROOT + strModel);
-  render.set_name("render-" + nodePath.get_name());
-  render.set_collide_mask(CollideMask(ColMask::Render));
-  if (use_color || use_opacity)
-    render.set_color_scale(base_color);
-  render.reparent_to(nodePath);
-  if (!(render.is_empty()) && use_texture == true)
-    SetTexture(strTexture);
+  if (CanShareModel())
+  {
+    render = nodePath.attach_new_node("render-" + nodePath.get_name());
+    if (AssetCache::Get().InstanceModel(MODEL_ROOT + strModel, render).is_empty())
+      render.remove_node();
+  }
+  else
+  {
+    render = AssetCache::Get().CopyModel(MODEL_ROOT + strModel);
+    render.set_name("render-" + nodePath.get_name());
+    render.reparent_to(nodePath);
+  }
+  if (!(render.is_empty()))
+  {
+    if (use_color || use_opacity)
+      render.set_color_scale(base_color);
+    if (use_texture == true)
+      SetTexture(strTexture);
+  }
   else
     std::cerr << "[MapObject][SetModel] Could not load model " << strModel << " for object '" << name << '\'' << std::endl;
 }
@@ -131,7 +142,7 @@ void MapObject::SetTexture(const std::string& new_texture)
   strTexture = new_texture;
   if (!(render.is_empty()) && strTexture != "")
   {
-    texture    = TexturePool::load_texture(TEXT_ROOT + strTexture);
+    texture    = AssetCache::Get().LoadTexture(TEXT_ROOT + strTexture);
     if (texture)
       render.set_texture(texture);
     else
@@ -306,6 +317,7 @@ void Collider::InitializeCollider(Type type, LPoint3f position, LPoint3f scale,
   node.set_hpr(hpr);
 }
 
+// Only the collision nodes are changed: the GeomNodes of the render may be shared with other objects
 void MapObject::InitializeCollideMask(void)
 {
   int flag     = GetObjectCollideMask();
@@ -315,7 +327,7 @@ void MapObject::InitializeCollideMask(void)
     col_flag |= ColMask::CheckCollisionOnModel;
   if (waypoints.size() > 0)
     col_flag |= ColMask::WpPlane;
-  nodePath.set_collide_mask(flag);
+  nodePath.set_collide_mask(CollideMask(flag), CollideMask::all_on(), CollisionNode::get_class_type());
   collider.node.set_collide_mask(col_flag);
 }
 
@@ -320,7 +320,7 @@ Waypoint* Waypoint::GetRandomWaypoint(void) const
   if (arcs_withdrawed.size() > 0)
   {
     ArcsWithdrawed::const_iterator it  = arcs_withdrawed.begin();
-    unsigned int                   i   = Dices::Throw(arcs_withdrawed.size() - 1);
+    unsigned int                   i   = Dices::Throw(arcs_withdrawed.size() - 1, Dices::Ai);
 
     std::advance(it, i);
     return ((*it).first.to);
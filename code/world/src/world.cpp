@@ -3,7 +3,10 @@
 #include <panda3d/collisionBox.h>
 #include <panda3d/collisionSphere.h>
 #include <panda3d/collisionRay.h>
-#define CURRENT_BLOB_REVISION 16
+#include "world/asset_cache.hpp"
+#include "job_system.hpp"
+#include "profiler.hpp"
+#include <set>
 
 using namespace std;
 
@@ -56,9 +59,20 @@ Waypoint* World::AddWayPoint(float x, float y, float z)
 
   model_sphere.instance_to(nodePath);
   waypoint.nodePath.set_pos(x, y, z);
+#ifndef GAME_EDITOR
+  if (waypoints.size() == waypoints.capacity())
+  {
+    waypoints.push_back(waypoint);
+    RebuildWaypointNodeIndex();
+  }
+  else
+    waypoints.push_back(waypoint);
+#else
   waypoints.push_back(waypoint);
+#endif
   nodePath.reparent_to(rootWaypoints);
   ptr = &(*(--(waypoints.end())));
+  RegisterWaypoint(*ptr);
   return (ptr);
 }
 
@@ -70,6 +84,7 @@ void World::DeleteWayPoint(Waypoint* toDel)
     if (it != waypoints.end())
     {
       toDel->DisconnectAll();
+      UnregisterWaypoint(*toDel);
       toDel->nodePath.remove_node();
       waypoints.erase(it);
     }
@@ -139,17 +154,152 @@ Waypoint* World::GetWaypointClosest(LPoint3 pos_1, unsigned char floor)
   return (best);
 }
 
+/*
+ * Spatial index of the waypoints, for lookups by position (see Mouse::ClosestWaypoint).
+ * Cells are sized to hold a few waypoints each.
+ */
+void World::IndexWaypoints(void)
+{
+  LPoint3f min_pos, max_pos;
+
+  waypoint_grid.Clear();
+  if (waypoints.empty())
+    return ;
+  min_pos = max_pos = waypoints.front().GetPosition();
+  ForEach(waypoints, [&min_pos, &max_pos](Waypoint& waypoint)
+  {
+    LPoint3f pos = waypoint.GetPosition();
+
+    min_pos.set_x(min(min_pos.get_x(), pos.get_x())); max_pos.set_x(max(max_pos.get_x(), pos.get_x()));
+    min_pos.set_y(min(min_pos.get_y(), pos.get_y())); max_pos.set_y(max(max_pos.get_y(), pos.get_y()));
+  });
+  {
+    float area = (max_pos.get_x() - min_pos.get_x()) * (max_pos.get_y() - min_pos.get_y());
+
+    waypoint_grid.SetCellSize(max(1.f, sqrtf(area / waypoints.size()) * 2.f));
+  }
+  ForEach(waypoints, [this](Waypoint& waypoint)
+  {
+    LPoint3f pos = waypoint.GetPosition();
+
+    waypoint_grid.Insert(&waypoint, pos.get_x(), pos.get_y(), pos.get_z());
+  });
+}
+
 Waypoint* World::GetWaypointFromNodePath(NodePath path)
 {
-  Waypoints::iterator it  = waypoints.begin();
-  Waypoints::iterator end = waypoints.end();
+  return (GetObjectFromNodePath(path, waypoint_node_index));
+}
 
-  for (; it != end ; ++it)
+/*
+ * Node indexes
+ */
+void World::RegisterWaypoint(Waypoint& waypoint)
+{
+  if (!(waypoint.nodePath.is_empty()))
+    waypoint_node_index[waypoint.nodePath.node()] = &waypoint;
+}
+
+void World::RegisterMapObject(MapObject& object)
+{
+  if (!(object.nodePath.is_empty()))
   {
-      if ((*it).nodePath.is_ancestor_of(path))
-    return (&(*it));
+    map_object_node_index[object.nodePath.node()] = &object;
+    map_object_name_index.insert(MapObjectNameIndex::value_type(object.nodePath.get_name(), &object));
+  }
+}
+
+// Dynamic objects are inserted at the front of their list: the most recent one shadows the others.
+void World::RegisterDynamicObject(DynamicObject& object)
+{
+  if (!(object.nodePath.is_empty()))
+  {
+    dynamic_object_node_index[object.nodePath.node()] = &object;
+    dynamic_object_name_index[object.nodePath.get_name()] = &object;
+  }
+}
+
+void World::UnregisterWaypoint(Waypoint& waypoint)
+{
+  if (!(waypoint.nodePath.is_empty()))
+    waypoint_node_index.erase(waypoint.nodePath.node());
+}
+
+void World::UnregisterMapObject(MapObject& object)
+{
+  if (!(object.nodePath.is_empty()))
+  {
+    map_object_node_index.erase(object.nodePath.node());
+    UnregisterName(object.nodePath.get_name(), &object, map_object_name_index, objects);
   }
-  return (0);
+}
+
+void World::UnregisterDynamicObject(DynamicObject& object)
+{
+  if (!(object.nodePath.is_empty()))
+  {
+    dynamic_object_node_index.erase(object.nodePath.node());
+    UnregisterName(object.nodePath.get_name(), &object, dynamic_object_name_index, dynamicObjects);
+  }
+}
+
+void World::RegisterLight(WorldLight& light)
+{
+  light_name_index.insert(LightNameIndex::value_type(light.name, &light));
+}
+
+void World::UnregisterLight(WorldLight& light)
+{
+  UnregisterName(light.name, &light, light_name_index, lights);
+}
+
+// Waypoints may be stored in a vector: any reallocation invalidates the pointers held by the index.
+void World::RebuildWaypointNodeIndex(void)
+{
+  waypoint_node_index.clear();
+  ForEach(waypoints, [this](Waypoint& waypoint) { RegisterWaypoint(waypoint); });
+}
+
+void World::RebuildNameIndexes(void)
+{
+  map_object_name_index.clear();
+  dynamic_object_name_index.clear();
+  light_name_index.clear();
+  zone_name_index.clear();
+  ForEach(objects, [this](MapObject& object)
+  {
+    if (!(object.nodePath.is_empty()))
+      map_object_name_index.insert(MapObjectNameIndex::value_type(object.nodePath.get_name(), &object));
+  });
+  ForEach(dynamicObjects, [this](DynamicObject& object)
+  {
+    if (!(object.nodePath.is_empty()))
+      dynamic_object_name_index.insert(DynamicObjectNameIndex::value_type(object.nodePath.get_name(), &object));
+  });
+  ForEach(lights, [this](WorldLight& light) { RegisterLight(light); });
+  ForEach(zones,  [this](Zone& zone)        { zone_name_index.insert(ZoneNameIndex::value_type(zone.name, &zone)); });
+}
+
+void World::RenameObject(MapObject* object, const std::string& name)
+{
+  bool is_dynamic_object = GetObjectFromNodePath(object->nodePath, dynamic_object_node_index) == object;
+
+  if (is_dynamic_object)
+    UnregisterDynamicObject(*static_cast<DynamicObject*>(object));
+  else
+    UnregisterMapObject(*object);
+  object->SetName(name);
+  if (is_dynamic_object)
+    RegisterDynamicObject(*static_cast<DynamicObject*>(object));
+  else
+    RegisterMapObject(*object);
+}
+
+void World::RenameLight(WorldLight* light, const std::string& name)
+{
+  UnregisterLight(*light);
+  light->name = name;
+  RegisterLight(*light);
 }
 
 #ifndef GAME_EDITOR
@@ -215,6 +365,7 @@ MapObject* World::AddMapObject(const string &name, const string &model, const st
     object.InitializeCollideMask();
   }
   objects.push_back(object);
+  RegisterMapObject(*objects.rbegin());
   return (&(*(--(objects.end()))));
 }
 
@@ -261,45 +412,44 @@ void World::DeleteMapObject(MapObject* ptr)
           ++it;
       }
     }
+    UnregisterMapObject(*ptr);
     DeleteObject(ptr, objects);
   }
 }
 
 MapObject* World::GetObjectFromName(const string& name)
 {
-  MapObject* result = GetObjectFromName(name, objects);
+  MapObject* result = GetObjectFromName(name, map_object_name_index);
 
-  return (result != 0 ? result : GetObjectFromName(name, dynamicObjects));
+  return (result != 0 ? result : GetObjectFromName(name, dynamic_object_name_index));
 }
 
 MapObject* World::GetObjectFromNodePath(const NodePath nodepath)
 {
-  MapObject* result = GetObjectFromNodePath(nodepath, objects);
+  MapObject* result = GetObjectFromNodePath(nodepath, map_object_node_index);
 
-  return (result != 0 ? result : GetObjectFromNodePath(nodepath, dynamicObjects));
+  return (result != 0 ? result : GetObjectFromNodePath(nodepath, dynamic_object_node_index));
 }
 
 MapObject* World::GetMapObjectFromName(const string &name)
 {
-  return (GetObjectFromName(name, objects));
+  return (GetObjectFromName(name, map_object_name_index));
 }
 
 MapObject* World::GetMapObjectFromNodePath(NodePath path)
 {
-  return (GetObjectFromNodePath(path, objects));
+  return (GetObjectFromNodePath(path, map_object_node_index));
 }
 
 MapObject* World::GetMapObjectFromCollisionNode(NodePath path)
 {
-  auto it  = objects.begin();
-  auto end = objects.end();
+  MapObject* object = GetObjectFromNodePath(path, map_object_node_index);
 
-  for (; it != end ; ++it)
+  while (object != 0)
   {
-    MapObject& object = *it;
-
-    if (!(object.collider.node.is_empty()) && object.collider.node.is_ancestor_of(path))
-      return (&object);
+    if (!(object->collider.node.is_empty()) && object->collider.node.is_ancestor_of(path))
+      return (object);
+    object = GetObjectFromNodePath(object->nodePath.get_parent(), map_object_node_index);
   }
   return (0);
 }
@@ -338,6 +488,7 @@ DynamicObject* World::InsertDynamicObject(DynamicObject& object)
     return (0);
   object.nodePath.set_collide_mask(CollideMask(ColMask::DynObject));
   dynamicObjects.insert(dynamicObjects.begin(), object);
+  RegisterDynamicObject(*dynamicObjects.begin());
   DynamicObjectChangeFloor(*dynamicObjects.begin(), object.floor);
   return (&(*dynamicObjects.begin()));
 }
@@ -363,17 +514,19 @@ DynamicObject* World::AddDynamicObject(const string &name, DynamicObject::Type t
 
 void World::DeleteDynamicObject(DynamicObject* ptr)
 {
+  if (ptr)
+    UnregisterDynamicObject(*ptr);
   DeleteObject(ptr, dynamicObjects);
 }
 
 DynamicObject* World::GetDynamicObjectFromName(const string &name)
 {
-  return (GetObjectFromName(name, dynamicObjects));
+  return (GetObjectFromName(name, dynamic_object_name_index));
 }
 
 DynamicObject* World::GetDynamicObjectFromNodePath(NodePath path)
 {
-  return (GetObjectFromNodePath(path, dynamicObjects));
+  return (GetObjectFromNodePath(path, dynamic_object_node_index));
 }
 
 // ENTRY ZONES
@@ -383,6 +536,7 @@ void World::AddZone(const std::string& name)
 
   zone.name = name;
   zones.push_back(zone);
+  zone_name_index.insert(ZoneNameIndex::value_type(name, &(*zones.rbegin())));
 }
 
 void World::DeleteZone(const std::string& name)
@@ -390,22 +544,22 @@ void World::DeleteZone(const std::string& name)
   Zones::iterator it = std::find(zones.begin(), zones.end(), name);
 
   if (it != zones.end())
+  {
+    UnregisterName(name, &(*it), zone_name_index, zones);
     zones.erase(it);
+  }
 }
 
 Zone* World::GetZoneByName(const std::string& name)
 {
-  Zones::iterator it = std::find(zones.begin(), zones.end(), name);
-
-  if (it != zones.end())
-    return (&(*it));
-  return (0);
+  return (GetObjectFromName(name, zone_name_index));
 }
 
 // Lights
 void World::AddLight(WorldLight::Type type, const std::string& name)
 {
   lights.push_back(WorldLight(type, WorldLight::Type_None, rootLights, name));
+  RegisterLight(*lights.rbegin());
 }
 
 void World::AddLight(WorldLight::Type type, const std::string& name, MapObject* parent)
@@ -426,6 +580,7 @@ void World::DeleteLight(const std::string& name)
 
   if (it != lights.end())
   {
+    UnregisterLight(*it);
     it->nodePath.detach_node();
     lights.erase(it);
   }
@@ -441,11 +596,7 @@ void World::DeleteParticleObject(const string& name)
 
 WorldLight* World::GetLightByName(const std::string& name)
 {
-  WorldLights::iterator it = std::find(lights.begin(), lights.end(), name);
-
-  if (it != lights.end())
-    return (&(*it));
-  return (0);
+  return (GetObjectFromName(name, light_name_index));
 }
 
 ParticleObject* World::GetParticleObjectByName(const string& name)
@@ -545,11 +696,54 @@ void           World::SetDynamicObjectsVisible(bool v)
  */
 void           World::UnSerialize(Utils::Packet& packet)
 {
+  PROFILE_ZONE("Loading:World");
+
   LoadingWorld = this;
   if (blob_revision >= 1)
     packet >> blob_revision;
   cout << "Blob revision is  " << blob_revision << endl;
 
+  if (blob_revision >= 17)
+    UnSerializeSections(packet);
+  else
+    UnSerializeTagged(packet);
+  RebuildNameIndexes();
+
+    cout << "Solving branch relations" << endl;
+  /*
+   * Solving branching relations between MapObjects
+   */
+  UpdateMapTree();
+
+#ifdef GAME_EDITOR
+  std::for_each(objects.begin(), objects.end(), [this](MapObject& object)
+  {
+    unsigned int i = 0;
+
+    for (; i < object.waypoints.size() ; ++i)
+    {
+      Waypoint* wp = object.waypoints[i];
+      wp->nodePath.set_pos(window->get_render(), wp->nodePath.get_pos());
+    }
+  });
+#endif
+
+#ifndef GAME_EDITOR
+  CompileWaypointsFloorAbove();
+#endif
+
+  cout << "Compiling lights" << endl;
+  // Post-loading stuff
+#ifndef GAME_EDITOR
+  for_each(lights.begin(), lights.end(), [this](WorldLight& light) { CompileLight(&light, ColMask::Object | ColMask::DynObject | ColMask::Waypoint); });
+#else
+  for_each(lights.begin(), lights.end(), [this](WorldLight& light) { CompileLight(&light, ColMask::Object | ColMask::DynObject); });
+#endif
+  LoadingWorld = 0;
+}
+
+void           World::UnSerializeTagged(Utils::Packet& packet)
+{
   cout << "Unserialize waypoints" << endl;
   // Waypoints
   {
@@ -574,9 +768,12 @@ void           World::UnSerialize(Utils::Packet& packet)
     {
       (*it).UnserializeLoadArcs(this);
     }
+    RebuildWaypointNodeIndex();
   }
 
   packet >> objects >> dynamicObjects >> lights;
+  ForEach(objects,        [this](MapObject& object)     { RegisterMapObject(object);     });
+  ForEach(dynamicObjects, [this](DynamicObject& object) { RegisterDynamicObject(object); });
 
   cout << "Unserialize particle objects" << endl;
   if (blob_revision >= 13)
@@ -591,38 +788,94 @@ void           World::UnSerialize(Utils::Packet& packet)
     packet >> serialize_sunlight_enabled;
     sunlight_enabled = serialize_sunlight_enabled != 0;
   }
+}
 
-    cout << "Solving branch relations" << endl;
-  /*
-   * Solving branching relations between MapObjects
-   */
-  UpdateMapTree();
+/*
+ * The waypoint section is decoded by the job system while this thread loads the models used by the objects.
+ * Everything touching the scene graph stays on this thread.
+ */
+void           World::UnSerializeSections(Utils::Packet& packet)
+{
+  WorldSections                sections;
+  WorldSections::WaypointTable waypoint_table;
+  Sync::JobGroup               decoding;
+  std::string                  blob;
 
-#ifdef GAME_EDITOR
-  std::for_each(objects.begin(), objects.end(), [this](MapObject& object)
+  packet >> blob;
+  sections.Read(blob);
   {
-    unsigned int i = 0;
+    WorldSections::Bytes bytes = sections.Get(WorldSections::Waypoints);
 
-    for (; i < object.waypoints.size() ; ++i)
+    Sync::JobSystem::Get().Push(decoding, [&waypoint_table, bytes]() { waypoint_table.Decode(bytes.first, bytes.second); });
+  }
+  try
+  {
+    if (sections.Has(WorldSections::Assets))
     {
-      Waypoint* wp = object.waypoints[i];
-      wp->nodePath.set_pos(window->get_render(), wp->nodePath.get_pos());
+      Utils::Packet assets = sections.GetPacket(WorldSections::Assets);
+
+      PreloadAssets(assets);
     }
-  });
-#endif
+  }
+  catch (...)
+  {
+    Sync::JobSystem::Get().Wait(decoding); // the job refers to this frame
+    throw ;
+  }
+  Sync::JobSystem::Get().Wait(decoding);
 
-#ifndef GAME_EDITOR
-  CompileWaypointsFloorAbove();
-#endif
+  UnSerializeWaypoints(waypoint_table);
+  {
+    Utils::Packet section = sections.GetPacket(WorldSections::Objects);
 
-  cout << "Compiling lights" << endl;
-  // Post-loading stuff
-#ifndef GAME_EDITOR
-  for_each(lights.begin(), lights.end(), [this](WorldLight& light) { CompileLight(&light, ColMask::Object | ColMask::DynObject | ColMask::Waypoint); });
-#else
-  for_each(lights.begin(), lights.end(), [this](WorldLight& light) { CompileLight(&light, ColMask::Object | ColMask::DynObject); });
-#endif
-  LoadingWorld = 0;
+    section >> objects;
+  }
+  packet >> dynamicObjects;
+  ForEach(objects,        [this](MapObject& object)     { RegisterMapObject(object);     });
+  ForEach(dynamicObjects, [this](DynamicObject& object) { RegisterDynamicObject(object); });
+  {
+    Utils::Packet lights_section    = sections.GetPacket(WorldSections::Lights);
+    Utils::Packet particles_section = sections.GetPacket(WorldSections::ParticleObjects);
+    Utils::Packet zones_section     = sections.GetPacket(WorldSections::Zones);
+    Utils::Packet sunlight_section  = sections.GetPacket(WorldSections::Sunlight);
+    char          serialize_sunlight_enabled;
+
+    lights_section    >> lights;
+    particles_section >> particleObjects;
+    zones_section     >> zones;
+    sunlight_section  >> serialize_sunlight_enabled;
+    sunlight_enabled = serialize_sunlight_enabled != 0;
+  }
+}
+
+void           World::UnSerializeWaypoints(const WorldSections::WaypointTable& table)
+{
+  for (auto record = table.waypoints.begin() ; record != table.waypoints.end() ; ++record)
+  {
+    NodePath sphere = rootWaypoints.attach_new_node("waypoint");
+    Waypoint waypoint(sphere);
+
+    model_sphere.instance_to(sphere);
+    waypoint.id                    = record->id;
+    waypoint.floor                 = record->floor;
+    waypoint.floor_above           = record->floor_above;
+    waypoint.suggested_floor_above = record->suggested_floor_above;
+    waypoint.tmpArcs.assign(table.arcs.begin() + record->first_arc,
+                            table.arcs.begin() + record->first_arc + record->arc_count);
+    sphere.set_pos(record->x, record->y, record->z);
+    waypoints.push_back(waypoint);
+  }
+  ForEach(waypoints, [this](Waypoint& waypoint) { waypoint.UnserializeLoadArcs(this); });
+  RebuildWaypointNodeIndex();
+}
+
+void           World::PreloadAssets(Utils::Packet& packet)
+{
+  vector<string> models, textures;
+
+  packet >> models >> textures;
+  ForEach(models,   [](const string& model)   { AssetCache::Get().PreloadModel(MODEL_ROOT + model);  });
+  ForEach(textures, [](const string& texture) { AssetCache::Get().LoadTexture(TEXT_ROOT + texture); });
 }
 
 void           World::UpdateMapTree(void)
@@ -650,6 +903,13 @@ void           World::UpdateMapTree(void)
 }
 
 void           World::Serialize(Utils::Packet& packet, std::function<void (const std::string&, float)> progress_callback)
+{
+  SerializeHead(packet, progress_callback);
+  packet << dynamicObjects;
+  SerializeTail(packet, progress_callback);
+}
+
+void           World::SerializeHead(Utils::Packet& packet, ProgressCallback progress_callback)
 {
   // Compile Step
 # ifdef GAME_EDITOR
@@ -675,16 +935,26 @@ void           World::Serialize(Utils::Packet& packet, std::function<void (const
 # endif
 
   packet << (unsigned int)CURRENT_BLOB_REVISION; // #blob revision
+  packet << SerializeSections(progress_callback);
+}
+
+// Every section is in the head: the tail is left empty, but DeltaSave layouts still refer to it.
+void           World::SerializeTail(Utils::Packet&, ProgressCallback progress_callback)
+{
+  progress_callback("Done serializing", 100);
+}
+
+std::string    World::SerializeSections(ProgressCallback progress_callback)
+{
+  WorldSections sections;
 
   // Waypoints
   {
-    Waypoints::iterator it  = waypoints.begin();
-    Waypoints::iterator end = waypoints.end();
-    unsigned int        id  = 0;
-    int                 size;
+    WorldSections::WaypointTable table;
+    Waypoints::iterator          it  = waypoints.begin();
+    unsigned int                 id  = 0;
 
-    cout << "Serializing " << waypoints.size() << " waypoints." << endl;
-    while (it != end)
+    while (it != waypoints.end())
     {
       if ((*it).arcs.size() == 0)
         it = waypoints.erase(it);
@@ -695,10 +965,25 @@ void           World::Serialize(Utils::Packet& packet, std::function<void (const
       }
       progress_callback("Serializing Waypoints: ", (float)id / waypoints.size() * 100.f);
     }
-    size = waypoints.size();
-    packet << size;
-    for (it = waypoints.begin() ; it != end ; ++it)
-    (*it).Serialize(this, packet);
+    RebuildWaypointNodeIndex();
+    for (it = waypoints.begin() ; it != waypoints.end() ; ++it)
+    {
+      WorldSections::WaypointRecord record;
+      LPoint3f                      pos = it->nodePath.get_pos(window->get_render());
+
+      record.id                    = it->id;
+      record.x                     = pos.get_x();
+      record.y                     = pos.get_y();
+      record.z                     = pos.get_z();
+      record.floor                 = it->floor;
+      record.floor_above           = it->floor_above;
+      record.suggested_floor_above = it->suggested_floor_above;
+      record.first_arc             = table.arcs.size();
+      record.arc_count             = it->arcs.size();
+      ForEach(it->arcs, [&table](const Waypoint::Arc& arc) { table.arcs.push_back(arc.to->id); });
+      table.waypoints.push_back(record);
+    }
+    sections.Set(WorldSections::Waypoints, table.Encode());
   }
 
 #ifdef GAME_EDITOR
@@ -706,14 +991,33 @@ void           World::Serialize(Utils::Packet& packet, std::function<void (const
     CompileDoors(progress_callback);
 #endif
 
-  packet << objects << dynamicObjects << lights << particleObjects << zones;
-
   {
-    char serialize_sunlight_enabled = sunlight_enabled;
-
-    packet << serialize_sunlight_enabled;
+    Utils::Packet assets, objects_section, lights_section, particles_section, zones_section, sunlight_section;
+    set<string>   models, textures;
+    auto          list_assets = [&models, &textures](const MapObject& object)
+    {
+      if (object.strModel != "")
+        models.insert(object.strModel);
+      if (object.use_texture && object.strTexture != "")
+        textures.insert(object.strTexture);
+    };
+
+    ForEach(objects,        list_assets);
+    ForEach(dynamicObjects, list_assets);
+    assets << vector<string>(models.begin(), models.end()) << vector<string>(textures.begin(), textures.end());
+    objects_section   << objects;
+    lights_section    << lights;
+    particles_section << particleObjects;
+    zones_section     << zones;
+    sunlight_section  << (char)sunlight_enabled;
+    sections.Set(WorldSections::Assets,          assets);
+    sections.Set(WorldSections::Objects,         objects_section);
+    sections.Set(WorldSections::Lights,          lights_section);
+    sections.Set(WorldSections::ParticleObjects, particles_section);
+    sections.Set(WorldSections::Zones,           zones_section);
+    sections.Set(WorldSections::Sunlight,        sunlight_section);
   }
-  progress_callback("Done serializing", 100);
+  return (sections.Write());
 }
 
 // MAP COMPILING
@@ -1,254 +1,232 @@
 #include "world/world_flatten.hpp"
+#include "world/light.hpp"
+#include <panda3d/loader.h>
+#include <zlib.h>
+#include <fstream>
+#include <sstream>
+#include <set>
+#include <vector>
 
 using namespace std;
 
-LPoint3 NodePathSize(NodePath np);
-
-struct BoundingZone
+static string JoinNames(const set<string>& names)
 {
-  BoundingZone operator+(BoundingZone other) const
-  {
-    LPoint3f lowest_point  = GetLowestPoint(other);
-    LPoint3f highest_point = GetHighestPoint(other);
+  string joined;
 
-    other.position = position;
-    other.size     = highest_point - lowest_point;
-    return (other);
-  }
-
-  LPoint3f GetLowestPoint(BoundingZone other) const
-  {
-    LPoint3f self_lowest  = GetLowestExtremity();
-    LPoint3f other_lowest = other.GetLowestExtremity();
-    
-    self_lowest.set_x(self_lowest.get_x() < other_lowest.get_x() ? self_lowest.get_x() : other_lowest.get_x());
-    self_lowest.set_y(self_lowest.get_y() < other_lowest.get_y() ? self_lowest.get_y() : other_lowest.get_y());
-    self_lowest.set_z(self_lowest.get_z() < other_lowest.get_z() ? self_lowest.get_z() : other_lowest.get_z());
-    return (self_lowest);
-  }
+  for (auto it = names.begin() ; it != names.end() ; ++it)
+    joined += (joined == "" ? "" : "\n") + *it;
+  return (joined);
+}
 
-  LPoint3f GetHighestPoint(BoundingZone other) const
-  {
-    LPoint3f self_highest  = GetHighestExtremity();
-    LPoint3f other_highest = other.GetHighestExtremity();
-    
-    self_highest.set_x(self_highest.get_x() < other_highest.get_x() ? self_highest.get_x() : other_highest.get_x());
-    self_highest.set_y(self_highest.get_y() < other_highest.get_y() ? self_highest.get_y() : other_highest.get_y());
-    self_highest.set_z(self_highest.get_z() < other_highest.get_z() ? self_highest.get_z() : other_highest.get_z());
-    return (self_highest);
-  }
+static string NumberToString(unsigned int number)
+{
+  stringstream stream;
 
-  LPoint3f GetLowestExtremity(void) const
-  {
-    return (position - (size / 2));
-  }
-  
-  LPoint3f GetHighestExtremity(void) const
-  {
-    return (position + (size / 2));
-  }
-  
-  void SetFromObject(MapObject* object, NodePath root)
-  {
-    position = object->nodePath.get_pos(root);
-    size     = NodePathSize(object->render);
-  }
-  
-  LPoint3f position;
-  LPoint3f size;
-};
+  stream << number;
+  return (stream.str());
+}
 
-WorldFlattener::WorldFlattener(World& world) : world(world)
+static list<string> SplitNames(const string& joined)
 {
+  list<string> names;
+  stringstream stream(joined);
+  string       name;
+
+  while (getline(stream, name))
+    names.push_back(name);
+  return (names);
 }
 
-void WorldFlattener::Flatten(void)
+static unsigned int Checksum(unsigned int crc, const void* data, size_t size)
 {
-  MakeFloorGroups();
-  MakeTextureGroups(floor_groups);
-  MakeTextureGroups(wall_groups);
-  flatten_map.OutputFlattenMap();
-  flatten_map.FlattenWorld(world);
+  return (crc32(crc, reinterpret_cast<const Bytef*>(data), size));
 }
 
-void WorldFlattener::FindChildForObject(BranchGroup& group, MapObject* parent)
+WorldFlattener::WorldFlattener(World& world) : world(world)
 {
-  auto it  = world.objects.begin();
-  auto end = world.objects.end();
-  
-  for (; it != end ; ++it)
-  {
-    MapObject& object = *it;
+}
 
-    if (object.render.is_empty() || object.IsCuttable())
-      continue ;
-    if (it->parent == parent->name &&
-        (find(group.objects.begin(), group.objects.end(), &object) == group.objects.end()))
-    {
-      group.objects.push_back(&object);
-      FindChildForObject(group, &object);
-    }
-  }
+bool WorldFlattener::CanFlatten(const MapObject& object)
+{
+  return (!(object.render.is_empty())            &&
+          !(object.IsCuttable())                 &&
+          object.collider.type != Collider::MODEL &&
+          !(object.use_color || object.use_opacity));
 }
 
-void WorldFlattener::MakeFloorGroups(void)
+std::string WorldFlattener::GetLights(const MapObject& object) const
 {
-  auto it  = world.objects.begin();
-  auto end = world.objects.end();
+  set<string> names;
 
-  for (; it != end ; ++it)
+  for (auto light = world.lights.begin() ; light != world.lights.end() ; ++light)
   {
-    MapObject&  object = *it;
-    
-    if (object.parent == "")
-    {
-      BranchGroup group(object.name);
-      
-      group.objects.push_back(&object);
-      FindChildForObject(group, &object);
-      floor_groups.push_back(group);
-    }
+    if (find(light->enlightened.begin(), light->enlightened.end(), object.render) != light->enlightened.end())
+      names.insert(light->name);
   }
-  
-  for (it = world.objects.begin() ; it != end ; ++it)
-  {
-    MapObject&  object = *it;
-
-    if (object.IsCuttable())
-    {
-      WallGroup& group = RequireGroup(wall_groups, object.floor);
-
-      group.objects.push_back(&object);
-      FindChildForObject(group, &object);
-    }
-  }
-  
-  for_each(floor_groups.begin(), floor_groups.end(), [](BranchGroup& group)
-  {
-    cout << "[GROUP] " << group.root << endl;
-    for_each(group.objects.begin(), group.objects.end(), [](MapObject* object)
-    {
-      cout << object->name << endl;
-    });
-    cout << endl;
-  });
-  
-  for_each(wall_groups.begin(), wall_groups.end(), [](WallGroup& group)
-  {
-    cout << "[GROUP] " << group.root << endl;
-    for_each(group.objects.begin(), group.objects.end(), [](MapObject* object)
-    {
-      cout << object->name << endl;
-    });
-    cout << endl;
-  });
-
-  cout << "Regular groups: " << floor_groups.size() << ", wall groups: " << wall_groups.size() << endl;
+  return (JoinNames(names));
 }
 
-void WorldFlattener::MakeTextureGroups(WorldFlattener::BranchGroup& floor_group)
+// Objects are listed by their index in World::objects: names aren't unique
+void WorldFlattener::MakeGroups(Groups& groups)
 {
-  auto it  = floor_group.objects.begin();
-  auto end = floor_group.objects.end();
+  unsigned int index = 0;
 
-  for (;it != end ; ++it)
+  for (auto it = world.objects.begin() ; it != world.objects.end() ; ++it, ++index)
   {
-    MapObject*    object        = *it;
-    TextureGroup& texture_group = RequireGroup(floor_group.texture_groups, object->strTexture);
+    MapObject& object = *it;
+    GroupKey   key;
 
-    texture_group.objects.push_back(object);
+    if (!(CanFlatten(object)))
+      continue ;
+    key.floor   = object.floor;
+    key.texture = object.strTexture;
+    key.lights  = GetLights(object);
+    groups[key].push_back(Member(index, &object));
   }
 }
 
-void WorldFlattener::MakeZoneGroups(WorldFlattener::BranchGroup& floor_group)
+/*
+ * Groups and objects are visited in a fixed order (map keys, then World::objects):
+ * flattening the same blob twice gives the same file.
+ */
+NodePath WorldFlattener::Flatten(void)
 {
-  auto it  = floor_group.texture_groups.begin();
-  auto end = floor_group.texture_groups.end();
-  
-  for (; it != end ; ++it)
-    MakeZoneGroups(*it);
-}
+  NodePath     root("flattened-world");
+  Groups       groups;
+  unsigned int group_id = 0;
 
-static float ZoneHeuristic(BoundingZone first, BoundingZone second)
-{
-  LPoint3f size = (first + second).size;
+  MakeGroups(groups);
+  for (auto it = groups.begin() ; it != groups.end() ; ++it, ++group_id)
+  {
+    stringstream group_name, indices;
+    NodePath     group;
+    NodePath     floor = world.floors[it->first.floor];
+
+    group_name << "flattened-" << (int)it->first.floor << '-' << group_id;
+    group = root.attach_new_node(group_name.str());
+    for (auto member = it->second.begin() ; member != it->second.end() ; ++member)
+    {
+      NodePath copy = member->second->render.copy_to(group);
 
-  return (size.get_x() * size.get_y());
+      copy.set_transform(member->second->render.get_transform(floor));
+      copy.clear_light(); // lights are set back at runtime, on the whole group
+      indices << member->first << '\n';
+    }
+    group.clear_model_nodes();
+    group.flatten_strong();
+    group.set_tag("floor",   NumberToString(it->first.floor));
+    group.set_tag("lights",  it->first.lights);
+    group.set_tag("objects", indices.str());
+  }
+  root.set_tag("source-crc", NumberToString(SourceChecksum(world)));
+  return (root);
 }
 
-float WorldFlattener::GetCombinedArea(MapObject* first, MapObject* second)
+std::string WorldFlattener::SideFilePath(const std::string& blob_path)
 {
-  BoundingZone zone_1, zone_2;
-
-  zone_1.SetFromObject(first, world.window->get_render());
-  zone_2.SetFromObject(second, world.window->get_render());
-  return (ZoneHeuristic(zone_1, zone_2));
+  return (blob_path.substr(0, blob_path.rfind(".blob")) + ".flat.bam");
 }
 
-std::pair<MapObject*, MapObject*> WorldFlattener::SmallestCombination(const std::list<MapObject*>& objects)
+/*
+ * Checksum of what the baked geometry depends on: the order, models, textures, floors and transforms
+ * of the map objects. It is computed from the loaded world, so that checking a side file doesn't read the blob again.
+ */
+unsigned int WorldFlattener::SourceChecksum(World& world)
 {
-  auto                        first  = objects.begin();
-  auto                        end    = objects.end();
-  pair<MapObject*,MapObject*> best_pair(nullptr, nullptr);
-  float                       smallest_value = -1;
+  unsigned int crc = crc32(0, Z_NULL, 0);
 
-  for (; first != end ; ++first)
+  for (auto it = world.objects.begin() ; it != world.objects.end() ; ++it)
   {
-    auto         second   = first;
-
-    second++;
-    for (; second != end ; ++second)
+    bool can_flatten = CanFlatten(*it);
+
+    crc = Checksum(crc, it->name.c_str(),       it->name.size() + 1);
+    crc = Checksum(crc, it->strModel.c_str(),   it->strModel.size() + 1);
+    crc = Checksum(crc, it->strTexture.c_str(), it->strTexture.size() + 1);
+    crc = Checksum(crc, &it->floor,             sizeof(it->floor));
+    crc = Checksum(crc, &can_flatten,           sizeof(can_flatten));
+    if (can_flatten && it->floor < world.floors.size())
     {
-      float        value;
+      LMatrix4 matrix = it->render.get_transform(world.floors[it->floor])->get_mat();
 
-      value = GetCombinedArea(*first, *second);
-      if (value < smallest_value || smallest_value == -1)
-      {
-        smallest_value = value;
-        best_pair      = pair<MapObject*,MapObject*>(*first, *second);
-      }
+      crc = Checksum(crc, matrix.get_data(), sizeof(*matrix.get_data()) * 16);
     }
   }
-  return (best_pair);
+  return (crc);
 }
 
-void WorldFlattener::FlattenObjects(MapObject* first, MapObject* second)
+unsigned int WorldFlattener::Load(World& world, const std::string& blob_path)
 {
-  NodePath target            = first->render;
-  LPoint3f relative_position = second->nodePath.get_pos(target);
-  LPoint3f relative_hpr      = second->nodePath.get_hpr(target);
-
-  second->render.reparent_to(target);
-  second->render.set_pos(relative_position);
-  second->render.set_hpr(relative_hpr);
-  target.clear_model_nodes();
-  target.flatten_strong();
-  second->render = target;
+  const string    path = SideFilePath(blob_path);
+  PT(PandaNode)   node;
+
+  if (!(ifstream(path.c_str()).is_open()))
+    return (0);
+  node = Loader::get_global_ptr()->load_sync(Filename::binary_filename(path));
+  if (node.is_null())
+  {
+    cerr << "[WorldFlattener] Couldn't load " << path << endl;
+    return (0);
+  }
+  return (Apply(world, NodePath(node)));
 }
 
-void WorldFlattener::MakeZoneGroups(WorldFlattener::TextureGroup& group)
+/*
+ * A side file baked from another version of the map is ignored. So are groups referring to objects
+ * which can't be flattened anymore: those objects are drawn as usual.
+ */
+unsigned int WorldFlattener::Apply(World& world, NodePath flattened)
 {
-  list<MapObject*> list     = group.objects;
-  float            max_size = 150;
+  unsigned int       baked_objects = 0;
+  vector<MapObject*> by_index;
 
-  do
+  if (flattened.get_tag("source-crc") != NumberToString(SourceChecksum(world)))
   {
-    auto  smallest_combination = SmallestCombination(list);
-    
-    if (smallest_combination.first == 0 || smallest_combination.second == 0)
+    cerr << "[WorldFlattener] Flattened geometry is outdated: it won't be used." << endl;
+    return (0);
+  }
+  ForEach(world.objects, [&by_index](MapObject& object) { by_index.push_back(&object); });
+  while (flattened.get_num_children() > 0)
+  {
+    NodePath           group   = flattened.get_child(0);
+    unsigned int       floor   = atoi(group.get_tag("floor").c_str());
+    list<string>       indices = SplitNames(group.get_tag("objects"));
+    list<MapObject*>   objects;
+
+    for (auto index = indices.begin() ; index != indices.end() ; ++index)
     {
-      cout << "No more objects left" << endl;
-      break ;
+      unsigned int position = atoi(index->c_str());
+      MapObject*   object   = position < by_index.size() ? by_index[position] : 0;
+
+      if (!object || !(CanFlatten(*object)) || object->floor != floor)
+        break ;
+      objects.push_back(object);
+    }
+    if (objects.size() != indices.size())
+    {
+      cerr << "[WorldFlattener] Group " << group.get_name() << " doesn't match the map: it won't be used." << endl;
+      group.remove_node();
+      continue ;
     }
-    else
+    if (world.floors.size() <= floor)
+      world.FloorResize(floor + 1);
+    group.reparent_to(world.floors[floor]);
+    ForEach(objects, [](MapObject* object) { object->render.stash(); });
     {
-      float size               = GetCombinedArea(smallest_combination.first, smallest_combination.second);
+      list<string> lights = SplitNames(group.get_tag("lights"));
 
-      cout << "Combined area for " << smallest_combination.first->name << ", " << smallest_combination.second->name << " is " << size << endl;
-      if (size > max_size)
-        break ;
-      flatten_map.AddToGroup(smallest_combination.first->name, smallest_combination.second->name);
-      list.remove(smallest_combination.second);
+      for (auto name = lights.begin() ; name != lights.end() ; ++name)
+      {
+        WorldLight* light = world.GetLightByName(*name);
+
+        if (light)
+        {
+          light->enlightened.push_back(group);
+          if (light->enabled)
+            group.set_light(light->nodePath);
+        }
+      }
     }
-  } while (list.size() > 1);
+    baked_objects += objects.size();
+  }
+  return (baked_objects);
 }
@@ -0,0 +1,185 @@
+#include "world/world_sections.hpp"
+#include <cstring>
+
+using namespace std;
+
+/*
+ * Integers are stored in little-endian order whatever the host, floats as the little-endian
+ * integer holding their IEEE 754 bits.
+ */
+template<typename T>
+static void Append(string& data, T value)
+{
+  for (unsigned int i = 0 ; i < sizeof(T) ; ++i)
+    data += static_cast<char>((value >> (i * 8)) & 0xff);
+}
+
+template<>
+void Append<float>(string& data, float value)
+{
+  std::uint32_t bits;
+
+  memcpy(&bits, &value, sizeof(bits));
+  Append<std::uint32_t>(data, bits);
+}
+
+template<typename T>
+static T Extract(const char* data, size_t size, size_t& offset)
+{
+  T value = 0;
+
+  if (offset + sizeof(T) > size)
+    throw WorldSections::Exception("truncated data");
+  for (unsigned int i = 0 ; i < sizeof(T) ; ++i)
+    value |= static_cast<T>(static_cast<unsigned char>(data[offset + i])) << (i * 8);
+  offset += sizeof(T);
+  return (value);
+}
+
+template<>
+float Extract<float>(const char* data, size_t size, size_t& offset)
+{
+  std::uint32_t bits = Extract<std::uint32_t>(data, size, offset);
+  float         value;
+
+  memcpy(&value, &bits, sizeof(value));
+  return (value);
+}
+
+WorldSections::WorldSections(void)
+{
+  for (unsigned int i = 0 ; i < SectionCount ; ++i)
+    sections[i] = Bytes(0, 0);
+}
+
+/*
+ * Waypoints
+ */
+string WorldSections::WaypointTable::Encode(void) const
+{
+  string data;
+
+  data.reserve(2 * sizeof(std::uint32_t) + waypoints.size() * record_size + arcs.size() * sizeof(std::uint32_t));
+  Append<std::uint32_t>(data, waypoints.size());
+  Append<std::uint32_t>(data, arcs.size());
+  for (auto it = waypoints.begin() ; it != waypoints.end() ; ++it)
+  {
+    Append<std::uint32_t>(data, it->id);
+    Append<float>(data, it->x);
+    Append<float>(data, it->y);
+    Append<float>(data, it->z);
+    Append<unsigned char>(data, it->floor);
+    Append<unsigned char>(data, it->floor_above);
+    Append<unsigned char>(data, it->suggested_floor_above);
+    Append<unsigned char>(data, 0);
+    Append<std::uint32_t>(data, it->first_arc);
+    Append<std::uint32_t>(data, it->arc_count);
+  }
+  for (auto it = arcs.begin() ; it != arcs.end() ; ++it)
+    Append<std::uint32_t>(data, *it);
+  return (data);
+}
+
+/*
+ * Runs on any thread: it only touches the table.
+ */
+void WorldSections::WaypointTable::Decode(const char* data, size_t size)
+{
+  size_t        offset = 0;
+  std::uint32_t waypoint_count = Extract<std::uint32_t>(data, size, offset);
+  std::uint32_t arc_count      = Extract<std::uint32_t>(data, size, offset);
+
+  if ((size - offset) / record_size < waypoint_count ||
+      (size - offset - waypoint_count * record_size) / sizeof(std::uint32_t) != arc_count)
+    throw Exception("waypoint section doesn't match its counts");
+  waypoints.resize(waypoint_count);
+  for (auto it = waypoints.begin() ; it != waypoints.end() ; ++it)
+  {
+    it->id                    = Extract<std::uint32_t>(data, size, offset);
+    it->x                     = Extract<float>(data, size, offset);
+    it->y                     = Extract<float>(data, size, offset);
+    it->z                     = Extract<float>(data, size, offset);
+    it->floor                 = Extract<unsigned char>(data, size, offset);
+    it->floor_above           = Extract<unsigned char>(data, size, offset);
+    it->suggested_floor_above = Extract<unsigned char>(data, size, offset);
+    offset++; // padding
+    it->first_arc             = Extract<std::uint32_t>(data, size, offset);
+    it->arc_count             = Extract<std::uint32_t>(data, size, offset);
+    if (it->first_arc > arc_count || it->arc_count > arc_count - it->first_arc)
+      throw Exception("waypoint arcs out of range");
+  }
+  arcs.resize(arc_count);
+  for (auto it = arcs.begin() ; it != arcs.end() ; ++it)
+    *it = Extract<std::uint32_t>(data, size, offset);
+}
+
+/*
+ * Section table
+ */
+void WorldSections::Set(Section section, const string& bytes)
+{
+  pending[section] = bytes;
+}
+
+void WorldSections::Set(Section section, const Utils::Packet& packet)
+{
+  pending[section] = string(packet.raw(), packet.size());
+}
+
+string WorldSections::Write(void) const
+{
+  string        blob;
+  std::uint32_t offset = sizeof(std::uint32_t) + SectionCount * 3 * sizeof(std::uint32_t);
+
+  Append<std::uint32_t>(blob, SectionCount);
+  for (unsigned int i = 0 ; i < SectionCount ; ++i)
+  {
+    Append<std::uint32_t>(blob, i);
+    Append<std::uint32_t>(blob, offset);
+    Append<std::uint32_t>(blob, pending[i].size());
+    offset += pending[i].size();
+  }
+  blob.reserve(offset);
+  for (unsigned int i = 0 ; i < SectionCount ; ++i)
+    blob += pending[i];
+  return (blob);
+}
+
+/*
+ * Sections this revision doesn't know about are skipped.
+ */
+void WorldSections::Read(const string& blob)
+{
+  size_t        offset = 0;
+  std::uint32_t count;
+
+  data  = blob;
+  count = Extract<std::uint32_t>(data.c_str(), data.size(), offset);
+  for (unsigned int i = 0 ; i < SectionCount ; ++i)
+    sections[i] = Bytes(0, 0);
+  for (unsigned int i = 0 ; i < count ; ++i)
+  {
+    std::uint32_t id             = Extract<std::uint32_t>(data.c_str(), data.size(), offset);
+    std::uint32_t section_offset = Extract<std::uint32_t>(data.c_str(), data.size(), offset);
+    std::uint32_t section_size   = Extract<std::uint32_t>(data.c_str(), data.size(), offset);
+
+    if (section_offset > data.size() || section_size > data.size() - section_offset)
+      throw Exception("section out of bounds");
+    if (id < SectionCount)
+      sections[id] = Bytes(data.c_str() + section_offset, section_size);
+  }
+}
+
+WorldSections::Bytes WorldSections::Get(Section section) const
+{
+  if (!(Has(section)))
+    throw Exception("missing section");
+  return (sections[section]);
+}
+
+Utils::Packet WorldSections::GetPacket(Section section) const
+{
+  Bytes bytes = Get(section);
+
+  return (Utils::Packet(bytes.first, bytes.second));
+}
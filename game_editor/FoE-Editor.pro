@@ -82,6 +82,12 @@ SOURCES += main.cpp\
            waypoint.cpp \
            misc.cpp \
            map_object.cpp \
+           asset_cache.cpp \
+           world_sections.cpp \
+           job_system.cpp \
+           profiler.cpp \
+           thread.cpp \
+           semaphore.cpp \
            dynamic_object.cpp \
            zone.cpp \
            light.cpp \
@@ -126,6 +132,10 @@ HEADERS  += globals.hpp \
             world/world.h \
             world/colmask.hpp \
             world/map_object.hpp \
+            world/asset_cache.hpp \
+            world/world_sections.hpp \
+            job_system.hpp \
+            profiler.hpp \
             world/dynamic_object.hpp \
             world/interactions.hpp \
             world/light.hpp \
@@ -134,6 +144,7 @@ HEADERS  += globals.hpp \
             world/scene_camera.hpp \
             world/particle_effect.hpp \
             divide_and_conquer.hpp \
+            spatial_grid.hpp \
             worldobjectwidget.h \
             inventoryeditor.h \
             enlightenedobjectwidget.h \